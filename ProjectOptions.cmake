@@ -81,6 +81,7 @@ macro(urc_setup_options)
     option(urc_ENABLE_PCH "Enable precompiled headers" OFF)
     option(urc_ENABLE_CACHE "Enable ccache" OFF)
     option(urc_BUILD_EXAMPLE "Build example application" OFF)
+    option(urc_BUILD_BENCHMARK "Build benchmarks" OFF)
   else()
     option(urc_ENABLE_IPO "Enable IPO/LTO" ON)
     option(urc_WARNINGS_AS_ERRORS "Treat Warnings As Errors" ON)
@@ -96,6 +97,7 @@ macro(urc_setup_options)
     option(urc_ENABLE_PCH "Enable precompiled headers" OFF)
     option(urc_ENABLE_CACHE "Enable ccache" ON)
     option(urc_BUILD_EXAMPLE "Build example application" ON)
+    option(urc_BUILD_BENCHMARK "Build benchmarks" OFF)
   endif()
 
   if(NOT PROJECT_IS_TOP_LEVEL)
@@ -0,0 +1,79 @@
+// Allocating and freeing a per-request object graph with make_unique versus make_arena_unique
+
+#include "Stopwatch.hpp"
+
+#include "urc/arena.hpp"
+#include "urc/unique_ptr.hpp"
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <vector>
+
+
+namespace {
+struct Node
+{
+  int kind;
+  int line;
+  double value;
+  const Node *parent;
+};
+
+// Builds a chain of nodes per request, then drops the whole graph and calls end_request()
+template<typename Owner, typename Make, typename EndRequest>
+double parse_requests(std::size_t requests, std::size_t nodes, Make make, EndRequest end_request)
+{
+  std::vector<Owner> graph;
+  graph.reserve(nodes);
+
+  const urc_bench::Stopwatch watch;
+  for (std::size_t req = 0; req != requests; ++req) {
+    const Node *parent = nullptr;
+    for (std::size_t i = 0; i != nodes; ++i) {
+      graph.push_back(make(static_cast<int>(i), parent));
+      parent = graph.back().get();
+    }
+    urc_bench::do_not_optimize(parent);
+    graph.clear();
+    end_request();
+  }
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_requests = 10'000;
+  constexpr std::size_t nodes = 2'000;
+  constexpr int rounds = 5;
+  const std::size_t requests = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_requests;
+
+  std::printf("Parsing %zu requests of %zu nodes, best of %d\n", requests, nodes, rounds);
+
+  double heap = 1e300;
+  double arena = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    heap = std::min(heap,
+      parse_requests<raii::unique_ptr<Node>>(
+        requests,
+        nodes,
+        [](int kind, const Node *parent) { return raii::make_unique<Node>(kind, kind, 0.0, parent); },
+        [] {}));
+
+    raii::arena mem;
+    arena = std::min(arena,
+      parse_requests<raii::arena_unique_ptr<Node>>(
+        requests,
+        nodes,
+        [&mem](int kind, const Node *parent) { return raii::make_arena_unique<Node>(mem, kind, kind, 0.0, parent); },
+        [&mem] { mem.reset(); }));
+  }
+
+  urc_bench::print_result("raii::make_unique, delete per object", heap);
+  urc_bench::print_result("raii::make_arena_unique, arena reset per request", arena);
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+// Time spent by the owner dropping written files, fclose in the destructor versus raii::async_delete handing them
+// over to the closer thread
+
+#include "Stopwatch.hpp"
+
+#include "urc/async_delete.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+namespace {
+// Below the stdio buffer size, so the data is written by fclose
+constexpr std::size_t file_size = 4 * 1024;
+
+template<class Deleter> double drop_files(const std::vector<std::string> &paths)
+{
+  const std::vector<char> data(file_size, 'x');
+  urc_bench::Stopwatch dropping;
+  double dropped = 0;
+  for (const std::string &path : paths) {
+    raii::unique_rc<FILE *, Deleter> file{ std::fopen(path.c_str(), "wb") };
+    std::fwrite(data.data(), 1, data.size(), file.get());
+    dropping.restart();
+    file.reset();
+    dropped += dropping.elapsed_ms();
+  }
+  return dropped;
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_files = 2000;
+  constexpr int rounds = 3;
+  const std::size_t files = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_files;
+  const std::filesystem::path dir =
+    (argc > 2) ? std::filesystem::path{ argv[2] } : std::filesystem::temp_directory_path();
+
+  std::vector<std::string> paths;
+  paths.reserve(files);
+  for (std::size_t i = 0; i != files; ++i) {
+    paths.push_back((dir / ("urc_bench_async_delete_" + std::to_string(i))).string());
+  }
+
+  std::printf(
+    "%zu files of %zu bytes written to %s, time spent in reset(), best of %d\n", files, file_size, dir.c_str(), rounds);
+
+  double sync_drop = 1e300;
+  double async_drop = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    sync_drop = std::min(sync_drop, drop_files<raii::stdio_fclose>(paths));
+    async_drop = std::min(async_drop, drop_files<raii::async_delete<raii::stdio_fclose>>(paths));
+    raii::async_closer::global()->flush();
+  }
+  urc_bench::print_result("fclose in the owner, stdio_fclose", sync_drop);
+  urc_bench::print_result("raii::async_delete<stdio_fclose>", async_drop);
+  std::printf("closed on the closer thread %zu, inline because the queue was full %zu\n",
+    raii::async_closer::global()->closed_async(),
+    raii::async_closer::global()->closed_inline());
+
+  for (const std::string &path : paths) { std::filesystem::remove(path); }
+  return 0;
+}
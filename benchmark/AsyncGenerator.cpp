@@ -0,0 +1,123 @@
+// Cost of a value, raii::generator versus raii::async_generator consumed with co_await next(), and
+// the async generator streaming fixed size chunks versus building the whole buffer first
+
+#include "Stopwatch.hpp"
+
+#include "urc/async_generator.hpp"
+#include "urc/generator.hpp"
+#include "urc/task.hpp"
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <string>
+
+
+namespace {
+raii::generator<std::size_t> sync_iota(std::size_t count)
+{
+  for (std::size_t i = 0; i != count; ++i) { co_yield i; }
+}
+
+raii::async_generator<std::size_t> async_iota(std::size_t count)
+{
+  for (std::size_t i = 0; i != count; ++i) { co_yield i; }
+}
+
+double iterate_sync(std::size_t count)
+{
+  const urc_bench::Stopwatch watch;
+  std::size_t sum = 0;
+  for (const std::size_t val : sync_iota(count)) { sum += val; }
+  urc_bench::do_not_optimize(sum);
+  return watch.elapsed_ms();
+}
+
+raii::task<std::size_t> sum_async(std::size_t count)
+{
+  auto gen = async_iota(count);
+  std::size_t sum = 0;
+  while (const std::size_t *val = co_await gen.next()) { sum += *val; }
+  co_return sum;
+}
+
+double iterate_async(std::size_t count)
+{
+  const urc_bench::Stopwatch watch;
+  urc_bench::do_not_optimize(raii::sync_wait(sum_async(count)));
+  return watch.elapsed_ms();
+}
+
+// Stands in for a file, which is read chunk by chunk
+std::string make_chunk(std::size_t index, std::size_t size)
+{
+  constexpr std::size_t letters = 26;
+  return std::string(size, static_cast<char>('a' + index % letters));
+}
+
+raii::async_generator<std::string> chunks(std::size_t count, std::size_t size)
+{
+  for (std::size_t i = 0; i != count; ++i) { co_yield make_chunk(i, size); }
+}
+
+std::size_t checksum(const std::string &data) noexcept
+{
+  std::size_t res = 0;
+  for (const char chr : data) { res = res * 31 + static_cast<unsigned char>(chr); }
+  return res;
+}
+
+raii::task<std::size_t> stream(std::size_t count, std::size_t size)
+{
+  auto gen = chunks(count, size);
+  std::size_t res = 0;
+  while (const std::string *chunk = co_await gen.next()) { res ^= checksum(*chunk); }
+  co_return res;
+}
+
+std::size_t buffer_whole(std::size_t count, std::size_t size)
+{
+  std::string whole;
+  for (std::size_t i = 0; i != count; ++i) { whole += make_chunk(i, size); }
+  std::size_t res = 0;
+  for (std::size_t i = 0; i != count; ++i) { res ^= checksum(whole.substr(i * size, size)); }
+  return res;
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 10'000'000;
+  constexpr std::size_t chunk_count = 4'096;
+  constexpr std::size_t chunk_size = 64 * 1024;
+  constexpr int rounds = 3;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("%zu values, best of %d\n", count, rounds);
+  double sync_gen = 1e300;
+  double async_gen = 1e300;
+  double streamed = 1e300;
+  double buffered = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    sync_gen = std::min(sync_gen, iterate_sync(count));
+    async_gen = std::min(async_gen, iterate_async(count));
+
+    urc_bench::Stopwatch watch;
+    urc_bench::do_not_optimize(raii::sync_wait(stream(chunk_count, chunk_size)));
+    streamed = std::min(streamed, watch.elapsed_ms());
+
+    watch.restart();
+    urc_bench::do_not_optimize(buffer_whole(chunk_count, chunk_size));
+    buffered = std::min(buffered, watch.elapsed_ms());
+  }
+  urc_bench::print_result("raii::generator", sync_gen);
+  urc_bench::print_result("raii::async_generator, co_await next()", async_gen);
+
+  std::printf("%zu chunks of %zu KiB\n", chunk_count, chunk_size / 1024);
+  urc_bench::print_result("streamed through raii::async_generator", streamed);
+  urc_bench::print_result("whole buffer built first", buffered);
+
+  return 0;
+}
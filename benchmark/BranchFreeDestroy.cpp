@@ -0,0 +1,77 @@
+// Bulk destruction of owners, half of which are empty, with and without the ownership check
+
+#include "Stopwatch.hpp"
+
+#include "urc/unique_ptr.hpp"
+
+#include <algorithm>// std::ranges::shuffle
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <new>
+#include <random>
+#include <vector>
+
+
+namespace {
+// Same as raii::default_delete, but opts in to accepts_invalid_handle, therefore is invoked without ownership check
+template<typename T> struct tolerant_delete
+{
+  static constexpr bool accepts_invalid_handle = true;
+
+  void operator()(T *ptr) const noexcept
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete ptr;
+  }
+};
+
+template<typename Owner> std::vector<Owner> make_half_empty(std::size_t count, const std::vector<char> &pattern)
+{
+  std::vector<Owner> owners(count);
+  for (std::size_t i = 0; i != count; ++i) {
+    if (pattern[i]) { owners[i].reset(new int{ static_cast<int>(i) }); }
+  }
+  return owners;
+}
+
+template<typename Owner> double destroy_all(std::size_t count, const std::vector<char> &pattern)
+{
+  auto owners = make_half_empty<Owner>(count, pattern);
+
+  const urc_bench::Stopwatch watch;
+  for (auto &owner : owners) { owner.~Owner(); }
+  const double elapsed = watch.elapsed_ms();
+
+  // Destructors have already run, leave only empty owners behind for vector's destructor
+  for (auto &owner : owners) { new (&owner) Owner{}; }
+  return elapsed;
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 10'000'000;
+  constexpr int rounds = 5;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  // 50/50 empty and owned, in random order, so the ownership branch cannot be predicted
+  std::vector<char> pattern(count);
+  for (std::size_t i = 0; i != count; ++i) { pattern[i] = static_cast<char>((i % 2) == 0); }
+  std::ranges::shuffle(pattern, std::mt19937_64{ 42 });
+
+  std::printf("Destroying %zu raii::unique_ptr<int>, half of them empty, best of %d\n", count, rounds);
+
+  double checked = 1e300;
+  double branch_free = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    checked = std::min(checked, destroy_all<raii::unique_ptr<int>>(count, pattern));
+    branch_free = std::min(branch_free, destroy_all<raii::unique_ptr<int, tolerant_delete<int>>>(count, pattern));
+  }
+
+  urc_bench::print_result("raii::default_delete, is_owned check before delete", checked);
+  urc_bench::print_result("accepts_invalid_handle, unconditional delete", branch_free);
+
+  return 0;
+}
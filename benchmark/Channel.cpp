@@ -0,0 +1,141 @@
+// Passing values between pipeline stages, a bounded queue guarded by a mutex and two condition variables between
+// threads versus raii::channel between coroutines on a raii::thread_pool
+
+#include "Stopwatch.hpp"
+
+#include "urc/channel.hpp"
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+
+#include <algorithm>// std::min
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <deque>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+
+namespace {
+// The usual baseline between two threads
+class locked_queue
+{
+public:
+  explicit locked_queue(std::size_t capacity) : capacity_{ capacity } {}
+
+  void push(std::size_t value)
+  {
+    {
+      std::unique_lock lock{ mutex_ };
+      not_full_.wait(lock, [this] { return queue_.size() < capacity_; });
+      queue_.push_back(value);
+    }
+    not_empty_.notify_one();
+  }
+
+  std::optional<std::size_t> pop()
+  {
+    std::optional<std::size_t> res;
+    {
+      std::unique_lock lock{ mutex_ };
+      not_empty_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+      if (queue_.empty()) { return res; }
+      res = queue_.front();
+      queue_.pop_front();
+    }
+    not_full_.notify_one();
+    return res;
+  }
+
+  void close()
+  {
+    {
+      const std::lock_guard lock{ mutex_ };
+      closed_ = true;
+    }
+    not_empty_.notify_all();
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<std::size_t> queue_;
+  std::size_t capacity_;
+  bool closed_{ false };
+};
+
+double run_locked(std::size_t count, std::size_t capacity)
+{
+  locked_queue queue{ capacity };
+  std::size_t sum = 0;
+
+  const urc_bench::Stopwatch watch;
+  std::thread consumer{ [&queue, &sum] {
+    while (const std::optional<std::size_t> val = queue.pop()) { sum += *val; }
+  } };
+  for (std::size_t i = 0; i != count; ++i) { queue.push(i); }
+  queue.close();
+  consumer.join();
+  const double elapsed = watch.elapsed_ms();
+
+  urc_bench::do_not_optimize(sum);
+  return elapsed;
+}
+
+raii::task<> produce(raii::thread_pool &pool, raii::channel<std::size_t> &chan, std::size_t count)
+{
+  co_await pool.schedule();
+  for (std::size_t i = 0; i != count; ++i) { co_await chan.send(i); }
+  chan.close();
+}
+
+raii::task<> consume(raii::thread_pool &pool, raii::channel<std::size_t> &chan, std::size_t &sum, std::latch &done)
+{
+  co_await pool.schedule();
+  while (const std::optional<std::size_t> val = co_await chan.receive()) { sum += *val; }
+  done.count_down();
+}
+
+double run_channel(std::size_t count, std::size_t capacity)
+{
+  raii::thread_pool pool{ 2 };
+  raii::channel<std::size_t> chan{ capacity };
+  std::size_t sum = 0;
+  std::latch done{ 1 };
+
+  const urc_bench::Stopwatch watch;
+  pool.spawn(consume(pool, chan, sum, done));
+  pool.spawn(produce(pool, chan, count));
+  done.wait();
+  const double elapsed = watch.elapsed_ms();
+
+  urc_bench::do_not_optimize(sum);
+  return elapsed;
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 2'000'000;
+  constexpr std::size_t capacity = 256;
+  constexpr int rounds = 3;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("Passing %zu values through a queue of %zu, best of %d\n", count, capacity, rounds);
+
+  double locked = 1e300;
+  double channel = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    locked = std::min(locked, run_locked(count, capacity));
+    channel = std::min(channel, run_channel(count, capacity));
+  }
+  urc_bench::print_result("mutex and condition variables, two threads", locked);
+  urc_bench::print_result("raii::channel, two pool workers", channel);
+
+  return 0;
+}
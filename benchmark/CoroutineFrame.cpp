@@ -0,0 +1,86 @@
+// Spawning and destroying short coroutines, frames from the global heap versus per-thread frame pools
+
+#include "Stopwatch.hpp"
+
+#include "urc/frame_allocator.hpp"
+#include "urc/unique_coroutine_handle.hpp"
+
+#include <algorithm>// std::min
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <exception>// std::terminate
+
+
+namespace {
+struct heap_frame
+{
+};
+
+// Lazily started coroutine, which is resumed once and then destroyed by its owner
+template<typename FrameAllocation> struct Event
+{
+  struct promise_type : FrameAllocation
+  {
+    Event get_return_object() noexcept { return Event{ handle::from_promise(*this) }; }
+    static std::suspend_always initial_suspend() noexcept { return {}; }
+    static std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(std::size_t res) noexcept { result = res; }
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+
+    std::size_t result{};
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  explicit Event(handle hnd) noexcept : coro{ hnd } {}
+
+  raii::unique_coroutine_handle<promise_type> coro;
+};
+
+template<typename FrameAllocation> Event<FrameAllocation> handle_event(std::size_t id)
+{
+  std::size_t local[8]{ id };// NOLINT(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  urc_bench::do_not_optimize(local);
+  co_return local[0] + 1;
+}
+
+template<typename FrameAllocation> double spawn(std::size_t count)
+{
+  const urc_bench::Stopwatch watch;
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i != count; ++i) {
+    auto event = handle_event<FrameAllocation>(i);
+    event.coro.get().resume();
+    sum += event.coro.get().promise().result;
+  }
+  urc_bench::do_not_optimize(sum);
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 10'000'000;
+  constexpr int rounds = 5;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("Spawning %zu coroutines, best of %d\n", count, rounds);
+
+  double heap = 1e300;
+  double pooled = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    heap = std::min(heap, spawn<heap_frame>(count));
+    pooled = std::min(pooled, spawn<raii::pooled_frame_promise>(count));
+  }
+
+  urc_bench::print_result("global operator new", heap);
+  urc_bench::print_result("raii::pooled_frame_promise", pooled);
+
+  const auto stats = raii::frame_pool_statistics();
+  std::printf("frame pool hit rate %.4f, misses %zu\n", stats.hit_rate(), stats.misses);
+
+  return 0;
+}
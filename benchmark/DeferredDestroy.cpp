@@ -0,0 +1,133 @@
+// Tick latency of a producer, which drops thousands of completed coroutines per tick, inline coroutine_destroy versus
+// deferred_coroutine_destroy drained after the tick or handed off to a background thread
+
+#include "Stopwatch.hpp"
+
+#include "urc/coroutine_destroy.hpp"
+#include "urc/deferred_destroy.hpp"
+#include "urc/unique_coroutine_handle.hpp"
+
+#include <algorithm>// std::sort
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <exception>// std::terminate
+#include <string>
+#include <utility>// std::move
+#include <vector>
+
+
+namespace {
+template<typename Deleter> struct Request
+{
+  struct promise_type
+  {
+    Request get_return_object() noexcept { return Request{ handle::from_promise(*this) }; }
+    static std::suspend_never initial_suspend() noexcept { return {}; }
+    static std::suspend_always final_suspend() noexcept { return {}; }
+    static void return_void() noexcept {}
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  explicit Request(handle hnd) noexcept : coro{ hnd } {}
+
+  raii::unique_coroutine_handle<promise_type, Deleter> coro;
+};
+
+// The parameters live in the frame until it is destroyed, tearing them down is the expensive part
+template<typename Deleter> Request<Deleter> handle_request(std::vector<std::string> headers)
+{
+  urc_bench::do_not_optimize(headers.size());
+  co_return;
+}
+
+std::vector<std::string> make_headers(std::size_t id)
+{
+  constexpr std::size_t header_count = 16;
+  std::vector<std::string> res;
+  res.reserve(header_count);
+  for (std::size_t i = 0; i != header_count; ++i) {
+    res.push_back("x-request-header-" + std::to_string(i) + ": value of request " + std::to_string(id));
+  }
+  return res;
+}
+
+struct latencies
+{
+  double p50;
+  double p99;
+  double max;
+};
+
+latencies summarize(std::vector<double> ticks)
+{
+  std::sort(ticks.begin(), ticks.end());
+  const auto at = [&ticks](double quantile) {
+    return ticks[static_cast<std::size_t>(quantile * static_cast<double>(ticks.size() - 1))];
+  };
+  return { at(0.5), at(0.99), ticks.back() };
+}
+
+// Every tick starts a batch of requests and drops the completed batch of the previous tick
+template<typename Deleter, typename AfterTick>
+latencies run_ticks(std::size_t tick_count, std::size_t per_tick, AfterTick after_tick)
+{
+  std::vector<Request<Deleter>> in_flight;
+  std::vector<Request<Deleter>> next;
+  in_flight.reserve(per_tick);
+  next.reserve(per_tick);
+
+  std::vector<std::vector<std::string>> inputs(per_tick);
+  std::vector<double> ticks;
+  ticks.reserve(tick_count);
+
+  for (std::size_t tick = 0; tick != tick_count; ++tick) {
+    for (std::size_t i = 0; i != per_tick; ++i) { inputs[i] = make_headers(i); }
+
+    const urc_bench::Stopwatch watch;
+    for (std::size_t i = 0; i != per_tick; ++i) { next.push_back(handle_request<Deleter>(std::move(inputs[i]))); }
+    in_flight.clear();
+    in_flight.swap(next);
+    ticks.push_back(std::chrono::duration<double, std::micro>(watch.elapsed()).count());
+
+    after_tick();
+  }
+  return summarize(std::move(ticks));
+}
+
+void print_latencies(const char *name, const latencies &res)
+{
+  std::printf("%-44s p50 %9.1f us  p99 %9.1f us  max %9.1f us\n", name, res.p50, res.p99, res.max);
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_per_tick = 5'000;
+  constexpr std::size_t tick_count = 500;
+  const std::size_t per_tick = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_per_tick;
+
+  std::printf("%zu ticks, %zu coroutines completed and dropped per tick\n", tick_count, per_tick);
+
+  const latencies inline_destroy = run_ticks<raii::coroutine_destroy>(tick_count, per_tick, [] {});
+  const latencies drained =
+    run_ticks<raii::deferred_coroutine_destroy>(tick_count, per_tick, [] { raii::drain_deferred_destroys(); });
+
+  latencies handed_off{};
+  {
+    raii::deferred_destroy_thread closer;
+    handed_off =
+      run_ticks<raii::deferred_coroutine_destroy>(tick_count, per_tick, [&closer] { closer.hand_off(); });
+  }
+
+  print_latencies("raii::coroutine_destroy inline", inline_destroy);
+  print_latencies("deferred, drained after the tick", drained);
+  print_latencies("deferred, handed off to a background thread", handed_off);
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+// Copying a file, fread/fwrite through unique_rc<FILE *, stdio_fclose> versus raii::file_transfer with each
+// method, on every directory given, by default on tmpfs (/dev/shm) and in the temporary directory
+
+#include "Stopwatch.hpp"
+
+#include "urc/deleter_posix.hpp"
+#include "urc/file_transfer.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <fcntl.h>
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+namespace {
+constexpr std::size_t block_size = std::size_t{ 1 } << 20;
+
+void make_file(const std::string &path, std::size_t megabytes)
+{
+  const raii::unique_rc<FILE *, raii::stdio_fclose> out{ std::fopen(path.c_str(), "wb") };
+  std::vector<char> block(block_size);
+  for (std::size_t i = 0; i != megabytes; ++i) {
+    for (std::size_t j = 0; j != block.size(); ++j) { block[j] = static_cast<char>(i + j); }
+    std::fwrite(block.data(), 1, block.size(), out.get());
+  }
+}
+
+double copy_stdio(const std::string &from, const std::string &to)
+{
+  const urc_bench::Stopwatch watch;
+  const raii::unique_rc<FILE *, raii::stdio_fclose> in{ std::fopen(from.c_str(), "rb") };
+  const raii::unique_rc<FILE *, raii::stdio_fclose> out{ std::fopen(to.c_str(), "wb") };
+  std::vector<char> buf(block_size);
+  for (std::size_t len = 0; (len = std::fread(buf.data(), 1, buf.size(), in.get())) != 0;) {
+    std::fwrite(buf.data(), 1, len, out.get());
+  }
+  return watch.elapsed_ms();
+}
+
+double copy_transfer(raii::file_transfer &copier,
+  const std::string &from,
+  const std::string &to,
+  raii::transfer_method method)
+{
+  const urc_bench::Stopwatch watch;
+  const raii::unique_fd in{ ::open(from.c_str(), O_RDONLY | O_CLOEXEC) };
+  const raii::unique_fd out{ ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600) };
+  urc_bench::do_not_optimize(copier.transfer(in, out, raii::file_transfer::to_end, method).bytes);
+  return watch.elapsed_ms();
+}
+
+void print_throughput(const char *name, std::size_t megabytes, double milliseconds)
+{
+  const double throughput = 1000.0 * static_cast<double>(megabytes) / milliseconds;
+  std::printf("%-56s %12.3f ms %10.1f MiB/s\n", name, milliseconds, throughput);
+}
+
+void run(const std::filesystem::path &dir, std::size_t megabytes, int rounds)
+{
+  const std::string from = (dir / "urc_bench_file_transfer_from").string();
+  const std::string to = (dir / "urc_bench_file_transfer_to").string();
+  make_file(from, megabytes);
+
+  std::printf("\n%s, %zu MiB, page-cached source, best of %d\n", dir.c_str(), megabytes, rounds);
+  raii::file_transfer copier{ block_size };
+  double stdio = 1e300;
+  double copy_range = 1e300;
+  double send = 1e300;
+  double splice = 1e300;
+  double buffer = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    stdio = std::min(stdio, copy_stdio(from, to));
+    copy_range = std::min(copy_range, copy_transfer(copier, from, to, raii::transfer_method::copy_file_range));
+    send = std::min(send, copy_transfer(copier, from, to, raii::transfer_method::sendfile));
+    splice = std::min(splice, copy_transfer(copier, from, to, raii::transfer_method::splice));
+    buffer = std::min(buffer, copy_transfer(copier, from, to, raii::transfer_method::buffer));
+  }
+  print_throughput("fread/fwrite, unique_rc<FILE *, stdio_fclose>", megabytes, stdio);
+  print_throughput("raii::file_transfer, copy_file_range", megabytes, copy_range);
+  print_throughput("raii::file_transfer, sendfile", megabytes, send);
+  print_throughput("raii::file_transfer, splice", megabytes, splice);
+  print_throughput("raii::file_transfer, read/write", megabytes, buffer);
+
+  std::filesystem::remove(from);
+  std::filesystem::remove(to);
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_megabytes = 512;
+  constexpr int rounds = 3;
+  const std::size_t megabytes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_megabytes;
+
+  std::vector<std::filesystem::path> dirs;
+  for (int i = 2; i < argc; ++i) { dirs.emplace_back(argv[i]); }
+  if (dirs.empty()) {
+    if (std::filesystem::is_directory("/dev/shm")) { dirs.emplace_back("/dev/shm"); }
+    dirs.push_back(std::filesystem::temp_directory_path());
+  }
+  for (const auto &dir : dirs) { run(dir, megabytes, rounds); }
+  return 0;
+}
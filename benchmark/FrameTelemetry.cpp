@@ -0,0 +1,98 @@
+// Cost of frame telemetry, spawning and destroying short coroutines with and without
+// raii::instrumented_frame_promise and raii::instrumented_destroy, followed by the collected report
+
+#include "Stopwatch.hpp"
+
+#include "urc/frame_allocator.hpp"
+#include "urc/frame_telemetry.hpp"
+#include "urc/unique_coroutine_handle.hpp"
+
+#include <algorithm>// std::min
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <exception>// std::terminate
+#include <string_view>
+
+
+namespace {
+// Lazily started coroutine, which is resumed once and then destroyed by its owner
+template<bool Instrumented> struct Event
+{
+  struct promise_type
+    : std::conditional_t<Instrumented, raii::instrumented_frame_promise<promise_type>, raii::pooled_frame_promise>
+  {
+    Event get_return_object() noexcept { return Event{ handle::from_promise(*this) }; }
+    static std::suspend_always initial_suspend() noexcept { return {}; }
+    static std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(std::size_t res) noexcept { result = res; }
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+
+    std::size_t result{};
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  explicit Event(handle hnd) noexcept : coro{ hnd } {}
+
+  raii::instrumented_coroutine_handle<promise_type> coro;
+};
+
+template<bool Instrumented> Event<Instrumented> handle_event(std::size_t id)
+{
+  std::size_t local[8]{ id };// NOLINT(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  urc_bench::do_not_optimize(local);
+  co_return local[0] + 1;
+}
+
+template<bool Instrumented> double spawn(std::size_t count)
+{
+  const urc_bench::Stopwatch watch;
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i != count; ++i) {
+    auto event = handle_event<Instrumented>(i);
+    event.coro.get().resume();
+    sum += event.coro.get().promise().result;
+  }
+  urc_bench::do_not_optimize(sum);
+  return watch.elapsed_ms();
+}
+
+void print_report(std::string_view name, const raii::frame_statistics &stats)
+{
+  std::printf("%.*s\n", static_cast<int>(name.size()), name.data());
+  std::printf("  frames %zu, mean %zu bytes, max %zu bytes, live %zu, peak %zu\n",
+    stats.allocations,
+    stats.mean_size(),
+    stats.max_size,
+    stats.live,
+    stats.peak);
+  for (std::size_t i = 0; i != raii::frame_statistics::lifetime_buckets; ++i) {
+    if (stats.lifetime_histogram[i] != 0) {
+      std::printf("  lifetime < 2^%zu ns: %zu\n", i, stats.lifetime_histogram[i]);
+    }
+  }
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 10'000'000;
+  constexpr int rounds = 5;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("Spawning %zu coroutines, best of %d\n", count, rounds);
+  double plain = 1e300;
+  double instrumented = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    plain = std::min(plain, spawn<false>(count));
+    instrumented = std::min(instrumented, spawn<true>(count));
+  }
+  urc_bench::print_result("raii::pooled_frame_promise", plain);
+  urc_bench::print_result("raii::instrumented_frame_promise", instrumented);
+
+  raii::for_each_frame_statistics(print_report);
+  return 0;
+}
@@ -0,0 +1,195 @@
+// Iterating sequences and trees, hand-written iterators versus raii::generator (and std::generator, if available)
+
+#include "Stopwatch.hpp"
+
+#include "urc/generator.hpp"
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#if __has_include(<generator>)
+#include <generator>
+#endif
+
+
+namespace {
+// Flat sequence
+
+class iota_range
+{
+public:
+  class iterator
+  {
+  public:
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(std::size_t val) noexcept : val_{ val } {}
+
+    std::size_t operator*() const noexcept { return val_; }
+
+    iterator &operator++() noexcept
+    {
+      ++val_;
+      return *this;
+    }
+
+    iterator operator++(int) noexcept { return iterator{ val_++ }; }
+
+    friend bool operator==(iterator, iterator) = default;
+
+  private:
+    std::size_t val_{};
+  };
+
+  explicit iota_range(std::size_t last) noexcept : last_{ last } {}
+
+  [[nodiscard]] static iterator begin() noexcept { return iterator{ 0 }; }
+  [[nodiscard]] iterator end() const noexcept { return iterator{ last_ }; }
+
+private:
+  std::size_t last_;
+};
+
+raii::generator<std::size_t> iota_raii(std::size_t last)
+{
+  for (std::size_t i = 0; i != last; ++i) { co_yield i; }
+}
+
+#ifdef __cpp_lib_generator
+std::generator<std::size_t> iota_std(std::size_t last)
+{
+  for (std::size_t i = 0; i != last; ++i) { co_yield i; }
+}
+#endif
+
+template<typename Range> double sum(Range &&range)
+{
+  const urc_bench::Stopwatch watch;
+  std::size_t total = 0;
+  for (const std::size_t val : range) {
+    total += val;
+    urc_bench::do_not_optimize(total);
+  }
+  return watch.elapsed_ms();
+}
+
+// Pre-order traversal of a complete binary tree
+
+struct Node
+{
+  std::size_t value;
+  std::unique_ptr<Node> left;
+  std::unique_ptr<Node> right;
+};
+
+std::unique_ptr<Node> build(std::size_t depth, std::size_t &next)
+{
+  if (depth == 0) { return nullptr; }
+  auto node = std::make_unique<Node>(Node{ next++, nullptr, nullptr });
+  node->left = build(depth - 1, next);
+  node->right = build(depth - 1, next);
+  return node;
+}
+
+// Explicit stack, what one writes without coroutines
+double traverse_stack(const Node *root)
+{
+  const urc_bench::Stopwatch watch;
+  std::size_t total = 0;
+  std::vector<const Node *> stack{ root };
+  while (!stack.empty()) {
+    const Node *node = stack.back();
+    stack.pop_back();
+    total += node->value;
+    urc_bench::do_not_optimize(total);
+    if (node->right) { stack.push_back(node->right.get()); }
+    if (node->left) { stack.push_back(node->left.get()); }
+  }
+  return watch.elapsed_ms();
+}
+
+// Every element is passed up through all enclosing generators, O(depth) per element
+raii::generator<std::size_t> traverse_reyield(const Node *node)
+{
+  co_yield node->value;
+  if (node->left) {
+    for (const std::size_t val : traverse_reyield(node->left.get())) { co_yield val; }
+  }
+  if (node->right) {
+    for (const std::size_t val : traverse_reyield(node->right.get())) { co_yield val; }
+  }
+}
+
+// The innermost generator is resumed directly, O(1) per element
+raii::generator<std::size_t> traverse_nested(const Node *node)
+{
+  co_yield node->value;
+  if (node->left) { co_yield raii::elements_of(traverse_nested(node->left.get())); }
+  if (node->right) { co_yield raii::elements_of(traverse_nested(node->right.get())); }
+}
+
+#ifdef __cpp_lib_generator
+std::generator<std::size_t> traverse_std(const Node *node)
+{
+  co_yield node->value;
+  if (node->left) { co_yield std::ranges::elements_of(traverse_std(node->left.get())); }
+  if (node->right) { co_yield std::ranges::elements_of(traverse_std(node->right.get())); }
+}
+#endif
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 100'000'000;
+  constexpr std::size_t tree_depth = 20;
+  constexpr int rounds = 5;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::size_t next = 0;
+  const auto tree = build(tree_depth, next);
+
+  std::printf("Iterating %zu integers and a tree of %zu nodes, best of %d\n", count, next, rounds);
+
+  double iterator = 1e300;
+  double generator = 1e300;
+  double stack = 1e300;
+  double reyield = 1e300;
+  double nested = 1e300;
+#ifdef __cpp_lib_generator
+  double std_generator = 1e300;
+  double std_nested = 1e300;
+#endif
+  for (int round = 0; round != rounds; ++round) {
+    iterator = std::min(iterator, sum(iota_range{ count }));
+    generator = std::min(generator, sum(iota_raii(count)));
+    stack = std::min(stack, traverse_stack(tree.get()));
+    reyield = std::min(reyield, sum(traverse_reyield(tree.get())));
+    nested = std::min(nested, sum(traverse_nested(tree.get())));
+#ifdef __cpp_lib_generator
+    std_generator = std::min(std_generator, sum(iota_std(count)));
+    std_nested = std::min(std_nested, sum(traverse_std(tree.get())));
+#endif
+  }
+
+  urc_bench::print_result("sequence, hand-written iterator", iterator);
+  urc_bench::print_result("sequence, raii::generator", generator);
+#ifdef __cpp_lib_generator
+  urc_bench::print_result("sequence, std::generator", std_generator);
+#endif
+  urc_bench::print_result("tree, explicit stack", stack);
+  urc_bench::print_result("tree, raii::generator re-yielding nested values", reyield);
+  urc_bench::print_result("tree, raii::generator with elements_of", nested);
+#ifdef __cpp_lib_generator
+  urc_bench::print_result("tree, std::generator with elements_of", std_nested);
+#endif
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+// Small reads from a file, blocking fread and pread versus raii::io_context on io_uring, with registered files and
+// buffers, and on the thread pool fallback
+
+#include "Stopwatch.hpp"
+
+#include "urc/deleter_posix.hpp"
+#include "urc/io_context.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/task.hpp"
+#include "urc/unique_rc.hpp"
+#include "urc/when_all.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>// std::min
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace {
+constexpr std::size_t record_size = 256;
+constexpr std::size_t queue_depth = 64;
+
+using record = std::array<std::byte, record_size>;
+
+std::size_t checksum(std::span<const std::byte> rec) noexcept
+{
+  std::size_t res = 0;
+  for (const std::byte val : rec) { res = res * 31 + static_cast<std::size_t>(val); }
+  return res;
+}
+
+void make_file(const std::string &path, std::size_t records)
+{
+  const raii::unique_rc<FILE *, raii::stdio_fclose> out{ std::fopen(path.c_str(), "wb") };
+  std::vector<std::byte> rec(record_size);
+  for (std::size_t i = 0; i != records; ++i) {
+    for (std::size_t j = 0; j != record_size; ++j) { rec[j] = static_cast<std::byte>(i + j); }
+    std::fwrite(rec.data(), 1, rec.size(), out.get());
+  }
+}
+
+double read_fread(const std::string &path, std::size_t records)
+{
+  const urc_bench::Stopwatch watch;
+  const raii::unique_rc<FILE *, raii::stdio_fclose> in{ std::fopen(path.c_str(), "rb") };
+  record rec{};
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i != records; ++i) {
+    if (std::fread(rec.data(), 1, rec.size(), in.get()) != rec.size()) { break; }
+    sum ^= checksum(rec);
+  }
+  urc_bench::do_not_optimize(sum);
+  return watch.elapsed_ms();
+}
+
+double read_pread(const std::string &path, std::size_t records)
+{
+  const urc_bench::Stopwatch watch;
+  const raii::unique_fd in{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+  record rec{};
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i != records; ++i) {
+    if (::pread(in.get(), rec.data(), rec.size(), static_cast<off_t>(i * record_size)) <= 0) { break; }
+    sum ^= checksum(rec);
+  }
+  urc_bench::do_not_optimize(sum);
+  return watch.elapsed_ms();
+}
+
+// One of queue_depth readers, each reads every queue_depth-th record, so queue_depth reads are in flight
+raii::task<std::size_t>
+  reader(raii::io_context &ctx, raii::file_ref file, std::span<std::byte> buf, std::size_t first, std::size_t records)
+{
+  std::size_t sum = 0;
+  for (std::size_t i = first; i < records; i += queue_depth) {
+    const std::uint64_t offset = i * record_size;
+    const std::size_t len = file.fixed() ? co_await ctx.read(file, buf, offset, raii::fixed_buffer{ 0 })
+                                         : co_await ctx.read(file, buf, offset);
+    sum ^= checksum(buf.first(len));
+  }
+  co_return sum;
+}
+
+raii::task<std::size_t>
+  read_all(raii::io_context &ctx, raii::file_ref file, std::span<std::byte> buffers, std::size_t records)
+{
+  std::vector<raii::task<std::size_t>> readers;
+  readers.reserve(queue_depth);
+  for (std::size_t i = 0; i != queue_depth; ++i) {
+    readers.push_back(reader(ctx, file, buffers.subspan(i * record_size, record_size), i, records));
+  }
+  std::size_t sum = 0;
+  for (auto &done : co_await raii::when_all(std::move(readers))) { sum ^= co_await done; }
+  co_return sum;
+}
+
+double read_io_context(const std::string &path, std::size_t records, raii::io_backend backend, bool registered)
+{
+  const urc_bench::Stopwatch watch;
+  raii::io_context ctx{ queue_depth, backend };
+  const raii::unique_fd in{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+  std::vector<std::byte> buffers(queue_depth * record_size);
+  raii::file_ref file{ in };
+  if (registered) {
+    const std::array<std::span<std::byte>, 1> bufs{ buffers };
+    const std::array fds{ in.get() };
+    ctx.register_buffers(bufs);
+    ctx.register_files(fds);
+    file = raii::fixed_file{ 0 };
+  }
+  urc_bench::do_not_optimize(ctx.run(read_all(ctx, file, buffers, records)));
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_records = 1'000'000;
+  constexpr int rounds = 3;
+  const std::size_t records = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_records;
+  const std::string path = (std::filesystem::temp_directory_path() / "urc_bench_io_context").string();
+  make_file(path, records);
+
+  const raii::io_context probe;
+  std::printf("%zu reads of %zu bytes, %zu in flight, io_uring %s, best of %d\n",
+    records,
+    record_size,
+    queue_depth,
+    (probe.backend() == raii::io_backend::io_uring) ? "available" : "not available",
+    rounds);
+
+  double buffered = 1e300;
+  double blocking = 1e300;
+  double uring = 1e300;
+  double uring_registered = 1e300;
+  double pool = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    buffered = std::min(buffered, read_fread(path, records));
+    blocking = std::min(blocking, read_pread(path, records));
+    uring = std::min(uring, read_io_context(path, records, raii::io_backend::io_uring, false));
+    uring_registered = std::min(uring_registered, read_io_context(path, records, raii::io_backend::io_uring, true));
+    pool = std::min(pool, read_io_context(path, records, raii::io_backend::thread_pool, false));
+  }
+  urc_bench::print_result("fread, unique_rc<FILE *, stdio_fclose>", buffered);
+  urc_bench::print_result("pread, raii::unique_fd", blocking);
+  urc_bench::print_result("raii::io_context, io_uring", uring);
+  urc_bench::print_result("raii::io_context, io_uring, registered file and buffer", uring_registered);
+  urc_bench::print_result("raii::io_context, thread pool fallback", pool);
+
+  std::filesystem::remove(path);
+  return 0;
+}
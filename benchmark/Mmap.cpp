@@ -0,0 +1,91 @@
+// Reading a whole file, fread into a heap buffer through unique_rc<FILE *, stdio_fclose> versus a raii::unique_mmap
+// view, with and without MAP_POPULATE and MADV_SEQUENTIAL
+
+#include "Stopwatch.hpp"
+
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_mmap.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace {
+std::uint64_t checksum(std::span<const std::uint64_t> words) noexcept
+{
+  std::uint64_t res = 0;
+  for (const std::uint64_t word : words) { res = res * 31 + word; }
+  return res;
+}
+
+void make_file(const std::string &path, std::size_t megabytes)
+{
+  const raii::unique_rc<FILE *, raii::stdio_fclose> out{ std::fopen(path.c_str(), "wb") };
+  std::vector<std::uint64_t> block((std::size_t{ 1 } << 20) / sizeof(std::uint64_t));
+  for (std::size_t i = 0; i != megabytes; ++i) {
+    for (std::size_t j = 0; j != block.size(); ++j) { block[j] = i * block.size() + j; }
+    std::fwrite(block.data(), sizeof(std::uint64_t), block.size(), out.get());
+  }
+}
+
+double read_fread(const std::string &path)
+{
+  const urc_bench::Stopwatch watch;
+  const raii::unique_rc<FILE *, raii::stdio_fclose> in{ std::fopen(path.c_str(), "rb") };
+  std::fseek(in.get(), 0, SEEK_END);
+  std::vector<std::uint64_t> data(static_cast<std::size_t>(std::ftell(in.get())) / sizeof(std::uint64_t));
+  std::fseek(in.get(), 0, SEEK_SET);
+  static_cast<void>(std::fread(data.data(), sizeof(std::uint64_t), data.size(), in.get()));
+  urc_bench::do_not_optimize(checksum(data));
+  return watch.elapsed_ms();
+}
+
+double read_mmap(const std::string &path, bool populate, bool sequential)
+{
+  const urc_bench::Stopwatch watch;
+  raii::mmap_options options;
+  options.populate = populate;
+  const raii::unique_mmap view = raii::map_file(path.c_str(), raii::mmap_access::read_only, options);
+  if (sequential) { static_cast<void>(view.advise(raii::mmap_advice::sequential)); }
+  urc_bench::do_not_optimize(checksum(view.as_span<const std::uint64_t>()));
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_megabytes = 256;
+  constexpr int rounds = 3;
+  const std::size_t megabytes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_megabytes;
+  const std::string path = (std::filesystem::temp_directory_path() / "urc_bench_mmap").string();
+  make_file(path, megabytes);
+
+  std::printf("read and checksum a page-cached file of %zu MiB, best of %d\n", megabytes, rounds);
+
+  double buffered = 1e300;
+  double mapped = 1e300;
+  double populated = 1e300;
+  double advised = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    buffered = std::min(buffered, read_fread(path));
+    mapped = std::min(mapped, read_mmap(path, false, false));
+    populated = std::min(populated, read_mmap(path, true, false));
+    advised = std::min(advised, read_mmap(path, false, true));
+  }
+  urc_bench::print_result("fread into std::vector, unique_rc<FILE *, stdio_fclose>", buffered);
+  urc_bench::print_result("raii::unique_mmap", mapped);
+  urc_bench::print_result("raii::unique_mmap, MAP_POPULATE", populated);
+  urc_bench::print_result("raii::unique_mmap, MADV_SEQUENTIAL", advised);
+
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,108 @@
+// Fire-and-forget coroutines, raii::nursery with its intrusive list of children versus the usual registry of
+// running tasks in a std::list, which needs a heap node per child and a sweep for the completed ones
+
+#include "Stopwatch.hpp"
+
+#include "urc/nursery.hpp"
+#include "urc/task.hpp"
+#include "urc/unique_coroutine_handle.hpp"
+
+#include <algorithm>// std::min
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <list>
+#include <vector>
+
+
+namespace {
+// Single threaded event, resumes the waiting coroutines, when it is opened
+class Gate
+{
+public:
+  [[nodiscard]] auto wait() noexcept
+  {
+    struct awaiter
+    {
+      Gate *gate;
+
+      static constexpr bool await_ready() noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> hnd) const { gate->waiters_.push_back(hnd); }
+      static constexpr void await_resume() noexcept {}
+    };
+    return awaiter{ this };
+  }
+
+  void open()
+  {
+    for (const auto hnd : waiters_) { hnd.resume(); }
+    waiters_.clear();
+  }
+
+private:
+  std::vector<std::coroutine_handle<>> waiters_;
+};
+
+raii::task<> handle_request(Gate &gate, std::size_t &sum, std::size_t id)
+{
+  co_await gate.wait();
+  sum += id;
+}
+
+// Children wait for the gate in batches, as requests waiting for their I/O would
+double spawn_nursery(std::size_t count, std::size_t batch)
+{
+  const urc_bench::Stopwatch watch;
+  Gate gate;
+  std::size_t sum = 0;
+  raii::nursery scope;
+  for (std::size_t i = 0; i != count; ++i) {
+    scope.spawn(handle_request(gate, sum, i));
+    if ((i + 1) % batch == 0) { gate.open(); }
+  }
+  gate.open();
+  urc_bench::do_not_optimize(sum);
+  return watch.elapsed_ms();
+}
+
+double spawn_list(std::size_t count, std::size_t batch)
+{
+  const urc_bench::Stopwatch watch;
+  Gate gate;
+  std::size_t sum = 0;
+  std::list<raii::unique_coroutine_handle<raii::task<>::promise_type>> children;
+  for (std::size_t i = 0; i != count; ++i) {
+    children.push_back(handle_request(gate, sum, i).release());
+    children.back().get().resume();
+    if ((i + 1) % batch == 0) {
+      gate.open();
+      children.remove_if([](const auto &child) { return child.get().done(); });
+    }
+  }
+  gate.open();
+  children.clear();
+  urc_bench::do_not_optimize(sum);
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 1'000'000;
+  constexpr std::size_t batch = 64;
+  constexpr int rounds = 5;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("Spawning %zu coroutines, %zu waiting at a time, best of %d\n", count, batch, rounds);
+  double nursery = 1e300;
+  double list = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    nursery = std::min(nursery, spawn_nursery(count, batch));
+    list = std::min(list, spawn_list(count, batch));
+  }
+  urc_bench::print_result("raii::nursery", nursery);
+  urc_bench::print_result("std::list<raii::task<>> registry", list);
+  return 0;
+}
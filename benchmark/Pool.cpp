@@ -0,0 +1,66 @@
+// Allocate/free churn of message objects on a single thread, global heap versus thread-local pool
+
+#include "Stopwatch.hpp"
+
+#include "urc/pool_delete.hpp"
+#include "urc/unique_ptr.hpp"
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <vector>
+
+
+namespace {
+struct Message
+{
+  std::uint64_t id;
+  std::uint64_t payload[7];// NOLINT(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+};
+
+// Keeps a window of in-flight messages, each iteration frees the oldest one and allocates a new one
+template<typename Owner, typename Make> double churn(std::size_t count, Make make)
+{
+  constexpr std::size_t window = 64;
+  std::vector<Owner> in_flight(window);
+
+  const urc_bench::Stopwatch watch;
+  for (std::size_t i = 0; i != count; ++i) {
+    auto &slot = in_flight[i % window];
+    slot = make(i);
+    urc_bench::do_not_optimize(slot->id);
+  }
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 20'000'000;
+  constexpr int rounds = 5;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("Allocating and freeing %zu messages of %zu bytes, best of %d\n", count, sizeof(Message), rounds);
+
+  double heap = 1e300;
+  double pooled = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    heap = std::min(heap, churn<raii::unique_ptr<Message>>(count, [](std::size_t i) {
+      return raii::make_unique<Message>(Message{ i, {} });
+    }));
+    pooled = std::min(pooled, churn<raii::pooled_ptr<Message>>(count, [](std::size_t i) {
+      return raii::make_pooled<Message>(Message{ i, {} });
+    }));
+  }
+
+  urc_bench::print_result("raii::make_unique, global heap", heap);
+  urc_bench::print_result("raii::make_pooled, thread-local free list", pooled);
+
+  const auto stats = raii::pool_statistics<Message>();
+  std::printf("pool hit rate %.4f, misses %zu\n", stats.hit_rate(), stats.misses);
+
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Splitting a log file into lines, getline and std::getline through unique_rc<FILE *, stdio_fclose> and
+// std::ifstream versus raii::record_reader over an owned descriptor and an owned stream
+
+#include "Stopwatch.hpp"
+
+#include "urc/deleter_posix.hpp"
+#include "urc/record_reader.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <fcntl.h>
+
+#include <algorithm>// std::min
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull, std::free
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+
+namespace {
+struct line_stats
+{
+  std::size_t lines = 0;
+  std::size_t bytes = 0;
+
+  void add(std::string_view line) noexcept
+  {
+    ++lines;
+    bytes += line.size();
+  }
+};
+
+std::size_t make_file(const std::string &path, std::size_t megabytes)
+{
+  const raii::unique_rc<FILE *, raii::stdio_fclose> out{ std::fopen(path.c_str(), "wb") };
+  std::size_t written = 0;
+  for (std::size_t i = 0; written < megabytes << 20; ++i) {
+    // Lines of 40 to 200 bytes, like a request log
+    const std::string line = "2026-10-17T12:00:00Z INFO request " + std::to_string(i) + " path=/api/v1/items/"
+                             + std::string(i % 160, 'x') + '\n';
+    std::fwrite(line.data(), 1, line.size(), out.get());
+    written += line.size();
+  }
+  return written;
+}
+
+double read_getline(const std::string &path)
+{
+  const urc_bench::Stopwatch watch;
+  const raii::unique_rc<FILE *, raii::stdio_fclose> in{ std::fopen(path.c_str(), "rb") };
+  line_stats stats;
+  char *line = nullptr;
+  std::size_t capacity = 0;
+  for (ssize_t len = 0; (len = ::getline(&line, &capacity, in.get())) > 0;) {
+    stats.add(std::string_view{ line, static_cast<std::size_t>(len) - 1 });
+  }
+  std::free(line);// NOLINT(cppcoreguidelines-owning-memory, cppcoreguidelines-no-malloc, hicpp-no-malloc)
+  urc_bench::do_not_optimize(stats);
+  return watch.elapsed_ms();
+}
+
+double read_ifstream(const std::string &path)
+{
+  const urc_bench::Stopwatch watch;
+  std::ifstream in{ path, std::ios::binary };
+  line_stats stats;
+  for (std::string line; std::getline(in, line);) { stats.add(line); }
+  urc_bench::do_not_optimize(stats);
+  return watch.elapsed_ms();
+}
+
+template<typename File> double read_records(File file)
+{
+  const urc_bench::Stopwatch watch;
+  raii::record_reader reader{ std::move(file) };
+  line_stats stats;
+  reader.for_each([&stats](std::string_view line) { stats.add(line); });
+  urc_bench::do_not_optimize(stats);
+  return watch.elapsed_ms();
+}
+
+void print_throughput(const char *name, std::size_t bytes, double milliseconds)
+{
+  const double throughput = static_cast<double>(bytes) / 1000.0 / milliseconds;
+  std::printf("%-56s %12.3f ms %10.1f MB/s\n", name, milliseconds, throughput);
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_megabytes = 256;
+  constexpr int rounds = 3;
+  const std::size_t megabytes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_megabytes;
+  const std::string path = (std::filesystem::temp_directory_path() / "urc_bench_record_reader").string();
+  const std::size_t bytes = make_file(path, megabytes);
+
+  std::printf("split a page-cached file of %zu MiB into lines, best of %d\n", megabytes, rounds);
+
+  double posix_getline = 1e300;
+  double std_getline = 1e300;
+  double reader_fd = 1e300;
+  double reader_stream = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    posix_getline = std::min(posix_getline, read_getline(path));
+    std_getline = std::min(std_getline, read_ifstream(path));
+    reader_fd = std::min(reader_fd, read_records(raii::unique_fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) }));
+    reader_stream = std::min(
+      reader_stream, read_records(raii::unique_rc<FILE *, raii::stdio_fclose>{ std::fopen(path.c_str(), "rb") }));
+  }
+  print_throughput("getline, unique_rc<FILE *, stdio_fclose>", bytes, posix_getline);
+  print_throughput("std::getline, std::ifstream", bytes, std_getline);
+  print_throughput("raii::record_reader, raii::unique_fd", bytes, reader_fd);
+  print_throughput("raii::record_reader, unique_rc<FILE *, stdio_fclose>", bytes, reader_stream);
+
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,94 @@
+// Compares reallocation of a buffer of owners by move construction + destruction against trivial relocation
+
+#include "Stopwatch.hpp"
+
+#include "urc/relocate.hpp"
+#include "urc/unique_ptr.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <memory>
+#include <vector>
+
+
+namespace {
+using owner = raii::unique_ptr<int>;
+
+// Minimal growable buffer, which relocates its elements on reallocation
+class relocating_buffer
+{
+public:
+  explicit relocating_buffer(std::size_t capacity) : data_{ alloc_.allocate(capacity) }, capacity_{ capacity } {}
+
+  relocating_buffer(const relocating_buffer &) = delete;
+  relocating_buffer &operator=(const relocating_buffer &) = delete;
+  relocating_buffer(relocating_buffer &&) = delete;
+  relocating_buffer &operator=(relocating_buffer &&) = delete;
+
+  ~relocating_buffer()
+  {
+    std::destroy_n(data_, size_);
+    alloc_.deallocate(data_, capacity_);
+  }
+
+  void push_back(owner &&value)
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::construct_at(data_ + size_, std::move(value));
+    ++size_;
+  }
+
+  void reallocate(std::size_t new_capacity)
+  {
+    owner *new_data = alloc_.allocate(new_capacity);
+    raii::uninitialized_relocate_n(data_, size_, new_data);
+    alloc_.deallocate(data_, capacity_);
+
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  [[nodiscard]] const owner &front() const noexcept { return *data_; }
+
+private:
+  std::allocator<owner> alloc_;
+  owner *data_;
+  std::size_t capacity_;
+  std::size_t size_{};
+};
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 10'000'000;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("Reallocating %zu raii::unique_ptr<int> owners, trivially relocatable: %s\n",
+    count,
+    raii::is_trivially_relocatable_v<owner> ? "yes" : "no");
+
+  {
+    std::vector<owner> owners;
+    owners.reserve(count);
+    for (std::size_t i = 0; i != count; ++i) { owners.push_back(raii::make_unique<int>(static_cast<int>(i))); }
+
+    const urc_bench::Stopwatch watch;
+    owners.reserve(count * 2);
+    urc_bench::print_result("std::vector reserve (move + destroy)", watch.elapsed_ms());
+    urc_bench::do_not_optimize(owners.front());
+  }
+
+  {
+    relocating_buffer owners{ count };
+    for (std::size_t i = 0; i != count; ++i) { owners.push_back(raii::make_unique<int>(static_cast<int>(i))); }
+
+    const urc_bench::Stopwatch watch;
+    owners.reallocate(count * 2);
+    urc_bench::print_result("raii::uninitialized_relocate_n (memcpy)", watch.elapsed_ms());
+    urc_bench::do_not_optimize(owners.front());
+  }
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+// Scheduling short coroutines, a single queue guarded by a mutex and a condition variable versus raii::thread_pool
+
+#include "Stopwatch.hpp"
+
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+
+#include <algorithm>// std::min
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <deque>
+#include <exception>// std::terminate
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <utility>// std::move
+#include <vector>
+
+
+namespace {
+// The usual baseline, every submission and every worker goes through one lock
+class locked_queue_pool
+{
+public:
+  explicit locked_queue_pool(std::size_t thread_count)
+  {
+    for (std::size_t i = 0; i != thread_count; ++i) {
+      threads_.emplace_back([this] { run(); });
+    }
+  }
+
+  locked_queue_pool(const locked_queue_pool &) = delete;
+  locked_queue_pool &operator=(const locked_queue_pool &) = delete;
+  locked_queue_pool(locked_queue_pool &&) = delete;
+  locked_queue_pool &operator=(locked_queue_pool &&) = delete;
+
+  ~locked_queue_pool()
+  {
+    {
+      const std::lock_guard lock{ mutex_ };
+      stop_ = true;
+    }
+    ready_.notify_all();
+    for (auto &thread : threads_) { thread.join(); }
+  }
+
+  [[nodiscard]] auto schedule() noexcept
+  {
+    struct awaiter
+    {
+      locked_queue_pool *pool;
+
+      static constexpr bool await_ready() noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> hnd) const { pool->push(hnd); }
+      static constexpr void await_resume() noexcept {}
+    };
+    return awaiter{ this };
+  }
+
+private:
+  void push(std::coroutine_handle<> hnd)
+  {
+    {
+      const std::lock_guard lock{ mutex_ };
+      queue_.push_back(hnd);
+    }
+    ready_.notify_one();
+  }
+
+  void run()
+  {
+    for (;;) {
+      std::unique_lock lock{ mutex_ };
+      ready_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) { return; }
+      const std::coroutine_handle<> hnd = queue_.front();
+      queue_.pop_front();
+      lock.unlock();
+      hnd.resume();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::coroutine_handle<>> queue_;
+  bool stop_{ false };
+  std::vector<std::thread> threads_;
+};
+
+// A burst of CPU-bound work between two scheduling points
+std::size_t compute(std::size_t seed) noexcept
+{
+  constexpr int steps = 64;
+  std::size_t val = seed;
+  for (int i = 0; i < steps; ++i) { val = val * 6364136223846793005ULL + 1442695040888963407ULL; }
+  return val;
+}
+
+template<typename Pool> raii::task<> event(Pool &pool, std::size_t id, int hops, std::latch &done)
+{
+  std::size_t val = id;
+  for (int i = 0; i < hops; ++i) {
+    co_await pool.schedule();
+    val = compute(val);
+  }
+  urc_bench::do_not_optimize(val);
+  done.count_down();
+}
+
+// Starts a task eagerly and lets it destroy its own frame, when it finishes
+struct detached
+{
+  struct promise_type
+  {
+    static detached get_return_object() noexcept { return {}; }
+    static std::suspend_never initial_suspend() noexcept { return {}; }
+    static std::suspend_never final_suspend() noexcept { return {}; }
+    static void return_void() noexcept {}
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+detached start(raii::task<> work) { co_await std::move(work); }
+
+// Every event is started from inside the pool, as a coroutine spawned by another coroutine would be
+template<typename Pool> raii::task<> fan_out(Pool &pool, std::size_t count, int hops, std::latch &done)
+{
+  co_await pool.schedule();
+  for (std::size_t i = 0; i != count; ++i) { start(event(pool, i, hops, done)); }
+}
+
+template<typename Pool> double process(std::size_t thread_count, std::size_t count, int hops)
+{
+  Pool pool{ thread_count };
+  std::latch done{ static_cast<std::ptrdiff_t>(count) };
+
+  const urc_bench::Stopwatch watch;
+  raii::sync_wait(fan_out(pool, count, hops, done));
+  done.wait();
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 100'000;
+  constexpr int hops = 10;
+  constexpr int rounds = 3;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+  const std::size_t max_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+  std::printf("Processing %zu events of %d scheduling points, best of %d\n", count, hops, rounds);
+
+  for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+    double locked = 1e300;
+    double stealing = 1e300;
+    for (int round = 0; round != rounds; ++round) {
+      locked = std::min(locked, process<locked_queue_pool>(threads, count, hops));
+      stealing = std::min(stealing, process<raii::thread_pool>(threads, count, hops));
+    }
+    std::printf("%zu threads\n", threads);
+    urc_bench::print_result("  mutex and condition variable queue", locked);
+    urc_bench::print_result("  raii::thread_pool", stealing);
+  }
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Cost of awaiting raii::task, per await latency and deep await chains resumed by symmetric transfer
+
+#include "Stopwatch.hpp"
+
+#include "urc/task.hpp"
+
+#include <algorithm>// std::min
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+
+
+namespace {
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((noinline))
+#endif
+std::size_t leaf_function(std::size_t val) noexcept
+{
+  return val + 1;
+}
+
+raii::task<std::size_t> leaf(std::size_t val) { co_return val + 1; }
+
+raii::task<std::size_t> await_leaves(std::size_t count)
+{
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i != count; ++i) {
+    sum += co_await leaf(i);
+    urc_bench::do_not_optimize(sum);
+  }
+  co_return sum;
+}
+
+raii::task<std::size_t> chain(std::size_t depth)
+{
+  if (depth == 0) { co_return 0; }
+  co_return co_await chain(depth - 1) + 1;
+}
+
+double call_functions(std::size_t count)
+{
+  const urc_bench::Stopwatch watch;
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i != count; ++i) {
+    sum += leaf_function(i);
+    urc_bench::do_not_optimize(sum);
+  }
+  return watch.elapsed_ms();
+}
+
+double await_tasks(std::size_t count)
+{
+  const urc_bench::Stopwatch watch;
+  urc_bench::do_not_optimize(raii::sync_wait(await_leaves(count)));
+  return watch.elapsed_ms();
+}
+
+double await_chain(std::size_t depth)
+{
+  const urc_bench::Stopwatch watch;
+  urc_bench::do_not_optimize(raii::sync_wait(chain(depth)));
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_count = 10'000'000;
+  constexpr std::array<std::size_t, 4> depths{ 10, 1'000, 100'000, 10'000'000 };
+  constexpr int rounds = 5;
+  const std::size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_count;
+
+  std::printf("Awaiting %zu tasks and chains of nested tasks, best of %d\n", count, rounds);
+
+  double function = 1e300;
+  double awaited = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    function = std::min(function, call_functions(count));
+    awaited = std::min(awaited, await_tasks(count));
+  }
+
+  urc_bench::print_result("plain function call", function);
+  urc_bench::print_result("co_await raii::task, create, run and destroy", awaited);
+  std::printf("%-56s %12.3f ns\n", "per await", awaited * 1e6 / static_cast<double>(count));
+
+  for (const std::size_t depth : depths) {
+    double elapsed = 1e300;
+    for (int round = 0; round != rounds; ++round) { elapsed = std::min(elapsed, await_chain(depth)); }
+    std::printf("await chain of depth %-35zu %12.3f ns per level\n", depth, elapsed * 1e6 / static_cast<double>(depth));
+  }
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+// Fanning out sub-requests on a raii::thread_pool, awaiting them one at a time versus raii::when_all
+
+#include "Stopwatch.hpp"
+
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+#include "urc/when_all.hpp"
+
+#include <algorithm>// std::max, std::min
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>// std::strtoull
+#include <thread>
+#include <vector>
+
+
+namespace {
+// A burst of CPU-bound work, standing in for a sub-request
+std::size_t compute(std::size_t seed) noexcept
+{
+  constexpr int steps = 2'000;
+  std::size_t val = seed;
+  for (int i = 0; i < steps; ++i) { val = val * 6364136223846793005ULL + 1442695040888963407ULL; }
+  return val;
+}
+
+raii::task<std::size_t> sub_request(raii::thread_pool &pool, std::size_t id)
+{
+  co_await pool.schedule();
+  co_return compute(id);
+}
+
+raii::task<std::size_t> one_at_a_time(raii::thread_pool &pool, std::size_t width)
+{
+  std::size_t res = 0;
+  for (std::size_t i = 0; i != width; ++i) { res += co_await sub_request(pool, i); }
+  co_return res;
+}
+
+raii::task<std::size_t> all_at_once(raii::thread_pool &pool, std::size_t width)
+{
+  std::vector<raii::task<std::size_t>> children;
+  children.reserve(width);
+  for (std::size_t i = 0; i != width; ++i) { children.push_back(sub_request(pool, i)); }
+
+  std::size_t res = 0;
+  for (auto &child : co_await raii::when_all(std::move(children))) { res += co_await child; }
+  co_return res;
+}
+
+template<typename Request> double process(raii::thread_pool &pool, std::size_t requests, std::size_t width, Request req)
+{
+  const urc_bench::Stopwatch watch;
+  for (std::size_t i = 0; i != requests; ++i) { urc_bench::do_not_optimize(raii::sync_wait(req(pool, width))); }
+  return watch.elapsed_ms();
+}
+}// namespace
+
+
+int main(int argc, char **argv)
+{
+  constexpr std::size_t default_requests = 2'000;
+  constexpr std::size_t width = 32;
+  constexpr int rounds = 3;
+  const std::size_t requests = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : default_requests;
+  const std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+  std::printf("%zu requests of %zu sub-requests on %zu threads, best of %d\n", requests, width, threads, rounds);
+
+  raii::thread_pool pool{ threads };
+  double sequential = 1e300;
+  double fanned_out = 1e300;
+  for (int round = 0; round != rounds; ++round) {
+    sequential = std::min(sequential, process(pool, requests, width, one_at_a_time));
+    fanned_out = std::min(fanned_out, process(pool, requests, width, all_at_once));
+  }
+  urc_bench::print_result("co_await one at a time", sequential);
+  urc_bench::print_result("raii::when_all", fanned_out);
+
+  return 0;
+}
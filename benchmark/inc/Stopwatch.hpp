@@ -0,0 +1,46 @@
+#ifndef URC_BENCH_STOPWATCH_HPP
+#define URC_BENCH_STOPWATCH_HPP
+
+#include <chrono>
+#include <cstdio>
+
+
+namespace urc_bench {
+
+// Measures wall clock time elapsed since construction or the last restart()
+class Stopwatch
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  Stopwatch() noexcept : start_{ clock::now() } {}
+
+  void restart() noexcept { start_ = clock::now(); }
+
+  [[nodiscard]] std::chrono::nanoseconds elapsed() const noexcept { return clock::now() - start_; }
+
+  [[nodiscard]] double elapsed_ms() const noexcept
+  { return std::chrono::duration<double, std::milli>(elapsed()).count(); }
+
+private:
+  clock::time_point start_;
+};
+
+// Prevents the optimiser from discarding a value computed by a benchmark
+template<typename T> inline void do_not_optimize(const T &value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static_cast<void>(static_cast<const volatile T &>(value));
+#endif
+}
+
+inline void print_result(const char *name, double milliseconds) noexcept
+{
+  std::printf("%-56s %12.3f ms\n", name, milliseconds);
+}
+
+}// namespace urc_bench
+
+#endif// URC_BENCH_STOPWATCH_HPP
@@ -0,0 +1,19 @@
+#ifndef RAII_TESTSUITE_FRAME_ALLOCATION_HPP
+#define RAII_TESTSUITE_FRAME_ALLOCATION_HPP
+
+#pragma once
+
+// Coroutines allocating their frames with the std::allocator_arg overloads of operator new are defined between
+// RAII_TEST_FRAME_ALLOCATION_BEGIN and RAII_TEST_FRAME_ALLOCATION_END, which silence the false positive
+// -Wmismatched-new-delete of GCC, see raii::pooled_frame_promise in urc/frame_allocator.hpp
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define RAII_TEST_FRAME_ALLOCATION_BEGIN \
+  _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wmismatched-new-delete\"")
+#define RAII_TEST_FRAME_ALLOCATION_END _Pragma("GCC diagnostic pop")
+#else
+#define RAII_TEST_FRAME_ALLOCATION_BEGIN
+#define RAII_TEST_FRAME_ALLOCATION_END
+#endif
+
+#endif// RAII_TESTSUITE_FRAME_ALLOCATION_HPP
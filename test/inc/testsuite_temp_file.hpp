@@ -0,0 +1,87 @@
+#ifndef RAII_TESTSUITE_TEMP_FILE_HPP
+#define RAII_TESTSUITE_TEMP_FILE_HPP
+
+#pragma once
+
+#include "urc/deleter_posix.hpp"
+
+#include <fcntl.h>
+#include <sys/types.h>// off_t, ssize_t
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>// std::size_t, std::byte
+#include <cstdlib>// mkstemp
+#include <filesystem>
+#include <span>
+#include <string>
+#include <system_error>
+
+
+namespace raii_test {
+
+// File created with a unique name in the temporary directory, removed by the destructor.
+// Its descriptor stays open for reading and writing, other ones are opened by path() or open()
+class temp_file
+{
+public:
+  // Creates a file of size zero bytes
+  explicit temp_file(std::size_t size = 0) : temp_file{ std::span<const std::byte>{} }
+  {
+    if (::ftruncate(fd(), static_cast<off_t>(size)) != 0) {
+      throw std::system_error{ errno, std::system_category(), "ftruncate" };
+    }
+  }
+
+  explicit temp_file(std::span<const std::byte> contents)
+    : path_{ (std::filesystem::temp_directory_path() / "urc_test_XXXXXX").string() }
+  {
+    fd_ = raii::unique_fd{ ::mkstemp(path_.data()) };
+    if (!fd_) { throw std::system_error{ errno, std::system_category(), "mkstemp" }; }
+    for (std::size_t written = 0; written != contents.size();) {
+      const ssize_t res = ::pwrite(fd(), contents.subspan(written).data(), contents.size() - written,
+        static_cast<off_t>(written));
+      if (res < 0) { throw std::system_error{ errno, std::system_category(), "pwrite" }; }
+      written += static_cast<std::size_t>(res);
+    }
+  }
+
+  temp_file(const temp_file &) = delete;
+  temp_file &operator=(const temp_file &) = delete;
+  temp_file(temp_file &&) = delete;
+  temp_file &operator=(temp_file &&) = delete;
+
+  ~temp_file() { static_cast<void>(::unlink(path_.c_str())); }
+
+  [[nodiscard]] const char *path() const noexcept { return path_.c_str(); }
+
+  [[nodiscard]] int fd() const noexcept { return fd_.get(); }
+
+  // Opens another descriptor of the file, which has its own position
+  [[nodiscard]] raii::unique_fd open(int flags) const
+  {
+    raii::unique_fd res{ ::open(path(), flags | O_CLOEXEC) };
+    if (!res) { throw std::system_error{ errno, std::system_category(), "open" }; }
+    return res;
+  }
+
+  [[nodiscard]] std::string contents() const
+  {
+    const raii::unique_fd in = open(O_RDONLY);
+    std::string res;
+    std::array<char, 65536> buf{};
+    for (ssize_t len = 0; (len = ::read(in.get(), buf.data(), buf.size())) > 0;) {
+      res.append(buf.data(), static_cast<std::size_t>(len));
+    }
+    return res;
+  }
+
+private:
+  std::string path_;
+  raii::unique_fd fd_;
+};
+
+}// namespace raii_test
+
+#endif// RAII_TESTSUITE_TEMP_FILE_HPP
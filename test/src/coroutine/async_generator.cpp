@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/async_generator.hpp"
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> alive_count{ 0 };
+
+struct Tracked
+{
+  Tracked() noexcept { ++alive_count; }
+  Tracked(const Tracked &) noexcept { ++alive_count; }
+  Tracked(Tracked &&) noexcept { ++alive_count; }
+  Tracked &operator=(const Tracked &) = default;
+  Tracked &operator=(Tracked &&) = default;
+  ~Tracked() { --alive_count; }
+};
+
+raii::task<int> twice(int val) { co_return val * 2; }
+
+// Awaits a task between the values and counts, how far it has run
+raii::async_generator<int> doubled(int count, int &produced)
+{
+  for (int i = 0; i < count; ++i) {
+    const int val = co_await twice(i);
+    ++produced;
+    co_yield val;
+  }
+}
+
+raii::async_generator<std::string> words()
+{
+  const std::string first{ "const" };
+  co_yield first;
+  std::string second{ "lvalue" };
+  co_yield second;
+  co_yield std::string{ "temporary" };
+}
+
+raii::async_generator<int> failing()
+{
+  co_yield 1;
+  throw std::runtime_error{ "producer failed" };
+}
+
+raii::async_generator<int> endless(Tracked /*param*/)
+{
+  for (int i = 0;; ++i) { co_yield i; }
+}
+
+// Every value is produced on a worker thread of the pool
+raii::async_generator<std::thread::id> on_pool(raii::thread_pool &pool, int count)
+{
+  for (int i = 0; i < count; ++i) {
+    co_await pool.schedule();
+    co_yield std::this_thread::get_id();
+  }
+}
+
+template<typename T> raii::task<std::vector<T>> collect(raii::async_generator<T> gen)
+{
+  std::vector<T> res;
+  while (T *val = co_await gen.next()) { res.push_back(*val); }
+  co_return res;
+}
+}// namespace
+
+
+TEST_CASE("raii::async_generator yields values produced by awaiting coroutines", "[async_generator]")
+{
+  int produced = 0;
+  CHECK(raii::sync_wait(collect(doubled(4, produced))) == std::vector{ 0, 2, 4, 6 });
+  CHECK(produced == 4);
+  CHECK(raii::sync_wait(collect(words())) == std::vector<std::string>{ "const", "lvalue", "temporary" });
+}
+
+TEST_CASE("raii::async_generator runs only as far as the consumer asks", "[async_generator]")
+{
+  int produced = 0;
+  raii::sync_wait([](int &count) -> raii::task<> {
+    auto gen = doubled(100, count);
+    CHECK(count == 0);
+    // co_await stays out of the assertion macros, Catch may expand their argument twice
+    const int *first = co_await gen.next();
+    REQUIRE(first != nullptr);
+    CHECK(*first == 0);
+    const int *second = co_await gen.next();
+    REQUIRE(second != nullptr);
+    CHECK(*second == 2);
+    CHECK(count == 2);
+  }(produced));
+  CHECK(produced == 2);
+}
+
+TEST_CASE("raii::async_generator rethrows exceptions of the producer", "[async_generator]")
+{
+  raii::sync_wait([]() -> raii::task<> {
+    auto gen = failing();
+    const int *first = co_await gen.next();
+    REQUIRE(first != nullptr);
+    CHECK(*first == 1);
+    bool thrown = false;
+    try {
+      static_cast<void>(co_await gen.next());
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(gen.done());
+    const int *after = co_await gen.next();
+    CHECK(after == nullptr);
+  }());
+}
+
+TEST_CASE("raii::async_generator destroys an unfinished producer", "[async_generator]")
+{
+  alive_count = 0;
+  raii::sync_wait([]() -> raii::task<> {
+    auto gen = endless(Tracked{});
+    const int *first = co_await gen.next();
+    REQUIRE(first != nullptr);
+    CHECK(*first == 0);
+    const int *second = co_await gen.next();
+    REQUIRE(second != nullptr);
+    CHECK(*second == 1);
+    CHECK(alive_count == 1);
+  }());
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::for_each awaits every value of a raii::async_generator", "[async_generator]")
+{
+  int produced = 0;
+  int sum = 0;
+  raii::sync_wait(raii::for_each(doubled(5, produced), [&sum](int val) { sum += val; }));
+  CHECK(sum == 20);
+
+  std::vector<int> seen;
+  raii::sync_wait(raii::for_each(doubled(3, produced), [&seen](int val) -> raii::task<> {
+    seen.push_back(co_await twice(val));
+  }));
+  CHECK(seen == std::vector{ 0, 4, 8 });
+}
+
+TEST_CASE("raii::async_generator resumes the consumer on the thread of the producer", "[async_generator][threads]")
+{
+  raii::thread_pool pool{ 2 };
+  const auto ids = raii::sync_wait(collect(on_pool(pool, 10)));
+  REQUIRE(ids.size() == 10);
+  for (const auto &id : ids) { CHECK(id != std::this_thread::get_id()); }
+}
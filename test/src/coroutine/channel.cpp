@@ -0,0 +1,223 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/bounded_queue.hpp"
+#include "urc/channel.hpp"
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>// std::terminate
+#include <latch>
+#include <memory>// std::unique_ptr, std::make_unique
+#include <optional>
+#include <utility>// std::move
+#include <vector>
+
+
+namespace {
+// Starts eagerly and destroys its own frame, when it finishes
+struct Detached
+{
+  struct promise_type
+  {
+    static Detached get_return_object() noexcept { return {}; }
+    static std::suspend_never initial_suspend() noexcept { return {}; }
+    static std::suspend_never final_suspend() noexcept { return {}; }
+    static void return_void() noexcept {}
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+Detached receive_all(raii::channel<int> &chan, std::vector<int> &out, bool &finished)
+{
+  while (const std::optional<int> val = co_await chan.receive()) { out.push_back(*val); }
+  finished = true;
+}
+
+Detached send_all(raii::channel<int> &chan, int count, int &sent, bool &rejected)
+{
+  for (int i = 0; i < count; ++i) {
+    if (!co_await chan.send(i)) {
+      rejected = true;
+      co_return;
+    }
+    ++sent;
+  }
+}
+
+// The last producer to finish closes the channel
+raii::task<> produce(raii::thread_pool &pool,
+  raii::channel<std::size_t> &chan,
+  std::size_t first,
+  std::size_t count,
+  std::atomic<std::size_t> &producing)
+{
+  co_await pool.schedule();
+  for (std::size_t i = first; i != first + count; ++i) { co_await chan.send(i); }
+  if (producing.fetch_sub(1, std::memory_order_acq_rel) == 1) { chan.close(); }
+}
+
+raii::task<> consume(raii::thread_pool &pool,
+  raii::channel<std::size_t> &chan,
+  std::atomic<std::size_t> &sum,
+  std::atomic<std::size_t> &received,
+  std::latch &done)
+{
+  co_await pool.schedule();
+  while (const std::optional<std::size_t> val = co_await chan.receive()) {
+    sum.fetch_add(*val, std::memory_order_relaxed);
+    received.fetch_add(1, std::memory_order_relaxed);
+  }
+  done.count_down();
+}
+}// namespace
+
+
+TEST_CASE("raii::bounded_queue is a FIFO of fixed capacity", "[channel][bounded_queue]")
+{
+  raii::bounded_queue<int> queue{ 3 };
+  CHECK(queue.capacity() == 4);
+  CHECK(queue.empty());
+  CHECK_FALSE(queue.try_pop());
+
+  for (int i = 0; i < 4; ++i) { CHECK(queue.try_push(i)); }
+  CHECK_FALSE(queue.try_push(4));
+
+  // Wraps around the ring several times
+  for (int i = 0; i < 20; ++i) {
+    CHECK(queue.try_pop() == i);
+    CHECK(queue.try_push(i + 4));
+  }
+  for (int i = 20; i < 24; ++i) { CHECK(queue.try_pop() == i); }
+  CHECK(queue.empty());
+}
+
+TEST_CASE("raii::bounded_queue keeps a move-only value, if it is full", "[channel][bounded_queue]")
+{
+  raii::bounded_queue<std::unique_ptr<int>> queue{ 2 };
+  CHECK(queue.try_push(std::make_unique<int>(1)));
+  CHECK(queue.try_push(std::make_unique<int>(2)));
+
+  auto val = std::make_unique<int>(3);
+  CHECK_FALSE(queue.try_push(std::move(val)));
+  REQUIRE(val != nullptr);// NOLINT(bugprone-use-after-move, hicpp-invalid-access-moved)
+  CHECK(*val == 3);
+  // The remaining values are destroyed with the queue
+}
+
+TEST_CASE("A receiver suspends on an empty raii::channel", "[channel]")
+{
+  raii::channel<int> chan{ 4 };
+  std::vector<int> out;
+  bool finished = false;
+
+  receive_all(chan, out, finished);
+  CHECK(out.empty());
+
+  CHECK(chan.try_send(1));
+  CHECK(chan.try_send(2));
+  CHECK(out == std::vector<int>{ 1, 2 });
+
+  chan.close();
+  CHECK(finished);
+  CHECK_FALSE(chan.try_send(3));
+}
+
+TEST_CASE("A sender suspends on a full raii::channel", "[channel]")
+{
+  raii::channel<int> chan{ 2 };
+  int sent = 0;
+  bool rejected = false;
+
+  send_all(chan, 5, sent, rejected);
+  CHECK(sent == 2);
+
+  CHECK(chan.try_receive() == 0);
+  CHECK(sent == 3);
+  CHECK(chan.try_receive() == 1);
+  CHECK(chan.try_receive() == 2);
+  CHECK(chan.try_receive() == 3);
+  CHECK(sent == 5);
+  CHECK(chan.try_receive() == 4);
+  CHECK_FALSE(chan.try_receive());
+  CHECK_FALSE(rejected);
+}
+
+TEST_CASE("Suspended senders and receivers meet in order", "[channel]")
+{
+  raii::channel<int> chan{ 2 };
+  int sent = 0;
+  bool rejected = false;
+  std::vector<int> out;
+  bool finished = false;
+
+  send_all(chan, 10, sent, rejected);
+  receive_all(chan, out, finished);
+  CHECK(sent == 10);
+  CHECK(out == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+
+  chan.close();
+  CHECK(finished);
+}
+
+TEST_CASE("Closing a raii::channel resumes suspended senders", "[channel]")
+{
+  raii::channel<int> chan{ 2 };
+  int sent = 0;
+  bool rejected = false;
+
+  send_all(chan, 5, sent, rejected);
+  chan.close();
+  CHECK(rejected);
+  CHECK(sent == 2);
+
+  // Values sent before close() can still be received
+  CHECK(chan.try_receive() == 0);
+  CHECK(chan.try_receive() == 1);
+  CHECK_FALSE(chan.try_receive());
+}
+
+TEST_CASE("Destroying a raii::channel resumes its waiters", "[channel]")
+{
+  std::vector<int> out;
+  bool finished = false;
+  int sent = 0;
+  bool rejected = false;
+  {
+    raii::channel<int> empty{ 2 };
+    receive_all(empty, out, finished);
+    raii::channel<int> full{ 2 };
+    send_all(full, 5, sent, rejected);
+    CHECK_FALSE(finished);
+    CHECK_FALSE(rejected);
+  }
+  CHECK(finished);
+  CHECK(out.empty());
+  CHECK(rejected);
+}
+
+TEST_CASE("raii::channel passes every value exactly once between threads", "[channel][threads]")
+{
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t consumers = 4;
+  constexpr std::size_t per_producer = 10'000;
+
+  raii::thread_pool pool{ 4 };
+  raii::channel<std::size_t> chan{ 16 };
+  std::atomic<std::size_t> sum{ 0 };
+  std::atomic<std::size_t> received{ 0 };
+  std::atomic<std::size_t> producing{ producers };
+  std::latch done{ static_cast<std::ptrdiff_t>(consumers) };
+
+  for (std::size_t i = 0; i != consumers; ++i) { pool.spawn(consume(pool, chan, sum, received, done)); }
+  for (std::size_t i = 0; i != producers; ++i) {
+    pool.spawn(produce(pool, chan, i * per_producer, per_producer, producing));
+  }
+  done.wait();
+
+  constexpr std::size_t total = producers * per_producer;
+  CHECK(received == total);
+  CHECK(sum == total * (total - 1) / 2);
+}
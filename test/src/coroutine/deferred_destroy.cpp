@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/deferred_destroy.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>// std::terminate
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> alive_count{ 0 };
+
+struct Tracked
+{
+  Tracked() noexcept { ++alive_count; }
+  Tracked(const Tracked &) noexcept { ++alive_count; }
+  Tracked(Tracked &&) noexcept { ++alive_count; }
+  Tracked &operator=(const Tracked &) = default;
+  Tracked &operator=(Tracked &&) = default;
+  ~Tracked() { --alive_count; }
+};
+
+// Runs to its final suspend point, the owner destroys the frame with the parameters
+struct Completed
+{
+  struct promise_type
+  {
+    Completed get_return_object() noexcept { return Completed{ handle::from_promise(*this) }; }
+    static std::suspend_never initial_suspend() noexcept { return {}; }
+    static std::suspend_always final_suspend() noexcept { return {}; }
+    static void return_void() noexcept {}
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  explicit Completed(handle hnd) noexcept : coro{ hnd } {}
+
+  raii::deferred_coroutine_handle<promise_type> coro;
+};
+
+Completed with_local(Tracked /*param*/) { co_return; }
+
+// Owns another deferred frame, which is released, when this frame is destroyed
+Completed with_nested(Tracked /*param*/, Completed /*nested*/) { co_return; }
+
+Completed make_nested() { return with_nested(Tracked{}, with_local(Tracked{})); }
+
+constexpr std::size_t frameCount = 100;
+}// namespace
+
+
+TEST_CASE("raii::deferred_coroutine_handle has the size of a handle", "[deferred_destroy][layout]")
+{
+  STATIC_CHECK(std::is_empty_v<raii::deferred_coroutine_destroy>);
+  STATIC_CHECK(sizeof(raii::deferred_coroutine_handle<void>) == sizeof(std::coroutine_handle<>));
+  STATIC_CHECK(std::is_nothrow_invocable_v<raii::deferred_coroutine_destroy, std::coroutine_handle<>>);
+}
+
+TEST_CASE("Frames are destroyed, when the thread drains its queue", "[deferred_destroy]")
+{
+  alive_count = 0;
+  raii::drain_deferred_destroys();
+
+  for (std::size_t i = 0; i != frameCount; ++i) { static_cast<void>(with_local(Tracked{})); }
+  CHECK(alive_count == static_cast<int>(frameCount));
+  CHECK(raii::pending_deferred_destroys() == frameCount);
+
+  CHECK(raii::drain_deferred_destroys(10) == 10);
+  CHECK(alive_count == static_cast<int>(frameCount) - 10);
+
+  CHECK(raii::drain_deferred_destroys() == frameCount - 10);
+  CHECK(alive_count == 0);
+  CHECK(raii::pending_deferred_destroys() == 0);
+}
+
+TEST_CASE("Frames released by destroyed frames are queued again", "[deferred_destroy]")
+{
+  alive_count = 0;
+  static_cast<void>(make_nested());
+  CHECK(alive_count == 2);
+
+  CHECK(raii::drain_deferred_destroys() == 1);
+  CHECK(alive_count == 1);
+  CHECK(raii::pending_deferred_destroys() == 1);
+  CHECK(raii::drain_deferred_destroys() == 1);
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("Frames still queued are destroyed, when the thread exits", "[deferred_destroy][threads]")
+{
+  alive_count = 0;
+  std::thread worker{ [] {
+    for (std::size_t i = 0; i != frameCount; ++i) { static_cast<void>(make_nested()); }
+  } };
+  worker.join();
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::deferred_destroy_thread destroys frames handed off", "[deferred_destroy][threads]")
+{
+  alive_count = 0;
+  raii::deferred_destroy_thread closer;
+
+  for (int tick = 0; tick < 3; ++tick) {
+    for (std::size_t i = 0; i != frameCount; ++i) { static_cast<void>(make_nested()); }
+    closer.hand_off();
+    CHECK(raii::pending_deferred_destroys() == 0);
+  }
+  closer.wait_idle();
+  CHECK(alive_count == 0);
+  CHECK(closer.destroyed() == frameCount * 3 * 2);
+}
@@ -0,0 +1,179 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "testsuite_frame_allocation.hpp"
+#include "urc/deferred_destroy.hpp"
+#include "urc/frame_telemetry.hpp"
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>// std::terminate
+#include <memory>// std::allocator, std::allocator_arg
+#include <numeric>// std::accumulate
+#include <span>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+RAII_TEST_FRAME_ALLOCATION_BEGIN
+
+
+namespace {
+// Coroutine type with an instrumented promise, Tag keeps the counters of the tests apart
+template<typename Tag, typename Deleter = raii::coroutine_destroy> struct Probe
+{
+  struct promise_type : raii::instrumented_frame_promise<promise_type>
+  {
+    Probe get_return_object() noexcept { return Probe{ handle::from_promise(*this) }; }
+    static std::suspend_never initial_suspend() noexcept { return {}; }
+    static std::suspend_always final_suspend() noexcept { return {}; }
+    static void return_void() noexcept {}
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  explicit Probe(handle hnd) noexcept : coro{ hnd } {}
+
+  raii::instrumented_coroutine_handle<promise_type, Deleter> coro;
+};
+
+struct LightTag;
+struct HeavyTag;
+struct LifetimeTag;
+struct DeferredTag;
+
+using Light = Probe<LightTag>;
+using Heavy = Probe<HeavyTag>;
+
+Light light() { co_return; }
+
+Light light_allocated(std::allocator_arg_t /*tag*/, const std::allocator<char> & /*alloc*/) { co_return; }
+
+Heavy heavy()
+{
+  std::array<std::byte, 1024> buf{};
+  co_await std::suspend_always{};
+  buf[0] = std::byte{ 1 };
+}
+
+Probe<LifetimeTag> sleeper() { co_return; }
+
+Probe<DeferredTag, raii::deferred_coroutine_destroy> deferred() { co_return; }
+
+// Coroutine without the mixin, released through the instrumented deleter
+struct Plain
+{
+  struct promise_type
+  {
+    Plain get_return_object() noexcept { return Plain{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+    static std::suspend_never initial_suspend() noexcept { return {}; }
+    static std::suspend_always final_suspend() noexcept { return {}; }
+    static void return_void() noexcept {}
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+  };
+
+  explicit Plain(std::coroutine_handle<promise_type> hnd) noexcept : coro{ hnd } {}
+
+  raii::instrumented_coroutine_handle<promise_type> coro;
+};
+
+Plain plain() { co_return; }
+
+std::size_t sum(const auto &histogram) { return std::accumulate(histogram.begin(), histogram.end(), std::size_t{ 0 }); }
+}// namespace
+
+
+TEST_CASE("raii::instrumented_destroy is an empty deleter", "[frame_telemetry][layout]")
+{
+  STATIC_CHECK(std::is_empty_v<raii::instrumented_destroy<>>);
+  STATIC_CHECK(sizeof(raii::instrumented_coroutine_handle<Light::promise_type>) == sizeof(std::coroutine_handle<>));
+  STATIC_CHECK(raii::instrumented_promise<Light::promise_type>);
+  STATIC_CHECK_FALSE(raii::instrumented_promise<Plain::promise_type>);
+}
+
+TEST_CASE("raii::instrumented_frame_promise counts frames, sizes, live frames and the peak", "[frame_telemetry]")
+{
+  raii::reset_frame_statistics<Light::promise_type>();
+  {
+    std::vector<Light> frames;
+    for (int i = 0; i < 3; ++i) { frames.push_back(light()); }
+    frames.push_back(light_allocated(std::allocator_arg, std::allocator<char>{}));
+
+    const auto stats = raii::frame_statistics_of<Light::promise_type>();
+    CHECK(stats.allocations == 4);
+    CHECK(stats.live == 4);
+    CHECK(stats.peak == 4);
+    CHECK(stats.max_size > 0);
+    CHECK(stats.mean_size() <= stats.max_size);
+    CHECK(sum(stats.size_histogram) == 4);
+    CHECK(stats.lifetimes == 0);
+  }
+  const auto stats = raii::frame_statistics_of<Light::promise_type>();
+  CHECK(stats.live == 0);
+  CHECK(stats.peak == 4);
+  CHECK(stats.lifetimes == 4);
+  CHECK(sum(stats.lifetime_histogram) == 4);
+
+  raii::reset_frame_statistics<Light::promise_type>();
+  CHECK(raii::frame_statistics_of<Light::promise_type>().allocations == 0);
+  CHECK(raii::frame_statistics_of<Light::promise_type>().peak == 0);
+}
+
+TEST_CASE("raii::frame_statistics tells heavy frames apart", "[frame_telemetry]")
+{
+  static_cast<void>(light());
+  static_cast<void>(heavy());
+
+  const auto light_stats = raii::frame_statistics_of<Light::promise_type>();
+  const auto heavy_stats = raii::frame_statistics_of<Heavy::promise_type>();
+  CHECK(heavy_stats.max_size >= 1024);
+  CHECK(heavy_stats.max_size > light_stats.max_size);
+  // A kilobyte frame falls into the 2 KiB size class
+  CHECK(heavy_stats.size_histogram[11] == heavy_stats.allocations);
+}
+
+TEST_CASE("raii::instrumented_destroy records the lifetime of a frame", "[frame_telemetry]")
+{
+  using namespace std::chrono_literals;
+  raii::reset_frame_statistics<Probe<LifetimeTag>::promise_type>();
+  {
+    const auto frame = sleeper();
+    std::this_thread::sleep_for(2ms);
+  }
+  const auto stats = raii::frame_statistics_of<Probe<LifetimeTag>::promise_type>();
+  REQUIRE(stats.lifetimes == 1);
+  // 2 ms is more than 2^20 ns
+  CHECK(sum(std::span{ stats.lifetime_histogram }.first(21)) == 0);
+}
+
+TEST_CASE("raii::instrumented_destroy passes frames on to the wrapped deleter", "[frame_telemetry]")
+{
+  using promise = Probe<DeferredTag, raii::deferred_coroutine_destroy>::promise_type;
+  raii::drain_deferred_destroys();
+
+  static_cast<void>(deferred());
+  CHECK(raii::pending_deferred_destroys() == 1);
+  CHECK(raii::frame_statistics_of<promise>().lifetimes == 1);
+  CHECK(raii::frame_statistics_of<promise>().live == 1);
+
+  raii::drain_deferred_destroys();
+  CHECK(raii::frame_statistics_of<promise>().live == 0);
+
+  // Without the mixin nothing is recorded, the frame is destroyed all the same
+  static_cast<void>(plain());
+}
+
+TEST_CASE("raii::for_each_frame_statistics visits every instrumented promise type", "[frame_telemetry]")
+{
+  static_cast<void>(heavy());
+  bool found = false;
+  raii::for_each_frame_statistics([&found](std::string_view name, const raii::frame_statistics &stats) {
+    if (name.find("HeavyTag") != std::string_view::npos) { found = stats.allocations > 0; }
+  });
+  CHECK(found);
+}
+
+RAII_TEST_FRAME_ALLOCATION_END
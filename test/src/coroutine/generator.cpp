@@ -0,0 +1,180 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "testsuite_frame_allocation.hpp"
+#include "urc/generator.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>// std::allocator_arg
+#include <memory_resource>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+RAII_TEST_FRAME_ALLOCATION_BEGIN
+
+
+namespace {
+raii::generator<int> iota(int first, int last)
+{
+  for (int i = first; i < last; ++i) { co_yield i; }
+}
+
+raii::generator<const std::string &> words()
+{
+  const std::string hello{ "hello" };
+  co_yield hello;
+  co_yield "world";// converted to a temporary std::string
+}
+
+struct Node
+{
+  int value;
+  std::vector<Node> children;
+};
+
+// Pre-order traversal, every level of the tree is a nested generator
+raii::generator<int> traverse(const Node &node)
+{
+  co_yield node.value;
+  for (const Node &child : node.children) { co_yield raii::elements_of(traverse(child)); }
+}
+
+raii::generator<int> countdown(int depth)
+{
+  if (depth == 0) { co_return; }
+  co_yield depth;
+  co_yield raii::elements_of(countdown(depth - 1));
+}
+
+raii::generator<int> throwing_after(int count)
+{
+  co_yield raii::elements_of(iota(0, count));
+  throw std::runtime_error("generator failed");
+}
+
+raii::generator<int> catching(int count)
+{
+  bool failed = false;
+  try {
+    co_yield raii::elements_of(throwing_after(count));
+  } catch (const std::runtime_error &) {
+    failed = true;
+  }
+  if (failed) { co_yield -1; }
+}
+
+template<typename Alloc>
+raii::generator<int> iota_with(std::allocator_arg_t /*tag*/, const Alloc & /*alloc*/, int last)
+{
+  for (int i = 0; i < last; ++i) { co_yield i; }
+}
+
+template<typename Range> std::vector<std::ranges::range_value_t<Range>> collect(Range &&range)
+{
+  std::vector<std::ranges::range_value_t<Range>> res;
+  for (auto &&elem : range) { res.push_back(std::forward<decltype(elem)>(elem)); }
+  return res;
+}
+
+constexpr std::size_t bufferSize = 4096;
+}// namespace
+
+
+TEST_CASE("raii::generator models std::ranges::input_range", "[generator][requirements]")
+{
+  using gen = raii::generator<int>;
+  STATIC_CHECK(std::ranges::input_range<gen>);
+  STATIC_CHECK(std::ranges::view<gen>);
+  STATIC_CHECK_FALSE(std::ranges::forward_range<gen>);
+  STATIC_CHECK(std::same_as<std::ranges::range_reference_t<gen>, int &&>);
+  STATIC_CHECK(std::same_as<std::ranges::range_value_t<gen>, int>);
+  STATIC_CHECK(
+    std::same_as<std::ranges::range_reference_t<raii::generator<const std::string &>>, const std::string &>);
+  STATIC_CHECK_FALSE(std::is_copy_constructible_v<gen>);
+  STATIC_CHECK(std::is_nothrow_move_constructible_v<gen>);
+  STATIC_CHECK(sizeof(gen) == sizeof(void *));
+}
+
+TEST_CASE("raii::generator yields values lazily", "[generator]")
+{
+  CHECK(collect(iota(0, 5)) == std::vector{ 0, 1, 2, 3, 4 });
+  CHECK(collect(iota(3, 3)).empty());
+  CHECK(collect(words()) == std::vector<std::string>{ "hello", "world" });
+
+  auto gen = iota(0, 1'000'000);
+  auto iter = gen.begin();
+  CHECK(*iter == 0);
+  ++iter;
+  CHECK(*iter == 1);
+}
+
+TEST_CASE("raii::generator composes with range adaptors", "[generator]")
+{
+  auto evens = iota(0, 10) | std::views::filter([](int val) { return val % 2 == 0; })
+               | std::views::transform([](int val) { return val * val; });
+  CHECK(collect(evens) == std::vector{ 0, 4, 16, 36, 64 });
+}
+
+TEST_CASE("raii::generator yields elements of nested generators", "[generator][elements_of]")
+{
+  const Node tree{ 1, { Node{ 2, { Node{ 3, {} }, Node{ 4, {} } } }, Node{ 5, {} } } };
+  CHECK(collect(traverse(tree)) == std::vector{ 1, 2, 3, 4, 5 });
+
+  constexpr int depth = 10'000;
+  int expected = depth;
+  for (const int val : countdown(depth)) { CHECK(val == expected--); }
+  CHECK(expected == 0);
+}
+
+TEST_CASE("raii::generator yields elements of arbitrary ranges", "[generator][elements_of]")
+{
+  auto gen = []() -> raii::generator<int> {
+    co_yield raii::elements_of(std::array{ 1, 2 });
+    const std::vector<int> tail{ 3, 4 };
+    co_yield raii::elements_of(tail);
+    co_yield raii::elements_of(std::views::iota(5, 7));
+  }();
+  CHECK(collect(gen) == std::vector{ 1, 2, 3, 4, 5, 6 });
+}
+
+TEST_CASE("raii::generator propagates exceptions", "[generator][exceptions]")
+{
+  auto gen = throwing_after(2);
+  auto iter = gen.begin();
+  CHECK(*iter == 0);
+  ++iter;
+  CHECK(*iter == 1);
+  CHECK_THROWS_AS(++iter, std::runtime_error);
+
+  // Nested generator exceptions are rethrown inside the parent
+  CHECK(collect(catching(2)) == std::vector{ 0, 1, -1 });
+}
+
+TEST_CASE("raii::generator destroys unfinished frames", "[generator]")
+{
+  const auto before = raii::frame_pool_statistics();
+  {
+    auto gen = countdown(3);
+    auto iter = gen.begin();
+    ++iter;
+    CHECK(*iter == 2);
+  }
+  const auto after = raii::frame_pool_statistics();
+  CHECK(after.cached - before.cached == after.misses - before.misses);
+}
+
+TEST_CASE("raii::generator frames are allocated from memory resource", "[generator][pmr]")
+{
+  std::array<std::byte, bufferSize> buffer{};
+  std::pmr::monotonic_buffer_resource arena{ buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+
+  auto gen = iota_with(std::allocator_arg, std::pmr::polymorphic_allocator<>{ &arena }, 3);
+  CHECK(collect(gen) == std::vector{ 0, 1, 2 });
+}
+
+RAII_TEST_FRAME_ALLOCATION_END
@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "testsuite_temp_file.hpp"
+#include "urc/deleter_posix.hpp"
+#include "urc/io_context.hpp"
+#include "urc/task.hpp"
+#include "urc/when_all.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+
+namespace {
+constexpr std::array backends{ raii::io_backend::io_uring, raii::io_backend::thread_pool };
+
+std::span<const std::byte> bytes_of(const std::string &str) noexcept { return std::as_bytes(std::span{ str }); }
+
+std::string string_of(std::span<const std::byte> buf)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return { reinterpret_cast<const char *>(buf.data()), buf.size() };
+}
+
+raii::task<std::string> round_trip(raii::io_context &ctx, const char *path, const std::string &text)
+{
+  raii::unique_fd file = co_await ctx.openat(AT_FDCWD, path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  const std::size_t written = co_await ctx.write(file, bytes_of(text), 0);
+  CHECK(written == text.size());
+  co_await ctx.fsync(file);
+  co_await ctx.fsync(file, true);
+
+  std::array<std::byte, 64> buf{};
+  const std::size_t len = co_await ctx.read(file, buf, 0);
+  co_await ctx.close(std::move(file));
+  CHECK_FALSE(file);
+  co_return string_of(std::span{ buf }.first(len));
+}
+
+raii::task<std::uint8_t> read_byte(raii::io_context &ctx, raii::file_ref file, std::uint64_t offset)
+{
+  std::array<std::byte, 1> buf{};
+  const std::size_t len = co_await ctx.read(file, buf, offset);
+  CHECK(len == 1);
+  co_return static_cast<std::uint8_t>(buf[0]);
+}
+
+raii::task<std::size_t> read_all_bytes(raii::io_context &ctx, int fd, std::size_t count)
+{
+  std::vector<raii::task<std::uint8_t>> reads;
+  reads.reserve(count);
+  for (std::size_t i = 0; i != count; ++i) { reads.push_back(read_byte(ctx, fd, i)); }
+
+  std::size_t matching = 0;
+  std::size_t index = 0;
+  for (auto &read : co_await raii::when_all(std::move(reads))) {
+    if (co_await read == static_cast<std::uint8_t>(index++)) { ++matching; }
+  }
+  co_return matching;
+}
+}// namespace
+
+
+TEST_CASE("raii::unique_fd has the size of int and closes the descriptor", "[io_context]")
+{
+  STATIC_CHECK(sizeof(raii::unique_fd) == sizeof(int));
+
+  std::array<int, 2> fds{};
+  REQUIRE(::pipe(fds.data()) == 0);
+  {
+    const raii::unique_fd read_end{ fds[0] };
+    const raii::unique_fd write_end{ fds[1] };
+    CHECK(::fcntl(read_end.get(), F_GETFD) != -1);
+  }
+  CHECK(::fcntl(fds[0], F_GETFD) == -1);
+  CHECK(::fcntl(fds[1], F_GETFD) == -1);
+  CHECK_FALSE(raii::unique_fd{});
+}
+
+TEST_CASE("raii::io_context opens, writes, reads, syncs and closes files", "[io_context]")
+{
+  const raii_test::temp_file tmp;
+  for (const auto backend : backends) {
+    raii::io_context ctx{ 8, backend };
+    CHECK(ctx.run(round_trip(ctx, tmp.path(), "written asynchronously")) == "written asynchronously");
+    CHECK(ctx.in_flight() == 0);
+  }
+}
+
+TEST_CASE("raii::io_context reports failed operations as std::system_error", "[io_context]")
+{
+  for (const auto backend : backends) {
+    raii::io_context ctx{ 8, backend };
+    CHECK_THROWS_AS(ctx.run([](raii::io_context &io) -> raii::task<raii::unique_fd> {
+      co_return co_await io.openat(AT_FDCWD, "/nonexistent/urc", O_RDONLY);
+    }(ctx)),
+      std::system_error);
+    CHECK_THROWS_AS(ctx.run([](raii::io_context &io) -> raii::task<std::size_t> {
+      std::array<std::byte, 8> buf{};
+      co_return co_await io.read(-1, buf, 0);
+    }(ctx)),
+      std::system_error);
+  }
+}
+
+TEST_CASE("raii::io_context queues more operations than the rings hold", "[io_context]")
+{
+  constexpr std::size_t count = 200;
+  std::vector<std::byte> data(count);
+  for (std::size_t i = 0; i != count; ++i) { data[i] = static_cast<std::byte>(i); }
+  const raii_test::temp_file tmp{ data };
+
+  const raii::unique_fd file = tmp.open(O_RDONLY);
+  for (const auto backend : backends) {
+    raii::io_context ctx{ 4, backend };
+    CHECK(ctx.run(read_all_bytes(ctx, file.get(), count)) == count);
+  }
+}
+
+TEST_CASE("raii::io_context reads registered files into registered buffers", "[io_context]")
+{
+  const std::string text{ "fixed file, fixed buffer" };
+  const raii_test::temp_file tmp{ bytes_of(text) };
+
+  const raii::unique_fd file = tmp.open(O_RDONLY);
+  for (const auto backend : backends) {
+    raii::io_context ctx{ 8, backend };
+    std::array<std::byte, 64> storage{};
+    const std::array<std::span<std::byte>, 1> buffers{ storage };
+    const std::array fds{ file.get() };
+    ctx.register_buffers(buffers);
+    ctx.register_files(fds);
+
+    const std::size_t len = ctx.run([](raii::io_context &io, std::span<std::byte> buf) -> raii::task<std::size_t> {
+      co_return co_await io.read(raii::fixed_file{ 0 }, buf.subspan(4), 0, raii::fixed_buffer{ 0 });
+    }(ctx, storage));
+    CHECK(string_of(std::span{ storage }.subspan(4, len)) == text);
+
+    ctx.unregister_files();
+    ctx.unregister_buffers();
+  }
+}
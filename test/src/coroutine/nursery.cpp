@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/nursery.hpp"
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> alive_count{ 0 };
+
+struct Tracked
+{
+  Tracked() noexcept { ++alive_count; }
+  Tracked(const Tracked &) noexcept { ++alive_count; }
+  Tracked(Tracked &&) noexcept { ++alive_count; }
+  Tracked &operator=(const Tracked &) = default;
+  Tracked &operator=(Tracked &&) = default;
+  ~Tracked() { --alive_count; }
+};
+
+// Single threaded event, resumes the waiting coroutines in order, when it is opened
+class Gate
+{
+public:
+  [[nodiscard]] auto wait() noexcept
+  {
+    struct awaiter
+    {
+      Gate *gate;
+
+      static constexpr bool await_ready() noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> hnd) const { gate->waiters_.push_back(hnd); }
+      static constexpr void await_resume() noexcept {}
+    };
+    return awaiter{ this };
+  }
+
+  void open()
+  {
+    auto waiters = std::move(waiters_);
+    waiters_.clear();
+    for (const auto hnd : waiters) { hnd.resume(); }
+  }
+
+private:
+  std::vector<std::coroutine_handle<>> waiters_;
+};
+
+raii::task<> wait_for(Gate &gate, Tracked /*param*/, int &runs)
+{
+  co_await gate.wait();
+  ++runs;
+}
+
+raii::task<int> immediate(Tracked /*param*/, int &runs)
+{
+  ++runs;
+  co_return runs;
+}
+
+raii::task<> fail_after(Gate &gate)
+{
+  co_await gate.wait();
+  throw std::runtime_error{ "child failed" };
+}
+
+raii::task<bool> join_all(raii::nursery &scope)
+{
+  co_await scope.join();
+  co_return scope.empty();
+}
+
+raii::task<> hop(raii::thread_pool &pool, std::atomic<std::size_t> &counter, Tracked /*param*/)
+{
+  co_await pool.schedule();
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+raii::task<std::size_t> spawn_on_pool(raii::thread_pool &pool, std::atomic<std::size_t> &counter, std::size_t count)
+{
+  raii::nursery scope;
+  for (std::size_t i = 0; i != count; ++i) { scope.spawn(hop(pool, counter, Tracked{})); }
+  co_await scope.join();
+  co_return counter.load(std::memory_order_relaxed);
+}
+
+constexpr std::size_t taskCount = 1'000;
+}// namespace
+
+
+TEST_CASE("raii::nursery starts children eagerly and destroys them, when they complete", "[nursery]")
+{
+  int runs = 0;
+  {
+    raii::nursery scope;
+    CHECK(scope.empty());
+    scope.spawn(immediate(Tracked{}, runs));
+    scope.spawn(immediate(Tracked{}, runs));
+    CHECK(runs == 2);
+    CHECK(scope.empty());
+    CHECK(alive_count == 0);
+  }
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::nursery::join waits for all children", "[nursery]")
+{
+  Gate gate;
+  int runs = 0;
+  raii::nursery scope;
+  for (int i = 0; i < 5; ++i) { scope.spawn(wait_for(gate, Tracked{}, runs)); }
+  CHECK(scope.size() == 5);
+  CHECK(alive_count == 5);
+
+  auto joiner = join_all(scope);
+  // The joiner only completes, when the last child does, sync_wait would block the only thread running the gate
+  bool joined = false;
+  auto observe = [](raii::task<bool> &awaited, bool &res) -> raii::task<> { res = co_await awaited; };
+  raii::nursery outer;
+  outer.spawn(observe(joiner, joined));
+  CHECK_FALSE(joined);
+
+  gate.open();
+  CHECK(runs == 5);
+  CHECK(joined);
+  CHECK(scope.empty());
+  CHECK(outer.empty());
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::nursery destroys the children still running, when it goes out of scope", "[nursery]")
+{
+  Gate gate;
+  int runs = 0;
+  {
+    raii::nursery scope;
+    for (std::size_t i = 0; i != taskCount; ++i) { scope.spawn(wait_for(gate, Tracked{}, runs)); }
+    CHECK(alive_count == static_cast<int>(taskCount));
+  }
+  CHECK(alive_count == 0);
+  CHECK(runs == 0);
+}
+
+TEST_CASE("raii::nursery unlinks children completing in any order", "[nursery]")
+{
+  Gate first;
+  Gate second;
+  int runs = 0;
+  raii::nursery scope;
+  scope.spawn(wait_for(first, Tracked{}, runs));
+  scope.spawn(wait_for(second, Tracked{}, runs));
+  scope.spawn(wait_for(first, Tracked{}, runs));
+  scope.spawn(wait_for(second, Tracked{}, runs));
+  scope.spawn(immediate(Tracked{}, runs));
+
+  second.open();
+  CHECK(runs == 3);
+  CHECK(scope.size() == 2);
+  CHECK(alive_count == 2);
+  first.open();
+  CHECK(runs == 5);
+  CHECK(scope.empty());
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::nursery::join rethrows the first exception of a child", "[nursery]")
+{
+  Gate gate;
+  raii::nursery scope;
+  scope.spawn(fail_after(gate));
+  scope.spawn(fail_after(gate));
+  gate.open();
+  CHECK(scope.empty());
+  CHECK_THROWS_AS(raii::sync_wait(join_all(scope)), std::runtime_error);
+  // The exception is reported once
+  CHECK(raii::sync_wait(join_all(scope)));
+}
+
+TEST_CASE("raii::nursery joins children completing on worker threads", "[nursery][thread_pool]")
+{
+  raii::thread_pool pool{ 4 };
+  std::atomic<std::size_t> counter{ 0 };
+  CHECK(raii::sync_wait(spawn_on_pool(pool, counter, taskCount)) == taskCount);
+  CHECK(alive_count == 0);
+}
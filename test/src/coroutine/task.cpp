@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/task.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int alive_count = 0;
+
+struct Tracked
+{
+  Tracked() noexcept { ++alive_count; }
+  Tracked(const Tracked &) noexcept { ++alive_count; }
+  Tracked(Tracked &&) noexcept { ++alive_count; }
+  Tracked &operator=(const Tracked &) = default;
+  Tracked &operator=(Tracked &&) = default;
+  ~Tracked() { --alive_count; }
+};
+
+raii::task<int> answer() { co_return 42; }
+
+raii::task<std::string> greet(std::string name)
+{
+  const int value = co_await answer();
+  co_return name + ' ' + std::to_string(value);
+}
+
+raii::task<> fail() { throw std::runtime_error("task failed"); co_return; }
+
+raii::task<int> chain(int depth)
+{
+  if (depth == 0) { co_return 0; }
+  co_return co_await chain(depth - 1) + 1;
+}
+
+raii::task<int &> select(int &value) { co_return value; }
+
+raii::task<std::unique_ptr<int>> make_owned(int value) { co_return std::make_unique<int>(value); }
+
+raii::task<int> holds_local()
+{
+  const Tracked local;
+  co_return 1;
+}
+}// namespace
+
+
+TEST_CASE("raii::task owns its frame", "[task][requirements]")
+{
+  STATIC_CHECK(sizeof(raii::task<int>) == sizeof(void *));
+  STATIC_CHECK_FALSE(std::is_copy_constructible_v<raii::task<int>>);
+  STATIC_CHECK(std::is_nothrow_move_constructible_v<raii::task<int>>);
+
+  alive_count = 0;
+  {
+    // Never started, the frame holds the parameter only
+    const auto dropped = holds_local();
+    CHECK(alive_count == 0);
+  }
+  CHECK(raii::sync_wait(holds_local()) == 1);
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::task is started lazily", "[task]")
+{
+  bool started = false;
+  auto lazy = [](bool &flag) -> raii::task<> {
+    flag = true;
+    co_return;
+  }(started);
+  CHECK_FALSE(started);
+  CHECK_FALSE(lazy.done());
+
+  raii::sync_wait(std::move(lazy));
+  CHECK(started);
+}
+
+TEST_CASE("raii::sync_wait returns the result of a task", "[task][sync_wait]")
+{
+  CHECK(raii::sync_wait(answer()) == 42);
+  CHECK(raii::sync_wait(greet("answer")) == "answer 42");
+  CHECK(*raii::sync_wait(make_owned(7)) == 7);
+
+  int value = 1;
+  int &ref = raii::sync_wait(select(value));
+  CHECK(&ref == &value);
+}
+
+TEST_CASE("raii::task propagates exceptions to the awaiter", "[task][exceptions]")
+{
+  CHECK_THROWS_AS(raii::sync_wait(fail()), std::runtime_error);
+
+  auto caught = []() -> raii::task<bool> {
+    try {
+      co_await fail();
+    } catch (const std::runtime_error &) {
+      co_return true;
+    }
+    co_return false;
+  };
+  CHECK(raii::sync_wait(caught()));
+}
+
+TEST_CASE("raii::task awaited as lvalue keeps its result", "[task]")
+{
+  auto outer = []() -> raii::task<std::size_t> {
+    auto inner = greet("lvalue");
+    const std::string &first = co_await inner;
+    CHECK(inner.done());
+    co_return first.size();
+  };
+  CHECK(raii::sync_wait(outer()) == std::string{ "lvalue 42" }.size());
+}
+
+TEST_CASE("raii::task resumes deep await chains by symmetric transfer", "[task]")
+{
+  // GCC emits symmetric transfer as a tail call only when optimising, the depth fits the stack of debug builds
+  constexpr int depth = 10'000;
+  CHECK(raii::sync_wait(chain(depth)) == depth);
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <latch>
+#include <thread>
+#include <vector>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> alive_count{ 0 };
+
+struct Tracked
+{
+  Tracked() noexcept { ++alive_count; }
+  Tracked(const Tracked &) noexcept { ++alive_count; }
+  Tracked(Tracked &&) noexcept { ++alive_count; }
+  Tracked &operator=(const Tracked &) = default;
+  Tracked &operator=(Tracked &&) = default;
+  ~Tracked() { --alive_count; }
+};
+
+raii::task<std::thread::id> current_thread(raii::thread_pool &pool)
+{
+  co_await pool.schedule();
+  co_return std::this_thread::get_id();
+}
+
+raii::task<> hop(raii::thread_pool &pool, std::atomic<std::size_t> &counter, std::latch &done, int hops)
+{
+  for (int i = 0; i < hops; ++i) {
+    co_await pool.schedule();
+    counter.fetch_add(1, std::memory_order_relaxed);
+  }
+  done.count_down();
+}
+
+raii::task<> block_until_stopped(const raii::thread_pool &pool, std::latch &started)
+{
+  started.count_down();
+  while (!pool.stop_requested()) { std::this_thread::yield(); }
+  co_return;
+}
+
+raii::task<> count_run(Tracked /*param*/, std::atomic<int> &runs)
+{
+  runs.fetch_add(1, std::memory_order_relaxed);
+  co_return;
+}
+
+raii::task<std::size_t> fan_out(raii::thread_pool &pool, std::size_t width)
+{
+  std::vector<raii::task<std::thread::id>> children;
+  children.reserve(width);
+  for (std::size_t i = 0; i != width; ++i) { children.push_back(current_thread(pool)); }
+
+  std::size_t count = 0;
+  for (auto &child : children) {
+    static_cast<void>(co_await child);
+    ++count;
+  }
+  co_return count;
+}
+
+constexpr std::size_t taskCount = 1'000;
+constexpr int hopCount = 10;
+}// namespace
+
+
+TEST_CASE("raii::thread_pool resumes coroutines on worker threads", "[thread_pool]")
+{
+  raii::thread_pool pool{ 2 };
+  CHECK(pool.thread_count() == 2);
+  CHECK(raii::sync_wait(current_thread(pool)) != std::this_thread::get_id());
+  CHECK(raii::sync_wait(fan_out(pool, taskCount)) == taskCount);
+}
+
+TEST_CASE("raii::thread_pool runs spawned tasks", "[thread_pool][spawn]")
+{
+  std::atomic<std::size_t> counter{ 0 };
+  std::latch done{ static_cast<std::ptrdiff_t>(taskCount) };
+  {
+    raii::thread_pool pool{ 4 };
+    for (std::size_t i = 0; i != taskCount; ++i) { pool.spawn(hop(pool, counter, done, hopCount)); }
+    done.wait();
+  }
+  CHECK(counter == taskCount * hopCount);
+}
+
+TEST_CASE("raii::thread_pool destroys queued tasks on shutdown exactly once", "[thread_pool][spawn]")
+{
+  alive_count = 0;
+  std::atomic<int> runs{ 0 };
+  {
+    raii::thread_pool pool{ 1 };
+    std::latch started{ 1 };
+    pool.spawn(block_until_stopped(pool, started));
+    started.wait();
+
+    // The only worker is busy, these stay queued until the pool is destroyed
+    for (std::size_t i = 0; i != taskCount; ++i) { pool.spawn(count_run(Tracked{}, runs)); }
+    CHECK(alive_count == static_cast<int>(taskCount));
+  }
+  CHECK(runs == 0);
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::thread_pool idle workers pick up new work", "[thread_pool]")
+{
+  raii::thread_pool pool{ 2 };
+  for (int round = 0; round < 10; ++round) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    CHECK(raii::sync_wait(current_thread(pool)) != std::this_thread::get_id());
+  }
+}
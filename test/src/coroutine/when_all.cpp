@@ -0,0 +1,186 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/frame_allocator.hpp"
+#include "urc/task.hpp"
+#include "urc/thread_pool.hpp"
+#include "urc/when_all.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>// std::move
+#include <variant>
+#include <vector>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> alive_count{ 0 };
+
+struct Tracked
+{
+  Tracked() noexcept { ++alive_count; }
+  Tracked(const Tracked &) noexcept { ++alive_count; }
+  Tracked(Tracked &&) noexcept { ++alive_count; }
+  Tracked &operator=(const Tracked &) = default;
+  Tracked &operator=(Tracked &&) = default;
+  ~Tracked() { --alive_count; }
+};
+
+// Suspends until resumed by hand
+struct Gate
+{
+  std::coroutine_handle<> waiting;
+
+  [[nodiscard]] auto wait() noexcept
+  {
+    struct awaiter
+    {
+      Gate *gate;
+
+      static constexpr bool await_ready() noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> hnd) const noexcept { gate->waiting = hnd; }
+      static constexpr void await_resume() noexcept {}
+    };
+    return awaiter{ this };
+  }
+
+  void open() { std::exchange(waiting, nullptr).resume(); }
+};
+
+raii::task<int> value(int val) { co_return val; }
+
+raii::task<std::string> text(const char *val) { co_return val; }
+
+raii::task<> nothing() { co_return; }
+
+raii::task<int> throwing()
+{
+  throw std::runtime_error{ "failed" };
+  co_return 0;
+}
+
+raii::task<int> gated(Gate &gate, int val, Tracked /*param*/)
+{
+  co_await gate.wait();
+  co_return val;
+}
+
+raii::task<int> scheduled(raii::thread_pool &pool, int val)
+{
+  co_await pool.schedule();
+  co_return val;
+}
+
+raii::task<int> sum_all(raii::thread_pool &pool, int count)
+{
+  std::vector<raii::task<int>> children;
+  children.reserve(static_cast<std::size_t>(count));
+  for (int i = 0; i < count; ++i) { children.push_back(scheduled(pool, i)); }
+
+  int res = 0;
+  for (auto &child : co_await raii::when_all(std::move(children))) { res += co_await child; }
+  co_return res;
+}
+
+raii::task<std::size_t> first_of(raii::thread_pool &pool, int count)
+{
+  std::vector<raii::task<int>> children;
+  children.reserve(static_cast<std::size_t>(count));
+  for (int i = 0; i < count; ++i) { children.push_back(scheduled(pool, i)); }
+  const auto res = co_await raii::when_any(std::move(children));
+  co_return res.index;
+}
+}// namespace
+
+
+TEST_CASE("raii::when_all returns the results of all tasks", "[when_all]")
+{
+  const auto res = raii::sync_wait([]() -> raii::task<std::tuple<int, std::string>> {
+    auto [num, str, none] = co_await raii::when_all(value(1), text("two"), nothing());
+    STATIC_CHECK(std::is_same_v<decltype(none), std::monostate>);
+    co_return std::tuple{ num, str };
+  }());
+  CHECK(res == std::tuple{ 1, std::string{ "two" } });
+}
+
+TEST_CASE("raii::when_all rethrows the first exception after all tasks have completed", "[when_all]")
+{
+  alive_count = 0;
+  Gate gate;
+  auto parent = [](Gate &gte) -> raii::task<int> {
+    auto [first, second] = co_await raii::when_all(throwing(), gated(gte, 2, Tracked{}));
+    co_return first + second;
+  }(gate);
+
+  bool finished = false;
+  auto waiter = [](raii::task<int> awaited, bool &done) -> raii::task<> {
+    CHECK_THROWS_AS(co_await std::move(awaited), std::runtime_error);
+    done = true;
+  }(std::move(parent), finished);
+
+  waiter.get().resume();
+  CHECK_FALSE(finished);
+  // The parameter in the frame and the temporary argument, which lives until the co_await completes
+  CHECK(alive_count == 2);
+  gate.open();
+  CHECK(finished);
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::when_all of a range resumes the parent after the last task", "[when_all][threads]")
+{
+  raii::thread_pool pool{ 4 };
+  CHECK(raii::sync_wait(sum_all(pool, 100)) == 4950);
+  CHECK(raii::sync_wait(sum_all(pool, 0)) == 0);
+}
+
+TEST_CASE("raii::when_all allocates nothing beyond the task frames", "[when_all]")
+{
+  constexpr int count = 8;
+  std::vector<raii::task<int>> children;
+  for (int i = 0; i < count; ++i) { children.push_back(value(i)); }
+
+  const auto before = raii::frame_pool_statistics();
+  raii::sync_wait([](std::vector<raii::task<int>> &tasks) -> raii::task<> {
+    co_await raii::when_all(tasks);
+    for (auto &child : tasks) { CHECK(child.done()); }
+  }(children));
+  const auto after = raii::frame_pool_statistics();
+
+  // The lambda coroutine and the sync_wait driver
+  CHECK((after.hits + after.misses) - (before.hits + before.misses) == 2);
+}
+
+TEST_CASE("raii::when_any returns the first task to complete", "[when_any]")
+{
+  alive_count = 0;
+  Gate slow;
+  auto res = raii::sync_wait([](Gate &gate) -> raii::task<std::variant<int, int, std::monostate>> {
+    co_return co_await raii::when_any(gated(gate, 1, Tracked{}), value(2), nothing());
+  }(slow));
+  CHECK(res.index() == 1);
+  CHECK(std::get<1>(res) == 2);
+
+  // The running loser owns its frame now, the one, which was not started, is gone
+  CHECK(alive_count == 1);
+  slow.open();
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::when_any rethrows the exception of the first task", "[when_any]")
+{
+  CHECK_THROWS_AS(raii::sync_wait([]() -> raii::task<> { co_await raii::when_any(throwing(), value(1)); }()),
+    std::runtime_error);
+}
+
+TEST_CASE("raii::when_any of a range destroys every loser exactly once", "[when_any][threads]")
+{
+  raii::thread_pool pool{ 4 };
+  for (int round = 0; round < 20; ++round) { CHECK(raii::sync_wait(first_of(pool, 16)) < 16); }
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/aligned_delete.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int alive_count = 0;
+
+struct Counter
+{
+  Counter() { ++alive_count; }
+  explicit Counter(int init) : value{ init } { ++alive_count; }
+
+  Counter(const Counter &) = delete;
+  Counter(Counter &&) = delete;
+  Counter &operator=(const Counter &) = delete;
+  Counter &operator=(Counter &&) = delete;
+
+  ~Counter() { --alive_count; }
+
+  int value{};
+};
+
+struct Throwing
+{
+  Throwing() { throw std::runtime_error("Throwing construction failed"); }
+};
+
+constexpr std::size_t avx512_alignment = 64;
+constexpr std::size_t page_alignment = 4096;
+constexpr std::size_t constArraySize = 100;
+
+bool is_aligned(const void *ptr, std::size_t align)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return (reinterpret_cast<std::uintptr_t>(ptr) % align) == 0;
+}
+}// namespace
+
+
+TEST_CASE("unique_aligned_ptr keeps the size of a pointer", "[aligned_delete][layout]")
+{
+  STATIC_CHECK(std::is_empty_v<raii::aligned_delete<int, avx512_alignment>>);
+  STATIC_CHECK(sizeof(raii::unique_aligned_ptr<int>) == sizeof(int *));
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  STATIC_CHECK(sizeof(raii::unique_aligned_ptr<float[], page_alignment>) == sizeof(float *));
+
+  STATIC_CHECK(raii::valid_alignment_for<int, 64>);
+  STATIC_CHECK_FALSE(raii::valid_alignment_for<int, 48>);
+  STATIC_CHECK_FALSE(raii::valid_alignment_for<std::uint64_t, 4>);
+}
+
+TEST_CASE("raii::make_unique_aligned single object", "[aligned_delete][make_unique_aligned]")
+{
+  alive_count = 0;
+  {
+    const auto counter = raii::make_unique_aligned<Counter>(3);
+    CHECK(alive_count == 1);
+    CHECK(counter->value == 3);
+    CHECK(is_aligned(counter.get(), raii::cache_line_size));
+
+    const auto page = raii::make_unique_aligned<Counter, page_alignment>();
+    CHECK(alive_count == 2);
+    CHECK(page->value == 0);
+    CHECK(is_aligned(page.get(), page_alignment));
+  }
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::make_unique_aligned array", "[aligned_delete][make_unique_aligned]")
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  const auto buffer = raii::make_unique_aligned<float[], avx512_alignment>(constArraySize);
+  REQUIRE(buffer);
+  CHECK(is_aligned(buffer.get(), avx512_alignment));
+
+  const std::span<float> view{ buffer.get(), constArraySize };
+  CHECK(std::ranges::all_of(view, [](float val) { return val == 0.0F; }));
+}
+
+TEST_CASE("raii::make_unique_aligned_for_overwrite", "[aligned_delete][make_unique_aligned]")
+{
+  auto value = raii::make_unique_aligned_for_overwrite<std::uint64_t>();
+  CHECK(is_aligned(value.get(), raii::cache_line_size));
+  *value = 1;
+  CHECK(*value == 1);
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  auto buffer = raii::make_unique_aligned_for_overwrite<double[], page_alignment>(constArraySize);
+  CHECK(is_aligned(buffer.get(), page_alignment));
+  buffer[constArraySize - 1] = 2.0;
+  CHECK(buffer[constArraySize - 1] == 2.0);
+}
+
+TEST_CASE("raii::make_unique_aligned releases memory if constructor throws", "[aligned_delete][make_unique_aligned]")
+{
+  REQUIRE_THROWS_AS(raii::make_unique_aligned<Throwing>(), std::runtime_error);
+}
@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/allocate_unique.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+int alive_count = 0;
+int allocation_count = 0;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+struct Node
+{
+  Node() { ++alive_count; }
+  explicit Node(int init) : value{ init } { ++alive_count; }
+
+  Node(const Node &) = delete;
+  Node(Node &&) = delete;
+  Node &operator=(const Node &) = delete;
+  Node &operator=(Node &&) = delete;
+
+  ~Node() { --alive_count; }
+
+  int value{};
+};
+
+struct Throwing
+{
+  Throwing() { throw std::runtime_error("Throwing construction failed"); }
+};
+
+// Stateless allocator, which counts outstanding allocations
+template<typename T> struct counting_allocator
+{
+  using value_type = T;
+
+  counting_allocator() = default;
+
+  template<typename U>
+  // NOLINTNEXTLINE(hicpp-explicit-conversions)
+  constexpr counting_allocator(const counting_allocator<U> & /*src*/) noexcept
+  {}
+
+  T *allocate(std::size_t size)
+  {
+    ++allocation_count;
+    return std::allocator<T>{}.allocate(size);
+  }
+
+  void deallocate(T *ptr, std::size_t size) noexcept
+  {
+    --allocation_count;
+    std::allocator<T>{}.deallocate(ptr, size);
+  }
+
+  friend bool operator==(counting_allocator /*lhs*/, counting_allocator /*rhs*/) noexcept { return true; }
+};
+
+// Uses-allocator construction aware type, receives the allocator from polymorphic_allocator::construct
+struct Request
+{
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
+  explicit Request(int init, const allocator_type &alloc) : values(3, init, alloc) {}
+
+  std::pmr::vector<int> values;
+};
+
+constexpr std::size_t constArraySize = 4;
+constexpr std::size_t bufferSize = 1024;
+}// namespace
+
+
+TEST_CASE("allocator_delete stores stateless allocator for free", "[allocate_unique][layout]")
+{
+  STATIC_CHECK(std::is_empty_v<raii::allocator_delete<int, std::allocator<int>>>);
+  STATIC_CHECK(sizeof(raii::allocated_unique_ptr<int, std::allocator<int>>) == sizeof(int *));
+  STATIC_CHECK(sizeof(raii::allocated_unique_ptr<int, counting_allocator<char>>) == sizeof(int *));
+  STATIC_CHECK(sizeof(raii::allocated_unique_ptr<int, std::pmr::polymorphic_allocator<>>)
+               == sizeof(int *) + sizeof(std::pmr::memory_resource *));
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  STATIC_CHECK(sizeof(raii::allocated_unique_ptr<int[], std::allocator<int>>) == sizeof(int *) + sizeof(std::size_t));
+}
+
+TEST_CASE("raii::allocate_unique with stateless allocator", "[allocate_unique]")
+{
+  alive_count = 0;
+  allocation_count = 0;
+  {
+    const auto node = raii::allocate_unique<Node>(counting_allocator<Node>{}, 5);
+    CHECK(node->value == 5);
+    CHECK(alive_count == 1);
+    CHECK(allocation_count == 1);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+    auto nodes = raii::allocate_unique<Node[]>(counting_allocator<char>{}, constArraySize);
+    CHECK(nodes.get_deleter().size() == constArraySize);
+    CHECK(alive_count == 1 + static_cast<int>(constArraySize));
+    CHECK(allocation_count == 2);
+
+    nodes.reset();
+    CHECK(alive_count == 1);
+    CHECK(allocation_count == 1);
+  }
+  CHECK(alive_count == 0);
+  CHECK(allocation_count == 0);
+}
+
+TEST_CASE("raii::allocate_unique_for_overwrite", "[allocate_unique]")
+{
+  allocation_count = 0;
+  {
+    auto value = raii::allocate_unique_for_overwrite<int>(counting_allocator<int>{});
+    *value = 1;
+    CHECK(*value == 1);
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+    auto buffer = raii::allocate_unique_for_overwrite<int[]>(counting_allocator<int>{}, constArraySize);
+    buffer[constArraySize - 1] = 2;
+    CHECK(buffer[constArraySize - 1] == 2);
+    CHECK(allocation_count == 2);
+  }
+  CHECK(allocation_count == 0);
+}
+
+TEST_CASE("raii::allocate_unique releases memory if constructor throws", "[allocate_unique]")
+{
+  allocation_count = 0;
+
+  REQUIRE_THROWS_AS(raii::allocate_unique<Throwing>(counting_allocator<Throwing>{}), std::runtime_error);
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  REQUIRE_THROWS_AS(raii::allocate_unique<Throwing[]>(counting_allocator<Throwing>{}, 2), std::runtime_error);
+  CHECK(allocation_count == 0);
+}
+
+TEST_CASE("raii::allocate_unique with monotonic_buffer_resource", "[allocate_unique][pmr]")
+{
+  alive_count = 0;
+  std::array<std::byte, bufferSize> buffer{};
+  std::pmr::monotonic_buffer_resource arena{ buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+  const std::pmr::polymorphic_allocator<> alloc{ &arena };
+  {
+    auto node = raii::allocate_unique<Node>(alloc, 7);
+    CHECK(node->value == 7);
+    CHECK(alive_count == 1);
+    CHECK(static_cast<void *>(node.get()) >= static_cast<void *>(buffer.data()));
+    CHECK(node.get_deleter().get_allocator().resource() == &arena);
+
+    // Uses-allocator construction passes the arena down to the members
+    const auto request = raii::allocate_unique<Request>(alloc, 9);
+    CHECK(request->values.size() == 3);
+    CHECK(request->values.get_allocator().resource() == &arena);
+
+    // Move assignment works even though polymorphic_allocator is not assignable
+    auto other = raii::allocate_unique<Node>(alloc, 8);
+    node = std::move(other);
+    CHECK(node->value == 8);
+    CHECK(alive_count == 1);
+  }
+  CHECK(alive_count == 0);
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int alive_count = 0;
+
+struct Token
+{
+  Token() { ++alive_count; }
+  Token(int init_kind, std::string init_text) : kind{ init_kind }, text{ std::move(init_text) } { ++alive_count; }
+
+  Token(const Token &) = delete;
+  Token(Token &&) = delete;
+  Token &operator=(const Token &) = delete;
+  Token &operator=(Token &&) = delete;
+
+  ~Token() { --alive_count; }
+
+  int kind{};
+  std::string text;
+};
+
+struct alignas(64) CacheLine
+{
+  std::uint64_t value;
+};
+
+constexpr std::size_t smallChunk = 256;
+constexpr std::size_t tokenCount = 100;
+
+bool is_aligned(const void *ptr, std::size_t align)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return (reinterpret_cast<std::uintptr_t>(ptr) % align) == 0;
+}
+}// namespace
+
+
+TEST_CASE("arena_unique_ptr has the size of a pointer", "[arena][layout]")
+{
+  STATIC_CHECK(std::is_empty_v<raii::arena_delete<Token>>);
+  STATIC_CHECK(sizeof(raii::arena_unique_ptr<Token>) == sizeof(Token *));
+
+  STATIC_CHECK(raii::accepts_invalid_handle_v<raii::arena_delete<int>>);
+  STATIC_CHECK_FALSE(raii::accepts_invalid_handle_v<raii::arena_delete<Token>>);
+}
+
+TEST_CASE("arena hands out aligned memory from chunks", "[arena]")
+{
+  raii::arena mem{ smallChunk };
+  CHECK(mem.chunk_count() == 0);
+  CHECK(mem.available() == 0);
+
+  const void *first = mem.allocate(1, 1);
+  CHECK(mem.chunk_count() == 1);
+
+  const void *line = mem.allocate(sizeof(CacheLine), alignof(CacheLine));
+  CHECK(is_aligned(line, alignof(CacheLine)));
+  CHECK(first != line);
+
+  // Larger than a chunk, gets a dedicated one
+  const void *big = mem.allocate(smallChunk * 4);
+  CHECK(big != nullptr);
+  CHECK(mem.chunk_count() == 2);
+
+  mem.reset();
+  CHECK(mem.chunk_count() == 1);
+  CHECK(mem.available() >= smallChunk * 4);
+
+  mem.release();
+  CHECK(mem.chunk_count() == 0);
+}
+
+TEST_CASE("raii::make_arena_unique runs destructors only", "[arena][make_arena_unique]")
+{
+  alive_count = 0;
+  raii::arena mem{ smallChunk };
+  {
+    std::vector<raii::arena_unique_ptr<Token>> tokens;
+    for (std::size_t i = 0; i < tokenCount; ++i) {
+      tokens.push_back(raii::make_arena_unique<Token>(mem, static_cast<int>(i), "a long enough token text"));
+    }
+    CHECK(alive_count == static_cast<int>(tokenCount));
+    CHECK(tokens.back()->kind == static_cast<int>(tokenCount - 1));
+    CHECK(mem.chunk_count() > 1);
+
+    tokens.front().reset();
+    CHECK(alive_count == static_cast<int>(tokenCount - 1));
+
+    const raii::arena_unique_ptr<Token> moved{ std::move(tokens.back()) };
+    CHECK(moved->kind == static_cast<int>(tokenCount - 1));
+  }
+  CHECK(alive_count == 0);
+
+  mem.reset();
+  const auto token = raii::make_arena_unique_for_overwrite<Token>(mem);
+  CHECK(alive_count == 1);
+}
+
+TEST_CASE("raii::make_arena_unique array", "[arena][make_arena_unique]")
+{
+  raii::arena mem;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  const auto values = raii::make_arena_unique<CacheLine[]>(mem, 3);
+  CHECK(is_aligned(values.get(), alignof(CacheLine)));
+  CHECK(values[2].value == 0);
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  auto buffer = raii::make_arena_unique_for_overwrite<char[]>(mem, tokenCount);
+  buffer[tokenCount - 1] = 'x';
+  CHECK(buffer[tokenCount - 1] == 'x');
+}
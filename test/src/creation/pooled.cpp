@@ -0,0 +1,176 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/pool_delete.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> alive_count{ 0 };
+
+// Each test case uses its own message type, so that it starts with a fresh pool
+template<int Tag> struct Message
+{
+  Message() { ++alive_count; }
+  explicit Message(std::uint64_t init) : id{ init } { ++alive_count; }
+
+  Message(const Message &) = delete;
+  Message(Message &&) = delete;
+  Message &operator=(const Message &) = delete;
+  Message &operator=(Message &&) = delete;
+
+  ~Message() { --alive_count; }
+
+  std::uint64_t id{};
+  std::uint64_t payload[4]{};// NOLINT(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+};
+
+struct alignas(64) Aligned
+{
+  std::byte data[64];// NOLINT(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+};
+
+struct Throwing
+{
+  Throwing() { throw std::runtime_error("Throwing construction failed"); }
+};
+
+constexpr std::size_t messageCount = 100;
+}// namespace
+
+
+TEST_CASE("pooled_ptr has the size of a pointer", "[pool_delete][layout]")
+{
+  STATIC_CHECK(std::is_empty_v<raii::pool_delete<Message<0>>>);
+  STATIC_CHECK(sizeof(raii::pooled_ptr<Message<0>>) == sizeof(Message<0> *));
+}
+
+TEST_CASE("raii::make_pooled recycles blocks on the same thread", "[pool_delete][make_pooled]")
+{
+  using msg = Message<1>;
+  alive_count = 0;
+
+  const auto *first = raii::make_pooled<msg>(1U).get();
+  CHECK(alive_count == 0);
+
+  // The block freed above is handed out again
+  auto second = raii::make_pooled<msg>(2U);
+  CHECK(second.get() == first);
+  CHECK(second->id == 2);
+
+  const auto stats = raii::pool_statistics<msg>();
+  CHECK(stats.misses == 1);
+  CHECK(stats.hits == 1);
+  CHECK(stats.hit_rate() == 0.5);
+
+  second.reset();
+  CHECK(raii::pool_statistics<msg>().cached == 1);
+
+  raii::pool_trim<msg>();
+  CHECK(raii::pool_statistics<msg>().cached == 0);
+}
+
+TEST_CASE("raii::make_pooled in steady state never misses", "[pool_delete][make_pooled]")
+{
+  using msg = Message<2>;
+  alive_count = 0;
+
+  std::vector<raii::pooled_ptr<msg>> batch;
+  for (int round = 0; round < 10; ++round) {
+    for (std::size_t i = 0; i < messageCount; ++i) { batch.push_back(raii::make_pooled<msg>(i)); }
+    CHECK(alive_count == static_cast<int>(messageCount));
+    batch.clear();
+  }
+
+  const auto stats = raii::pool_statistics<msg>();
+  CHECK(stats.misses == messageCount);
+  CHECK(stats.hits == messageCount * 9);
+  CHECK(stats.cached == messageCount);
+}
+
+TEST_CASE("raii::make_pooled respects alignment", "[pool_delete][make_pooled]")
+{
+  const auto ptr = raii::make_pooled<Aligned>();
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  CHECK(reinterpret_cast<std::uintptr_t>(ptr.get()) % alignof(Aligned) == 0);
+}
+
+TEST_CASE("raii::make_pooled returns the block if constructor throws", "[pool_delete][make_pooled]")
+{
+  REQUIRE_THROWS_AS(raii::make_pooled<Throwing>(), std::runtime_error);
+  CHECK(raii::pool_statistics<Throwing>().cached == 1);
+}
+
+TEST_CASE("Objects freed on another thread return to the owner pool", "[pool_delete][threads]")
+{
+  using msg = Message<3>;
+  alive_count = 0;
+
+  std::vector<raii::pooled_ptr<msg>> batch;
+  for (std::size_t i = 0; i < messageCount; ++i) { batch.push_back(raii::make_pooled<msg>(i)); }
+
+  std::thread consumer{ [moved = std::move(batch)]() mutable { moved.clear(); } };
+  consumer.join();
+  CHECK(alive_count == 0);
+
+  // Remote frees are picked up once the local free list is empty
+  const auto again = raii::make_pooled<msg>(0U);
+  const auto stats = raii::pool_statistics<msg>();
+  CHECK(stats.remote_frees == messageCount);
+  CHECK(stats.misses == messageCount);
+  CHECK(stats.hits == 1);
+}
+
+TEST_CASE("Objects outlive the thread, which allocated them", "[pool_delete][threads]")
+{
+  using msg = Message<4>;
+  alive_count = 0;
+
+  std::vector<raii::pooled_ptr<msg>> orphans;
+  std::thread producer{ [&orphans] {
+    for (std::size_t i = 0; i < messageCount; ++i) { orphans.push_back(raii::make_pooled<msg>(i)); }
+    // Some blocks are cached by the exiting thread
+    orphans.resize(messageCount / 2);
+  } };
+  producer.join();
+  CHECK(alive_count == static_cast<int>(messageCount / 2));
+
+  // The producer's pool has been closed, the last orphan deletes it
+  orphans.clear();
+  CHECK(alive_count == 0);
+  CHECK(raii::pool_statistics<msg>().misses == 0);
+}
+
+TEST_CASE("Concurrent remote frees", "[pool_delete][threads]")
+{
+  using msg = Message<5>;
+  alive_count = 0;
+
+  constexpr int consumers = 4;
+  std::vector<std::vector<raii::pooled_ptr<msg>>> batches(consumers);
+  for (int round = 0; round < 5; ++round) {
+    for (auto &batch : batches) {
+      for (std::size_t i = 0; i < messageCount; ++i) { batch.push_back(raii::make_pooled<msg>(i)); }
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(consumers);
+    for (auto &batch : batches) {
+      threads.emplace_back([&batch] { batch.clear(); });
+    }
+    for (auto &thread : threads) { thread.join(); }
+    CHECK(alive_count == 0);
+  }
+
+  // Blocks freed in the last round are not drained until the next allocation
+  const auto stats = raii::pool_statistics<msg>();
+  CHECK(stats.misses == messageCount * consumers);
+  CHECK(stats.remote_frees == messageCount * consumers * 4);
+}
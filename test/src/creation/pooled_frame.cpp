@@ -0,0 +1,158 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "testsuite_frame_allocation.hpp"
+#include "urc/frame_allocator.hpp"
+#include "urc/unique_coroutine_handle.hpp"
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>// std::terminate
+#include <memory>// std::allocator_arg, std::allocator
+#include <memory_resource>
+#include <thread>
+#include <utility>
+#include <vector>
+
+RAII_TEST_FRAME_ALLOCATION_BEGIN
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int allocation_count = 0;
+
+// Lazily started coroutine, which stores the sum of its arguments
+struct Job
+{
+  struct promise_type : raii::pooled_frame_promise
+  {
+    Job get_return_object() noexcept { return Job{ handle::from_promise(*this) }; }
+    static std::suspend_always initial_suspend() noexcept { return {}; }
+    static std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(int res) noexcept { result = res; }
+    [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+
+    int result{};
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  explicit Job(handle hnd) noexcept : coro{ hnd } {}
+
+  int run()
+  {
+    coro.get().resume();
+    return coro.get().promise().result;
+  }
+
+  raii::unique_coroutine_handle<promise_type> coro;
+};
+
+Job add(int lhs, int rhs) { co_return lhs + rhs; }
+
+template<typename Alloc> Job add_with(std::allocator_arg_t /*tag*/, const Alloc & /*alloc*/, int lhs, int rhs)
+{
+  co_return lhs + rhs;
+}
+
+struct Calculator
+{
+  int base;
+
+  template<typename Alloc> Job add(std::allocator_arg_t /*tag*/, const Alloc & /*alloc*/, int value) const
+  {
+    co_return base + value;
+  }
+};
+
+// Stateless allocator, which counts outstanding allocations
+template<typename T> struct counting_allocator
+{
+  using value_type = T;
+
+  counting_allocator() = default;
+
+  template<typename U>
+  // NOLINTNEXTLINE(hicpp-explicit-conversions)
+  constexpr counting_allocator(const counting_allocator<U> & /*src*/) noexcept
+  {}
+
+  T *allocate(std::size_t size)
+  {
+    ++allocation_count;
+    return std::allocator<T>{}.allocate(size);
+  }
+
+  void deallocate(T *ptr, std::size_t size) noexcept
+  {
+    --allocation_count;
+    std::allocator<T>{}.deallocate(ptr, size);
+  }
+
+  friend bool operator==(counting_allocator /*lhs*/, counting_allocator /*rhs*/) noexcept { return true; }
+};
+
+constexpr std::size_t jobCount = 100;
+constexpr std::size_t bufferSize = 4096;
+}// namespace
+
+
+TEST_CASE("Coroutine frames are recycled by the thread pool", "[pooled_frame_promise]")
+{
+  const auto before = raii::frame_pool_statistics();
+
+  CHECK(add(1, 2).run() == 3);
+  for (int i = 0; i < 10; ++i) { CHECK(add(i, i).run() == 2 * i); }
+
+  const auto after = raii::frame_pool_statistics();
+  CHECK(after.misses - before.misses <= 1);
+  CHECK(after.hits - before.hits >= 10);
+}
+
+TEST_CASE("Coroutine frames are allocated by allocator passed via std::allocator_arg", "[pooled_frame_promise]")
+{
+  allocation_count = 0;
+  {
+    auto job = add_with(std::allocator_arg, counting_allocator<char>{}, 2, 3);
+    CHECK(allocation_count == 1);
+    CHECK(job.run() == 5);
+
+    const Calculator calc{ 10 };
+    auto member = calc.add(std::allocator_arg, counting_allocator<int>{}, 1);
+    CHECK(allocation_count == 2);
+    CHECK(member.run() == 11);
+  }
+  CHECK(allocation_count == 0);
+}
+
+TEST_CASE("Coroutine frames are allocated from memory resource", "[pooled_frame_promise][pmr]")
+{
+  std::array<std::byte, bufferSize> buffer{};
+  std::pmr::monotonic_buffer_resource arena{ buffer.data(), buffer.size(), std::pmr::null_memory_resource() };
+
+  auto job = add_with(std::allocator_arg, std::pmr::polymorphic_allocator<>{ &arena }, 4, 5);
+  const void *frame = job.coro.get().address();
+  CHECK(frame >= static_cast<const void *>(buffer.data()));
+  CHECK(frame < static_cast<const void *>(buffer.data() + buffer.size()));
+  CHECK(job.run() == 9);
+}
+
+TEST_CASE("Coroutine frames destroyed on another thread", "[pooled_frame_promise][threads]")
+{
+  std::vector<Job> jobs;
+  for (std::size_t i = 0; i < jobCount; ++i) { jobs.push_back(add(1, static_cast<int>(i))); }
+
+  std::thread consumer{ [moved = std::move(jobs)]() mutable {
+    for (auto &job : moved) { static_cast<void>(job.run()); }
+    moved.clear();
+  } };
+  consumer.join();
+
+  const auto before = raii::frame_pool_statistics();
+  CHECK(add(0, 0).run() == 0);
+  const auto after = raii::frame_pool_statistics();
+  CHECK(after.remote_frees - before.remote_frees == jobCount);
+  CHECK(after.misses == before.misses);
+}
+
+RAII_TEST_FRAME_ALLOCATION_END
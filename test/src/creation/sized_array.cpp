@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/unique_array.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+int alive_count = 0;
+int throw_at = -1;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+struct Tracked
+{
+  Tracked()
+  {
+    if (alive_count == throw_at) { throw std::runtime_error("Tracked construction failed"); }
+    ++alive_count;
+  }
+
+  Tracked(const Tracked &) = delete;
+  Tracked(Tracked &&) = delete;
+  Tracked &operator=(const Tracked &) = delete;
+  Tracked &operator=(Tracked &&) = delete;
+
+  ~Tracked() { --alive_count; }
+};
+
+constexpr std::size_t constArraySize = 5;
+
+constexpr int sum_of_iota(std::size_t count)
+{
+  auto arr = raii::make_unique_array<int>(count);
+  std::iota(arr.begin(), arr.end(), 1);
+  return std::accumulate(arr.begin(), arr.end(), 0);
+}
+}// namespace
+
+
+TEST_CASE("unique_array layout", "[unique_array][layout]")
+{
+  STATIC_CHECK(sizeof(raii::unique_array<int>) == sizeof(int *) + sizeof(std::size_t));
+  STATIC_CHECK(std::ranges::contiguous_range<raii::unique_array<int>>);
+  STATIC_CHECK(std::ranges::sized_range<raii::unique_array<int>>);
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_array<int>>);
+  STATIC_CHECK_FALSE(std::is_copy_constructible_v<raii::unique_array<int>>);
+}
+
+TEST_CASE("Default constructed unique_array is empty", "[unique_array][construction]")
+{
+  constexpr raii::unique_array<int> arr;
+
+  STATIC_CHECK_FALSE(arr);
+  STATIC_CHECK(arr == nullptr);
+  STATIC_CHECK(arr.empty());
+  STATIC_CHECK(arr.size() == 0);
+  STATIC_CHECK(arr.data() == nullptr);
+  STATIC_CHECK(arr.begin() == arr.end());
+}
+
+TEST_CASE("raii::make_unique_array value-initialises elements", "[unique_array][make_unique_array]")
+{
+  const auto arr = raii::make_unique_array<int>(constArraySize);
+  REQUIRE(arr);
+  CHECK(arr.size() == constArraySize);
+  CHECK(std::ranges::all_of(arr, [](int val) { return val == 0; }));
+
+  const auto filled = raii::make_unique_array<int>(constArraySize, 7);
+  CHECK(std::ranges::count(filled, 7) == static_cast<std::ptrdiff_t>(constArraySize));
+}
+
+TEST_CASE("raii::make_unique_array in constant expression", "[unique_array][make_unique_array]")
+{
+  STATIC_CHECK(sum_of_iota(4) == 10);
+  STATIC_CHECK(sum_of_iota(0) == 0);
+}
+
+TEST_CASE("raii::make_unique_array_for_overwrite", "[unique_array][make_unique_array]")
+{
+  auto arr = raii::make_unique_array_for_overwrite<int>(constArraySize);
+  REQUIRE(arr.size() == constArraySize);
+
+  for (std::size_t i = 0; i < arr.size(); ++i) { arr[i] = static_cast<int>(i); }
+  CHECK(arr[constArraySize - 1] == static_cast<int>(constArraySize - 1));
+}
+
+TEST_CASE("unique_array destroys every element", "[unique_array][destruction]")
+{
+  alive_count = 0;
+  throw_at = -1;
+  {
+    auto arr = raii::make_unique_array<Tracked>(constArraySize);
+    CHECK(alive_count == static_cast<int>(constArraySize));
+
+    arr.reset();
+    CHECK(alive_count == 0);
+    CHECK(arr.size() == 0);
+
+    arr = raii::make_unique_array<Tracked>(2);
+    CHECK(alive_count == 2);
+  }
+  CHECK(alive_count == 0);
+}
+
+TEST_CASE("raii::make_unique_array rolls back on exception", "[unique_array][make_unique_array]")
+{
+  alive_count = 0;
+  throw_at = 3;
+
+  REQUIRE_THROWS_AS(raii::make_unique_array<Tracked>(constArraySize), std::runtime_error);
+  CHECK(alive_count == 0);
+
+  throw_at = -1;
+}
+
+TEST_CASE("unique_array converts to std::span", "[unique_array][observers]")
+{
+  auto arr = raii::make_unique_array<int>(3, 1);
+
+  const std::span<int> view = arr;
+  view[1] = 2;
+  CHECK(arr[1] == 2);
+
+  const std::span<const int> cview = arr;
+  CHECK(cview.size() == 3);
+  CHECK(arr.as_span().data() == arr.data());
+}
+
+TEST_CASE("unique_array release and adopt keep the element count", "[unique_array][modifiers]")
+{
+  auto arr = raii::make_unique_array<int>(3, 4);
+  const auto *const data = arr.data();
+
+  const auto hnd = arr.release();
+  CHECK_FALSE(arr);
+  CHECK(arr.size() == 0);
+  CHECK(hnd.ptr == data);
+  CHECK(hnd.size == 3);
+
+  raii::unique_array<int> adopted{ hnd };
+  CHECK(adopted.size() == 3);
+
+  raii::unique_array<int> other;
+  swap(adopted, other);
+  CHECK_FALSE(adopted);
+  CHECK(other.size() == 3);
+
+  raii::unique_array<int> moved{ std::move(other) };
+  CHECK(moved.data() == data);
+  CHECK(std::ranges::distance(moved) == 3);
+}
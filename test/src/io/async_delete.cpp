@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/async_delete.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> released{ 0 };
+std::atomic<bool> gate_open{ true };
+std::thread::id releasing_thread;
+const std::thread::id test_thread = std::this_thread::get_id();
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Blocks the closer thread, while the gate is closed, like fclose on a slow file system
+struct slow_release
+{
+  void operator()(int *counter) const noexcept
+  {
+    while (std::this_thread::get_id() != test_thread && !gate_open.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+    releasing_thread = std::this_thread::get_id();
+    ++*counter;
+    released.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+}// namespace
+
+
+TEST_CASE("raii::async_delete keeps the size of the handle", "[async_delete][layout]")
+{
+  STATIC_CHECK(sizeof(raii::unique_rc<FILE *, raii::async_delete<raii::stdio_fclose>>) == sizeof(FILE *));
+  STATIC_CHECK(sizeof(raii::unique_rc<int *, raii::async_delete<slow_release>>) == sizeof(int *));
+}
+
+TEST_CASE("raii::async_closer releases handles on its own thread", "[async_delete]")
+{
+  raii::async_closer closer{ 16 };
+  int counter = 0;
+  released = 0;
+  for (int i = 0; i != 10; ++i) { closer.close<slow_release>(&counter); }
+  closer.flush();
+
+  CHECK(counter == 10);
+  CHECK(closer.closed_async() == 10);
+  CHECK(closer.closed_inline() == 0);
+  CHECK(releasing_thread != std::this_thread::get_id());
+}
+
+TEST_CASE("raii::async_closer releases inline, when the queue is full", "[async_delete]")
+{
+  raii::async_closer closer{ 4 };
+  REQUIRE(closer.capacity() == 4);
+  std::vector<int> counters(64);
+
+  gate_open = false;
+  // The closer holds one request blocked in slow_release, capacity more are queued, the rest run inline
+  for (int &counter : counters) { closer.close<slow_release>(&counter); }
+  CHECK(closer.closed_inline() >= counters.size() - closer.capacity() - 1);
+  gate_open = true;
+  closer.flush();
+
+  for (const int counter : counters) { CHECK(counter == 1); }
+  CHECK(closer.closed_async() + closer.closed_inline() == counters.size());
+}
+
+TEST_CASE("raii::async_closer destructor releases the queued handles", "[async_delete]")
+{
+  int counter = 0;
+  {
+    raii::async_closer closer;
+    for (int i = 0; i != 100; ++i) { closer.close<slow_release>(&counter); }
+  }
+  CHECK(counter == 100);
+}
+
+TEST_CASE("raii::async_delete closes FILE * on the global closer", "[async_delete]")
+{
+  released = 0;
+  {
+    const raii::unique_rc<FILE *, raii::async_delete<raii::stdio_fclose>> file{ std::tmpfile() };
+    REQUIRE(file);
+    CHECK(std::fputs("unique_rc", file.get()) >= 0);
+
+    int counter = 0;
+    {
+      const raii::unique_rc<int *, raii::async_delete<slow_release>> owner{ &counter };
+    }
+    raii::async_closer::global()->flush();
+    CHECK(counter == 1);
+  }
+  raii::async_closer::global()->flush();
+  CHECK(released == 1);
+}
@@ -0,0 +1,70 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/memory_delete.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_coroutine_handle.hpp"
+#include "urc/unique_ptr.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <coroutine>
+#include <cstdio>
+
+
+namespace {
+struct Empty
+{};
+
+struct final_deleter final
+{
+  void operator()(int * /*unused*/) const noexcept {}
+};
+
+struct stateful_deleter
+{
+  int *counter;
+
+  void operator()(int * /*unused*/) const noexcept { ++*counter; }
+};
+
+template<typename Wrapper, typename Handle> constexpr bool has_layout_of = (sizeof(Wrapper) == sizeof(Handle))
+                                                                          && (alignof(Wrapper) == alignof(Handle));
+}// namespace
+
+
+TEST_CASE("unique_rc with stateless deleter has size and alignment of its handle", "[unique_rc][layout]")
+{
+  STATIC_CHECK(has_layout_of<raii::unique_rc<FILE *, raii::stdio_fclose>, FILE *>);
+  STATIC_CHECK(has_layout_of<raii::unique_rc<int *, raii::memory_delete<int *>>, int *>);
+  STATIC_CHECK(has_layout_of<raii::unique_rc<const char *, raii::memory_delete<const char *>>, const char *>);
+}
+
+TEST_CASE("unique_ptr with stateless deleter has size and alignment of a pointer", "[unique_ptr][layout]")
+{
+  STATIC_CHECK(has_layout_of<raii::unique_ptr<int>, int *>);
+  STATIC_CHECK(has_layout_of<raii::unique_ptr<Empty>, Empty *>);
+  STATIC_CHECK(has_layout_of<raii::unique_ptr<int, raii::memory_delete<int *>>, int *>);
+
+  // NOLINTBEGIN(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+  STATIC_CHECK(has_layout_of<raii::unique_ptr<int[]>, int *>);
+  STATIC_CHECK(has_layout_of<raii::unique_ptr<Empty[]>, Empty *>);
+  // NOLINTEND(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+}
+
+TEST_CASE("unique_coroutine_handle has size and alignment of std::coroutine_handle", "[unique_coroutine_handle][layout]")
+{
+  STATIC_CHECK(has_layout_of<raii::unique_coroutine_handle<void>, std::coroutine_handle<>>);
+  STATIC_CHECK(has_layout_of<raii::unique_coroutine_handle<Empty>, std::coroutine_handle<Empty>>);
+}
+
+TEST_CASE("final stateless deleter does not add storage", "[unique_rc][unique_ptr][layout]")
+{
+  STATIC_CHECK(has_layout_of<raii::unique_rc<int *, final_deleter>, int *>);
+  STATIC_CHECK(has_layout_of<raii::unique_ptr<int, final_deleter>, int *>);
+}
+
+TEST_CASE("stateful and reference deleters are stored next to the handle", "[unique_rc][unique_ptr][layout]")
+{
+  STATIC_CHECK(sizeof(raii::unique_ptr<int, stateful_deleter>) == sizeof(int *) + sizeof(stateful_deleter));
+  STATIC_CHECK(sizeof(raii::unique_ptr<int, stateful_deleter &>) == 2 * sizeof(int *));
+  STATIC_CHECK(sizeof(raii::unique_rc<int *, void (&)(int *)>) == 2 * sizeof(int *));
+}
@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/tagged_pointer.hpp"
+
+#include <cstdint>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int delete_call_count = 0;
+
+struct alignas(8) Connection
+{
+  int id;
+};
+
+struct counting_delete
+{
+  void operator()(Connection *ptr) const noexcept
+  {
+    ++delete_call_count;
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete ptr;
+  }
+};
+
+using tagged_connection = raii::unique_tagged_ptr<Connection, 3, counting_delete>;
+}// namespace
+
+
+TEST_CASE("unique_tagged_ptr has size of a pointer", "[tagged_pointer][layout]")
+{
+  STATIC_CHECK(raii::alignment_tag_bits<Connection> == 3);
+  STATIC_CHECK(sizeof(raii::tagged_pointer<Connection>) == sizeof(Connection *));
+  STATIC_CHECK(sizeof(tagged_connection) == sizeof(Connection *));
+  STATIC_CHECK(sizeof(raii::unique_tagged_ptr<std::uint64_t>) == sizeof(std::uint64_t *));
+}
+
+TEST_CASE("Default constructed unique_tagged_ptr owns nothing", "[tagged_pointer][construction]")
+{
+  constexpr tagged_connection conn;
+
+  STATIC_CHECK_FALSE(conn);
+  STATIC_CHECK(conn.get().tag() == 0);
+}
+
+TEST_CASE("tagged_pointer strips tag from the pointer", "[tagged_pointer][observers]")
+{
+  Connection conn{ 7 };
+  const raii::tagged_pointer<Connection, 3> ptr{ &conn, 5 };
+
+  CHECK(ptr.get() == &conn);
+  CHECK(ptr.tag() == 5);
+  CHECK(ptr->id == 7);
+  CHECK((*ptr).id == 7);
+
+  const auto retagged = ptr.with_tag(2);
+  CHECK(retagged.get() == &conn);
+  CHECK(retagged.tag() == 2);
+  CHECK(retagged != ptr);
+}
+
+TEST_CASE("unique_tagged_ptr ownership ignores the tag", "[tagged_pointer][modifiers]")
+{
+  delete_call_count = 0;
+  {
+    using tagged = raii::tagged_pointer<Connection, 3>;
+
+    tagged_connection conn{ tagged{ new Connection{ 1 }, 4 } };
+    CHECK(conn);
+    CHECK(conn.get().tag() == 4);
+    CHECK(conn->id == 1);
+
+    raii::set_tag(conn, 1);
+    CHECK(conn);
+    CHECK(conn.get().tag() == 1);
+    CHECK(conn->id == 1);
+    CHECK(delete_call_count == 0);
+
+    // Tag on an empty handle does not make it owned
+    tagged_connection empty{ tagged{}.with_tag(3) };
+    CHECK_FALSE(empty);
+  }
+  CHECK(delete_call_count == 1);
+}
+
+TEST_CASE("unique_tagged_ptr reset deletes the untagged pointer", "[tagged_pointer][modifiers]")
+{
+  delete_call_count = 0;
+
+  using tagged = raii::tagged_pointer<Connection, 3>;
+  tagged_connection conn{ tagged{ new Connection{ 1 }, 7 } };
+
+  conn.reset(tagged{ new Connection{ 2 }, 0 });
+  CHECK(delete_call_count == 1);
+  CHECK(conn->id == 2);
+
+  conn.reset();
+  CHECK(delete_call_count == 2);
+  CHECK_FALSE(conn);
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/deleter_linux.hpp"
+#include "urc/deleter_posix.hpp"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <csignal>
+#include <cstdint>
+#include <type_traits>
+#include <utility>// std::move
+
+
+namespace {
+bool is_open(int fd) noexcept { return ::fcntl(fd, F_GETFD) != -1; }
+}// namespace
+
+
+TEST_CASE("Linux descriptor wrappers have the size of int and are distinct types", "[posix][linux][layout]")
+{
+  STATIC_CHECK(sizeof(raii::unique_epoll) == sizeof(int));
+  STATIC_CHECK(sizeof(raii::unique_eventfd) == sizeof(int));
+  STATIC_CHECK(sizeof(raii::unique_timerfd) == sizeof(int));
+  STATIC_CHECK(sizeof(raii::unique_signalfd) == sizeof(int));
+  STATIC_CHECK(sizeof(raii::unique_pidfd) == sizeof(int));
+
+  STATIC_CHECK_FALSE(std::is_constructible_v<raii::unique_epoll, raii::unique_eventfd &&>);
+  STATIC_CHECK(std::is_constructible_v<raii::unique_fd, raii::unique_epoll &&>);
+}
+
+TEST_CASE("Linux descriptor wrappers close their descriptors", "[posix][linux]")
+{
+  int epoll_fd = -1;
+  int event_fd = -1;
+  int timer_fd = -1;
+  int signal_fd = -1;
+  {
+    const raii::unique_epoll epoll{ ::epoll_create1(EPOLL_CLOEXEC) };
+    const raii::unique_eventfd event{ ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) };
+    const raii::unique_timerfd timer{ ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC) };
+    sigset_t mask;// NOLINT(cppcoreguidelines-init-variables)
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGUSR2);
+    const raii::unique_signalfd signal{ ::signalfd(-1, &mask, SFD_CLOEXEC) };
+    REQUIRE(epoll);
+    REQUIRE(event);
+    REQUIRE(timer);
+    REQUIRE(signal);
+    epoll_fd = epoll.get();
+    event_fd = event.get();
+    timer_fd = timer.get();
+    signal_fd = signal.get();
+
+    epoll_event watch{};
+    watch.events = EPOLLIN;
+    CHECK(::epoll_ctl(epoll.get(), EPOLL_CTL_ADD, event.get(), &watch) == 0);
+    const std::uint64_t one = 1;
+    CHECK(::write(event.get(), &one, sizeof(one)) == sizeof(one));
+    epoll_event ready{};
+    CHECK(::epoll_wait(epoll.get(), &ready, 1, 0) == 1);
+  }
+  CHECK_FALSE(is_open(epoll_fd));
+  CHECK_FALSE(is_open(event_fd));
+  CHECK_FALSE(is_open(timer_fd));
+  CHECK_FALSE(is_open(signal_fd));
+}
+
+TEST_CASE("raii::unique_pidfd closes the process descriptor", "[posix][linux]")
+{
+#ifdef SYS_pidfd_open
+  const raii::unique_pidfd self{ static_cast<int>(::syscall(SYS_pidfd_open, ::getpid(), 0)) };
+  // Kernels before 5.3 report ENOSYS, the wrapper stays empty
+  if (self) { CHECK(is_open(self.get())); }
+#endif
+  CHECK_FALSE(raii::unique_pidfd{});
+}
+
+TEST_CASE("Linux descriptor wrappers hand over to raii::unique_fd", "[posix][linux]")
+{
+  raii::unique_eventfd event{ ::eventfd(0, EFD_CLOEXEC) };
+  const int fd = event.get();
+  const raii::unique_fd generic{ std::move(event) };
+  CHECK(generic.get() == fd);
+  CHECK_FALSE(event);// NOLINT(bugprone-use-after-move, hicpp-invalid-access-moved)
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/deleter_posix.hpp"
+#include "urc/deleter_posix_thread.hpp"
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>// strdup
+#include <string_view>
+#include <utility>// std::move
+
+
+namespace {
+bool is_open(int fd) noexcept { return ::fcntl(fd, F_GETFD) != -1; }
+
+constexpr std::size_t page_size = 4096;
+}// namespace
+
+
+TEST_CASE("POSIX wrappers have the size of their handles", "[posix][layout]")
+{
+  STATIC_CHECK(sizeof(raii::unique_fd) == sizeof(int));
+  STATIC_CHECK(sizeof(raii::unique_mapping) == sizeof(raii::deleter::posix::unmap::handle));
+  STATIC_CHECK(sizeof(raii::unique_dir) == sizeof(DIR *));
+  STATIC_CHECK(sizeof(raii::unique_dl) == sizeof(void *));
+  STATIC_CHECK(sizeof(raii::unique_addrinfo) == sizeof(addrinfo *));
+  STATIC_CHECK(sizeof(raii::unique_c_ptr<char>) == sizeof(char *));
+  STATIC_CHECK(sizeof(raii::unique_pthread_mutex) == sizeof(pthread_mutex_t *));
+  STATIC_CHECK(sizeof(raii::unique_pthread_cond) == sizeof(pthread_cond_t *));
+  STATIC_CHECK(sizeof(raii::unique_pthread_rwlock) == sizeof(pthread_rwlock_t *));
+  STATIC_CHECK(sizeof(raii::unique_pthread_attr) == sizeof(pthread_attr_t *));
+}
+
+TEST_CASE("raii::unique_fd treats only negative descriptors as invalid", "[posix]")
+{
+  CHECK_FALSE(raii::unique_fd{});
+  CHECK_FALSE(raii::unique_fd{ -1 });
+
+  int fds[2]{};// NOLINT(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  REQUIRE(::pipe(fds) == 0);
+  raii::unique_fd read_end{ fds[0] };
+  {
+    const raii::unique_fd write_end{ fds[1] };
+    CHECK(is_open(fds[1]));
+  }
+  CHECK_FALSE(is_open(fds[1]));
+
+  const raii::unique_fd moved{ std::move(read_end) };
+  CHECK_FALSE(read_end);// NOLINT(bugprone-use-after-move, hicpp-invalid-access-moved)
+  CHECK(moved.get() == fds[0]);
+}
+
+TEST_CASE("raii::unique_mapping unmaps the whole mapping", "[posix]")
+{
+  void *addr = ::mmap(nullptr, 2 * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  REQUIRE(addr != MAP_FAILED);
+  {
+    const raii::unique_mapping mapping{ { addr, 2 * page_size } };
+    REQUIRE(mapping);
+    CHECK(*mapping.get() == addr);
+    static_cast<std::byte *>(addr)[page_size] = std::byte{ 1 };
+  }
+  // msync fails with ENOMEM on addresses, which are not mapped
+  CHECK(::msync(addr, page_size, MS_ASYNC) == -1);
+  CHECK(errno == ENOMEM);
+
+  const raii::unique_mapping failed{ { MAP_FAILED, page_size } };
+  CHECK_FALSE(failed);
+  CHECK_FALSE(raii::unique_mapping{});
+}
+
+TEST_CASE("raii::unique_dir, raii::unique_dl, raii::unique_addrinfo and raii::unique_c_ptr release C library objects",
+  "[posix]")
+{
+  const raii::unique_dir dir{ ::opendir("/") };
+  REQUIRE(dir);
+  CHECK(::readdir(dir.get()) != nullptr);
+
+  const raii::unique_dl self{ ::dlopen(nullptr, RTLD_NOW) };
+  CHECK(self);
+
+  addrinfo hints{};
+  hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *res = nullptr;
+  REQUIRE(::getaddrinfo("127.0.0.1", "80", &hints, &res) == 0);
+  const raii::unique_addrinfo info{ res };
+  CHECK(info->ai_family == AF_INET);
+
+  const raii::unique_c_ptr<char> copy{ ::strdup("unique_rc") };
+  CHECK(std::string_view{ copy.get() } == "unique_rc");
+  const raii::unique_c_ptr<const char> const_copy{ ::strdup("const") };
+  CHECK(const_copy);
+}
+
+TEST_CASE("pthread wrappers destroy objects in place", "[posix]")
+{
+  pthread_mutex_t mtx;// NOLINT(cppcoreguidelines-init-variables)
+  REQUIRE(::pthread_mutex_init(&mtx, nullptr) == 0);
+  pthread_cond_t cond;// NOLINT(cppcoreguidelines-init-variables)
+  REQUIRE(::pthread_cond_init(&cond, nullptr) == 0);
+  pthread_attr_t attr;// NOLINT(cppcoreguidelines-init-variables)
+  REQUIRE(::pthread_attr_init(&attr) == 0);
+  {
+    const raii::unique_pthread_mutex mutex_guard{ &mtx };
+    const raii::unique_pthread_cond cond_guard{ &cond };
+    const raii::unique_pthread_attr attr_guard{ &attr };
+    CHECK(::pthread_mutex_lock(mutex_guard.get()) == 0);
+    CHECK(::pthread_cond_signal(cond_guard.get()) == 0);
+    CHECK(::pthread_mutex_unlock(mutex_guard.get()) == 0);
+  }
+  // Destroyed objects may be initialised again
+  REQUIRE(::pthread_mutex_init(&mtx, nullptr) == 0);
+  const raii::unique_pthread_mutex again{ &mtx };
+  CHECK(again);
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "testsuite_temp_file.hpp"
+#include "urc/deleter_posix.hpp"
+#include "urc/file_transfer.hpp"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+
+
+namespace {
+constexpr std::size_t file_size = 3 * 1024 * 1024 + 17;
+
+std::string pattern(std::size_t size)
+{
+  std::string res(size, '\0');
+  for (std::size_t i = 0; i != size; ++i) { res[i] = static_cast<char>('a' + (i * 7) % 26); }
+  return res;
+}
+
+std::span<const std::byte> bytes_of(const std::string &str) noexcept { return std::as_bytes(std::span{ str }); }
+}// namespace
+
+
+TEST_CASE("raii::file_transfer copies files with every method", "[posix][file_transfer]")
+{
+  const std::string data = pattern(file_size);
+  const raii_test::temp_file src{ bytes_of(data) };
+  raii::file_transfer copier{ 64 * 1024 };
+  for (const raii::transfer_method method : { raii::transfer_method::copy_file_range,
+         raii::transfer_method::sendfile,
+         raii::transfer_method::splice,
+         raii::transfer_method::buffer }) {
+    const raii_test::temp_file dst;
+    const raii::unique_fd in = src.open(O_RDONLY);
+    const raii::unique_fd out = dst.open(O_WRONLY | O_TRUNC);
+    const raii::transfer_result res = copier.transfer(in, out, raii::file_transfer::to_end, method);
+    CHECK(res.bytes == file_size);
+    CHECK(res.method == method);
+    CHECK(dst.contents() == data);
+  }
+}
+
+TEST_CASE("raii::file_transfer stops after count bytes and continues from the positions", "[posix][file_transfer]")
+{
+  const std::string data = pattern(file_size);
+  const raii_test::temp_file src{ bytes_of(data) };
+  const raii_test::temp_file dst;
+  const raii::unique_fd in = src.open(O_RDONLY);
+  const raii::unique_fd out = dst.open(O_WRONLY | O_TRUNC);
+  raii::file_transfer copier;
+  CHECK(copier.transfer(in, out, 1000).bytes == 1000);
+  CHECK(copier.transfer(in, out, 1000, raii::transfer_method::buffer).bytes == 1000);
+  CHECK(copier.transfer(in, out).bytes == file_size - 2000);
+  CHECK(dst.contents() == data);
+}
+
+TEST_CASE("raii::file_transfer switches to the buffer, if the target does not accept splice", "[posix][file_transfer]")
+{
+  const std::string data = pattern(file_size);
+  const raii_test::temp_file src{ bytes_of(data) };
+  const raii_test::temp_file dst;
+  const raii::unique_fd in = src.open(O_RDONLY);
+  const raii::unique_fd out = dst.open(O_WRONLY | O_APPEND);
+  raii::file_transfer copier{ 64 * 1024 };
+  const raii::transfer_result res =
+    copier.transfer(in, out, raii::file_transfer::to_end, raii::transfer_method::splice);
+  CHECK(res.bytes == file_size);
+  CHECK(res.method == raii::transfer_method::buffer);
+  CHECK(dst.contents() == data);
+}
+
+TEST_CASE("raii::file_transfer falls back for pipes and sockets", "[posix][file_transfer]")
+{
+  const std::string data = pattern(file_size);
+  const raii_test::temp_file src{ bytes_of(data) };
+  std::array<int, 2> fds{ -1, -1 };
+  REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) == 0);
+  raii::unique_fd sock_write{ fds[0] };
+  const raii::unique_fd sock_read{ fds[1] };
+  REQUIRE(::pipe2(fds.data(), O_CLOEXEC) == 0);
+  raii::unique_fd pipe_read{ fds[0] };
+  raii::unique_fd pipe_write{ fds[1] };
+
+  // file -> socket -> pipe -> file, each stage on its own thread, since socket and pipe buffers are small
+  const raii_test::temp_file dst;
+  raii::transfer_result to_socket;
+  raii::transfer_result to_pipe;
+  std::thread first{ [&] {
+    const raii::unique_fd in = src.open(O_RDONLY);
+    to_socket = raii::transfer(in, sock_write);
+    sock_write.reset();
+  } };
+  std::thread second{ [&] {
+    to_pipe = raii::transfer(sock_read, pipe_write);
+    pipe_write.reset();
+  } };
+  const raii::unique_fd out = dst.open(O_WRONLY | O_TRUNC);
+  const raii::transfer_result to_file = raii::transfer(pipe_read, out);
+  first.join();
+  second.join();
+
+  CHECK(to_socket.bytes == file_size);
+  CHECK(to_socket.method == raii::transfer_method::sendfile);
+  CHECK(to_pipe.bytes == file_size);
+  // Linux 5.12 and later sendfile from sockets and pipes through splice, older kernels need splice directly
+  CHECK(to_pipe.method != raii::transfer_method::copy_file_range);
+  CHECK(to_file.bytes == file_size);
+  CHECK(to_file.method != raii::transfer_method::copy_file_range);
+  CHECK(dst.contents() == data);
+}
+
+TEST_CASE("raii::copy_file copies contents and permissions", "[posix][file_transfer]")
+{
+  const std::string data = pattern(file_size);
+  const raii_test::temp_file src{ bytes_of(data) };
+  REQUIRE(::chmod(src.path(), 0640) == 0);
+  const raii_test::temp_file dst{ 10 * file_size };
+  CHECK(raii::copy_file(src.path(), dst.path()).bytes == file_size);
+  CHECK(dst.contents() == data);
+
+  const raii_test::temp_file created;
+  REQUIRE(::unlink(created.path()) == 0);
+  CHECK(raii::copy_file(src.path(), created.path()).bytes == file_size);
+  struct stat info{};
+  REQUIRE(::stat(created.path(), &info) == 0);
+  CHECK((info.st_mode & 0777) == 0640);
+
+  // procfs reports the size 0, copy_file_range copies nothing
+  CHECK(raii::copy_file("/proc/self/status", dst.path()).bytes > 0);
+
+  CHECK_THROWS_AS(raii::copy_file("/nonexistent/urc", dst.path()), std::system_error);
+}
+
+TEST_CASE("raii::copy_file refuses to copy a file onto itself", "[posix][file_transfer]")
+{
+  const std::string data = pattern(file_size);
+  const raii_test::temp_file src{ bytes_of(data) };
+  CHECK_THROWS_AS(raii::copy_file(src.path(), src.path()), std::system_error);
+  CHECK(src.contents() == data);
+
+  const std::string link = std::string{ src.path() } + ".link";
+  REQUIRE(::link(src.path(), link.c_str()) == 0);
+  CHECK_THROWS_AS(raii::copy_file(src.path(), link.c_str()), std::system_error);
+  static_cast<void>(::unlink(link.c_str()));
+  CHECK(src.contents() == data);
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/deleter_posix.hpp"
+#include "urc/record_reader.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>// std::move
+#include <vector>
+
+
+namespace {
+// Reads all records and checks, that views of the previous records are not needed, by copying them
+std::vector<std::string> read_all(raii::record_reader &reader)
+{
+  std::vector<std::string> res;
+  reader.for_each([&res](std::string_view rec) { res.emplace_back(rec); });
+  return res;
+}
+
+std::vector<std::string> split(const std::string &text, char delimiter)
+{
+  std::vector<std::string> res;
+  std::size_t start = 0;
+  for (std::size_t pos = 0; (pos = text.find(delimiter, start)) != std::string::npos; start = pos + 1) {
+    res.push_back(text.substr(start, pos - start));
+  }
+  if (start != text.size()) { res.push_back(text.substr(start)); }
+  return res;
+}
+
+raii::unique_rc<FILE *, raii::stdio_fclose> temp_stream(const std::string &text)
+{
+  raii::unique_rc<FILE *, raii::stdio_fclose> file{ std::tmpfile() };
+  REQUIRE(file);
+  REQUIRE(std::fwrite(text.data(), 1, text.size(), file.get()) == text.size());
+  std::rewind(file.get());
+  return file;
+}
+}// namespace
+
+
+TEST_CASE("raii::record_reader splits lines of a stream", "[record_reader]")
+{
+  STATIC_CHECK(std::is_nothrow_move_constructible_v<raii::record_reader>);
+  STATIC_CHECK_FALSE(std::is_copy_constructible_v<raii::record_reader>);
+
+  raii::record_reader reader{ temp_stream("first\nsecond\r\n\nlast") };
+  CHECK(reader.next() == "first");
+  CHECK(reader.next() == "second\r");
+  CHECK(reader.next() == "");
+  CHECK(reader.next() == "last");
+  CHECK_FALSE(reader.next());
+  CHECK_FALSE(reader.next());
+
+  raii::record_reader terminated{ temp_stream("one\ntwo\n") };
+  CHECK(read_all(terminated) == std::vector<std::string>{ "one", "two" });
+
+  raii::record_reader empty{ temp_stream("") };
+  CHECK_FALSE(empty.next());
+}
+
+TEST_CASE("raii::record_reader joins records spanning blocks and grows for long records", "[record_reader]")
+{
+  std::string text;
+  for (std::size_t i = 0; i != 5000; ++i) {
+    // Lengths cycle from 0 to 3 blocks, so records end at every offset within a block
+    text.append((i * 37) % (3 * raii::record_reader::block_alignment), static_cast<char>('a' + i % 26));
+    text.push_back('|');
+  }
+  text.append("unterminated");
+
+  raii::record_reader reader{ temp_stream(text), '|', 1 };
+  CHECK(reader.block_size() == raii::record_reader::block_alignment);
+  CHECK(read_all(reader) == split(text, '|'));
+  CHECK(reader.block_size() >= 2 * raii::record_reader::block_alignment);
+}
+
+TEST_CASE("raii::record_reader reads from an owned descriptor and a pipe", "[record_reader]")
+{
+  std::string text;
+  for (int i = 0; i != 100000; ++i) { text += "line " + std::to_string(i) + '\n'; }
+
+  std::array<int, 2> fds{ -1, -1 };
+  REQUIRE(::pipe(fds.data()) == 0);
+  raii::unique_fd write_end{ fds[1] };
+  // Pipe reads return less than a block, records span the reads at random
+  std::thread writer{ [&] {
+    for (std::size_t pos = 0; pos < text.size(); pos += 1000) {
+      const std::string_view part = std::string_view{ text }.substr(pos, 1000);
+      REQUIRE(::write(write_end.get(), part.data(), part.size()) == static_cast<ssize_t>(part.size()));
+    }
+    write_end.reset();
+  } };
+
+  raii::record_reader reader{ raii::unique_fd{ fds[0] } };
+  std::size_t count = 0;
+  bool in_order = true;
+  reader.for_each([&](std::string_view line) {
+    in_order = in_order && (line == "line " + std::to_string(count));
+    ++count;
+  });
+  writer.join();
+  CHECK(count == 100000);
+  CHECK(in_order);
+}
+
+TEST_CASE("raii::record_reader keeps data buffered by the stream", "[record_reader]")
+{
+  auto file = temp_stream("header\nbody 1\nbody 2\n");
+  std::array<char, 16> header{};
+  REQUIRE(std::fgets(header.data(), header.size(), file.get()) != nullptr);
+  CHECK(std::string_view{ header.data() } == "header\n");
+
+  raii::record_reader reader{ std::move(file) };
+  CHECK(read_all(reader) == std::vector<std::string>{ "body 1", "body 2" });
+}
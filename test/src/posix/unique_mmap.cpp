@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "testsuite_temp_file.hpp"
+#include "urc/deleter_posix.hpp"
+#include "urc/relocate.hpp"
+#include "urc/unique_mmap.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <type_traits>
+#include <utility>// std::move
+
+
+TEST_CASE("raii::unique_mmap has the size of the address and the length", "[posix][mmap][layout]")
+{
+  STATIC_CHECK(sizeof(raii::unique_mmap) == sizeof(void *) + sizeof(std::size_t));
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_mmap>);
+  STATIC_CHECK_FALSE(std::is_copy_constructible_v<raii::unique_mmap>);
+
+  const raii::unique_mmap empty;
+  CHECK_FALSE(empty);
+  CHECK(empty == nullptr);
+  CHECK(empty.data() == nullptr);
+  CHECK(empty.bytes().empty());
+}
+
+TEST_CASE("raii::map_file maps a file read-write and writes reach the file", "[posix][mmap]")
+{
+  const std::size_t size = 3 * raii::unique_mmap::page_size();
+  const raii_test::temp_file file{ size };
+  {
+    const raii::unique_mmap view = raii::map_file(file.path(), raii::mmap_access::read_write);
+    REQUIRE(view);
+    CHECK(view.size() == size);
+    const auto words = view.as_span<std::uint32_t>();
+    CHECK(words.size() == size / sizeof(std::uint32_t));
+    for (std::size_t i = 0; i != words.size(); ++i) { words[i] = static_cast<std::uint32_t>(i); }
+    view.flush();
+  }
+
+  std::uint32_t last = 0;
+  const auto offset = static_cast<off_t>(size - sizeof(last));
+  REQUIRE(::pread(file.fd(), &last, sizeof(last), offset) == sizeof(last));
+  CHECK(last == size / sizeof(std::uint32_t) - 1);
+
+  {
+    raii::mmap_options options;
+    options.offset = raii::unique_mmap::page_size();
+    options.populate = true;
+    const raii::unique_mmap tail = raii::map_file(file.fd(), raii::mmap_access::read_only, options);
+    CHECK(tail.size() == size - options.offset);
+    CHECK(tail.as_span<const std::uint32_t>().front() == options.offset / sizeof(std::uint32_t));
+  }
+}
+
+TEST_CASE("raii::unique_mmap unmaps the view", "[posix][mmap]")
+{
+  const raii_test::temp_file file{ raii::unique_mmap::page_size() };
+  raii::unique_mmap view = raii::map_file(file.fd(), raii::mmap_access::copy_on_write);
+  std::byte *const addr = view.data();
+  view.bytes()[0] = std::byte{ 42 };
+
+  raii::unique_mmap moved{ std::move(view) };
+  CHECK_FALSE(view);// NOLINT(bugprone-use-after-move, hicpp-invalid-access-moved)
+  CHECK(moved.data() == addr);
+
+  moved = nullptr;
+  // msync fails with ENOMEM on addresses, which are not mapped
+  CHECK(::msync(addr, raii::unique_mmap::page_size(), MS_ASYNC) == -1);
+  CHECK(errno == ENOMEM);
+
+  // Private writes don't reach the file
+  std::byte first{ 1 };
+  REQUIRE(::pread(file.fd(), &first, 1, 0) == 1);
+  CHECK(first == std::byte{ 0 });
+}
+
+TEST_CASE("raii::unique_mmap passes hints to madvise", "[posix][mmap]")
+{
+  const raii_test::temp_file file{ 4 * raii::unique_mmap::page_size() };
+  const raii::unique_mmap view = raii::map_file(file.path(), raii::mmap_access::read_only);
+  CHECK(view.advise(raii::mmap_advice::sequential));
+  CHECK(view.advise(raii::mmap_advice::willneed, raii::unique_mmap::page_size() + 1, 10));
+  CHECK(view.advise(raii::mmap_advice::random, view.size() - 1));
+  CHECK(view.advise(raii::mmap_advice::normal));
+  // MADV_HUGEPAGE depends on the kernel configuration, only the view has to stay usable
+  static_cast<void>(view.advise(raii::mmap_advice::hugepage));
+  CHECK(view.bytes()[0] == std::byte{ 0 });
+}
+
+TEST_CASE("raii::map_file reports errors and maps empty files to an empty view", "[posix][mmap]")
+{
+  const raii_test::temp_file empty{ 0 };
+  CHECK_FALSE(raii::map_file(empty.path(), raii::mmap_access::read_only));
+
+  CHECK_THROWS_AS(raii::map_file("/nonexistent/urc", raii::mmap_access::read_only), std::system_error);
+
+  const raii_test::temp_file file{ 2 * raii::unique_mmap::page_size() };
+  raii::mmap_options unaligned;
+  unaligned.offset = 1;
+  CHECK_THROWS_AS(raii::map_file(file.fd(), raii::mmap_access::read_only, unaligned), std::system_error);
+}
@@ -0,0 +1,108 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/coroutine_destroy.hpp"
+#include "urc/memory_delete.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_ptr.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <utility>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int delete_call_count = 0;
+
+struct tolerant_delete
+{
+  static constexpr bool accepts_invalid_handle = true;
+
+  void operator()(int *ptr) const noexcept
+  {
+    ++delete_call_count;
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete ptr;
+  }
+};
+
+struct constexpr_delete
+{
+  static constexpr bool accepts_invalid_handle = true;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+  constexpr void operator()(int *ptr) const noexcept { delete ptr; }
+};
+
+struct checked_delete
+{
+  void operator()(int *ptr) const noexcept
+  {
+    ++delete_call_count;
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete ptr;
+  }
+};
+}// namespace
+
+
+TEST_CASE("Deleters which tolerate invalid handle opt in", "[accepts_invalid_handle]")
+{
+  STATIC_CHECK(raii::accepts_invalid_handle_v<tolerant_delete>);
+  STATIC_CHECK(raii::accepts_invalid_handle_v<tolerant_delete &>);
+  STATIC_CHECK(raii::accepts_invalid_handle_v<const tolerant_delete &>);
+
+  // operator delete and free check for null themselves, an unconditional call only moves the branch into them
+  STATIC_CHECK_FALSE(raii::accepts_invalid_handle_v<raii::default_delete<int>>);
+  STATIC_CHECK_FALSE(raii::accepts_invalid_handle_v<raii::memory_delete<int *>>);
+  STATIC_CHECK_FALSE(raii::accepts_invalid_handle_v<raii::stdio_fclose>);
+  STATIC_CHECK_FALSE(raii::accepts_invalid_handle_v<raii::coroutine_destroy>);
+  STATIC_CHECK_FALSE(raii::accepts_invalid_handle_v<checked_delete>);
+}
+
+TEST_CASE("Tolerant deleter is invoked on empty unique_ptr", "[accepts_invalid_handle][unique_ptr]")
+{
+  delete_call_count = 0;
+  {
+    const raii::unique_ptr<int, tolerant_delete> empty;
+    const raii::unique_ptr<int, tolerant_delete> owner{ new int{ 1 } };
+  }
+  CHECK(delete_call_count == 2);
+
+  delete_call_count = 0;
+  {
+    raii::unique_ptr<int, tolerant_delete> owner;
+    owner.reset(new int{ 2 });
+    CHECK(delete_call_count == 1);
+
+    owner.reset();
+    CHECK(delete_call_count == 2);
+    CHECK_FALSE(owner);
+
+    raii::unique_ptr<int, tolerant_delete> other{ std::move(owner) };
+    CHECK_FALSE(other);
+  }
+  CHECK(delete_call_count == 4);
+}
+
+TEST_CASE("Checking deleter is not invoked on empty unique_ptr", "[accepts_invalid_handle][unique_ptr]")
+{
+  delete_call_count = 0;
+  {
+    const raii::unique_ptr<int, checked_delete> empty;
+    const raii::unique_ptr<int, checked_delete> owner{ new int{ 1 } };
+  }
+  CHECK(delete_call_count == 1);
+}
+
+TEST_CASE("unique_ptr with tolerant deleter in constant expression", "[accepts_invalid_handle][unique_ptr]")
+{
+  constexpr auto value = [] {
+    raii::unique_ptr<int, constexpr_delete> owner;
+    owner.reset(new int{ 3 });
+    const int res = *owner;
+    owner.reset();
+    return res;
+  }();
+
+  STATIC_CHECK(value == 3);
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "urc/memory_delete.hpp"
+#include "urc/relocate.hpp"
+#include "urc/stdio_fclose.hpp"
+#include "urc/unique_coroutine_handle.hpp"
+#include "urc/unique_ptr.hpp"
+#include "urc/unique_rc.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+int delete_call_count = 0;
+
+struct counting_delete
+{
+  void operator()(int *ptr) const noexcept
+  {
+    ++delete_call_count;
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete ptr;
+  }
+};
+
+struct stateful_delete
+{
+  std::string name;
+
+  void operator()(int *ptr) const noexcept
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+    delete ptr;
+  }
+};
+
+constexpr std::size_t count = 4;
+
+template<typename T> struct raw_storage
+{
+  std::allocator<T> alloc;
+  T *data = alloc.allocate(count);
+
+  raw_storage() = default;
+  raw_storage(const raw_storage &) = delete;
+  raw_storage &operator=(const raw_storage &) = delete;
+  raw_storage(raw_storage &&) = delete;
+  raw_storage &operator=(raw_storage &&) = delete;
+
+  ~raw_storage() { alloc.deallocate(data, count); }
+};
+}// namespace
+
+
+TEST_CASE("Owners with stateless deleters are trivially relocatable", "[relocate][is_trivially_relocatable]")
+{
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_ptr<int>>);
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_ptr<int[]>>);
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_ptr<int, counting_delete>>);
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_ptr<int, counting_delete &>>);
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_rc<FILE *, raii::stdio_fclose>>);
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_rc<int *, raii::memory_delete<int *>>>);
+  STATIC_CHECK(raii::is_trivially_relocatable_v<raii::unique_coroutine_handle<void>>);
+}
+
+TEST_CASE("Owners with non trivially relocatable deleters are not", "[relocate][is_trivially_relocatable]")
+{
+  STATIC_CHECK_FALSE(raii::is_trivially_relocatable_v<raii::unique_ptr<int, stateful_delete>>);
+  STATIC_CHECK_FALSE(raii::is_trivially_relocatable_v<raii::unique_rc<int *, stateful_delete>>);
+}
+
+TEST_CASE("raii::uninitialized_relocate_n transfers ownership without deleting", "[relocate][unique_ptr]")
+{
+  delete_call_count = 0;
+  {
+    using owner = raii::unique_ptr<int, counting_delete>;
+    raw_storage<owner> src;
+    raw_storage<owner> dst;
+
+    for (std::size_t i = 0; i != count; ++i) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      std::construct_at(src.data + i, new int{ static_cast<int>(i) });
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    CHECK(raii::uninitialized_relocate_n(src.data, count, dst.data) == dst.data + count);
+    CHECK(delete_call_count == 0);
+
+    for (std::size_t i = 0; i != count; ++i) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      CHECK(*dst.data[i] == static_cast<int>(i));
+    }
+
+    std::destroy_n(dst.data, count);
+  }
+  CHECK(delete_call_count == static_cast<int>(count));
+}
+
+TEST_CASE("raii::uninitialized_relocate moves and destroys non trivially relocatable owners", "[relocate][unique_ptr]")
+{
+  using owner = raii::unique_ptr<int, stateful_delete>;
+  raw_storage<owner> src;
+  raw_storage<owner> dst;
+
+  for (std::size_t i = 0; i != count; ++i) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::construct_at(src.data + i, new int{ static_cast<int>(i) }, stateful_delete{ "deleter" });
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  raii::uninitialized_relocate(src.data, src.data + count, dst.data);
+
+  for (std::size_t i = 0; i != count; ++i) {
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    CHECK(*dst.data[i] == static_cast<int>(i));
+    CHECK(dst.data[i].get_deleter().name == "deleter");
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  }
+
+  std::destroy_n(dst.data, count);
+}
+
+TEST_CASE("raii::relocate_at in constant expression", "[relocate][unique_ptr]")
+{
+  constexpr auto relocated_value = [] {
+    std::allocator<raii::unique_ptr<int>> alloc;
+    auto *storage = alloc.allocate(2);
+
+    std::construct_at(storage, new int{ 42 });
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    auto *relocated = raii::relocate_at(storage, storage + 1);
+    const int value = **relocated;
+
+    std::destroy_at(relocated);
+    alloc.deallocate(storage, 2);
+
+    return value;
+  }();
+
+  STATIC_CHECK(relocated_value == 42);
+}
@@ -0,0 +1,172 @@
+// aligned_delete and make_unique_aligned for unique_ptr -*- C++ -*-
+
+#ifndef RAII_ALIGNED_DELETE_HPP
+#define RAII_ALIGNED_DELETE_HPP
+
+#include "raii_defs.hpp"
+#include "unique_ptr.hpp"
+
+#include <bit>// std::has_single_bit
+#include <cstddef>// std::size_t
+#include <limits>
+#include <memory>// std::uninitialized_value_construct_n, std::uninitialized_default_construct_n
+#include <new>// std::align_val_t, std::bad_array_new_length
+#include <type_traits>
+#include <utility>// std::forward
+
+
+RAII_NS_BEGIN
+
+/// @brief Alignment, which keeps objects on distinct cache lines on x86-64 and most AArch64 cores.
+/// std::hardware_destructive_interference_size is not used, because its value may differ between translation units
+inline constexpr std::size_t cache_line_size = 64;
+
+template<typename T, std::size_t Align>
+concept valid_alignment_for = std::has_single_bit(Align) && (Align >= alignof(T));
+
+/**
+ * @brief Destroys an object and releases memory allocated by ::operator new(sizeof(T), std::align_val_t{ Align }).
+ * Alignment is a part of the type, therefore the deleter is stateless and unique_ptr keeps the size of a pointer
+ * @tparam T the type of the object
+ * @tparam Align alignment of the allocation, a power of two not less than alignof(T)
+ **/
+template<typename T, std::size_t Align>
+  requires valid_alignment_for<T, Align>
+struct aligned_delete
+{
+  static constexpr std::size_t alignment = Align;
+
+  constexpr aligned_delete() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static void operator()(T *ptr) noexcept
+#else
+  raii_inline void operator()(T *ptr) const noexcept
+#endif
+  {
+    // cppcheck-suppress sizeofVoid;
+    // NOLINTNEXTLINE(bugprone-sizeof-expression)
+    static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type");
+
+    ptr->~T();
+    ::operator delete(ptr, sizeof(T), std::align_val_t{ Align });
+  }
+};
+
+/**
+ * @brief Releases memory allocated by ::operator new[](size, std::align_val_t{ Align }).
+ * @note Element count is not stored, so elements are not destroyed, which is why T must be trivially destructible.
+ * Use raii::unique_array for the arrays of objects with non-trivial destructors
+ **/
+template<typename T, std::size_t Align>
+  requires valid_alignment_for<T, Align>
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+struct aligned_delete<T[], Align>
+{
+  static_assert(std::is_trivially_destructible_v<T>, "aligned array elements must be trivially destructible");
+
+  static constexpr std::size_t alignment = Align;
+
+  constexpr aligned_delete() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static void operator()(T *ptr) noexcept
+#else
+  raii_inline void operator()(T *ptr) const noexcept
+#endif
+  {
+    ::operator delete[](ptr, std::align_val_t{ Align });
+  }
+};
+
+
+/// @brief unique_ptr, which owns an object or an array allocated with Align alignment, e.g.
+/// `unique_aligned_ptr<float[], 64>` for AVX-512 buffers
+template<typename T, std::size_t Align = cache_line_size>
+using unique_aligned_ptr = unique_ptr<T, aligned_delete<T, Align>>;
+
+
+namespace detail {
+
+  template<typename T, std::size_t Align, typename Init>
+  [[nodiscard]] raii_inline unique_aligned_ptr<T, Align> make_unique_aligned_single(Init init)
+  {
+    void *const mem = ::operator new(sizeof(T), std::align_val_t{ Align });
+    try {
+      return unique_aligned_ptr<T, Align>{ init(mem) };
+    } catch (...) {
+      ::operator delete(mem, sizeof(T), std::align_val_t{ Align });
+      throw;
+    }
+  }
+
+  template<typename T, std::size_t Align, typename Init>
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+  [[nodiscard]] raii_inline unique_aligned_ptr<T[], Align> make_unique_aligned_array(std::size_t size, Init init)
+  {
+    if (size > std::numeric_limits<std::size_t>::max() / sizeof(T)) { throw std::bad_array_new_length{}; }
+
+    // Elements are trivially destructible, so the owner only needs to free memory if initialisation throws
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+    unique_aligned_ptr<T[], Align> res{ static_cast<T *>(
+      ::operator new[](size * sizeof(T), std::align_val_t{ Align })) };
+    init(res.get(), size);
+    return res;
+  }
+
+}// namespace detail
+
+
+// make_unique_aligned and make_unique_aligned_for_overwrite
+
+template<class T, std::size_t Align = cache_line_size, class... Types>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline unique_aligned_ptr<T, Align> make_unique_aligned(Types &&...Args)
+{
+  return detail::make_unique_aligned_single<T, Align>([&](void *mem) {
+    // NOLINTNEXTLINE(clang-diagnostic-missing-field-initializers)
+    return ::new (mem) T{ std::forward<Types>(Args)... };
+  });
+}
+
+template<class T, std::size_t Align = cache_line_size>
+  requires std::is_unbounded_array_v<T>
+[[nodiscard]] raii_inline unique_aligned_ptr<T, Align> make_unique_aligned(const std::size_t size)
+{
+  using Elem = std::remove_extent_t<T>;
+  return detail::make_unique_aligned_array<Elem, Align>(
+    size, [](Elem *ptr, std::size_t count) { std::uninitialized_value_construct_n(ptr, count); });
+}
+
+template<class T, std::size_t Align = cache_line_size, class... Types>
+  requires std::is_bounded_array_v<T>
+void make_unique_aligned(Types &&...) = delete;
+
+template<typename T, std::size_t Align = cache_line_size>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline unique_aligned_ptr<T, Align> make_unique_aligned_for_overwrite()
+{
+  // with default initialization
+  return detail::make_unique_aligned_single<T, Align>([](void *mem) { return ::new (mem) T; });
+}
+
+template<typename T, std::size_t Align = cache_line_size>
+  requires std::is_unbounded_array_v<T>
+[[nodiscard]] raii_inline unique_aligned_ptr<T, Align> make_unique_aligned_for_overwrite(const std::size_t size)
+{
+  using Elem = std::remove_extent_t<T>;
+  return detail::make_unique_aligned_array<Elem, Align>(
+    size, [](Elem *ptr, std::size_t count) { std::uninitialized_default_construct_n(ptr, count); });
+}
+
+template<typename T, std::size_t Align = cache_line_size, class... Types>
+  requires std::is_bounded_array_v<T>
+void make_unique_aligned_for_overwrite(Types &&...) = delete;
+
+RAII_NS_END
+
+#endif// RAII_ALIGNED_DELETE_HPP
@@ -0,0 +1,277 @@
+// allocator_delete and allocate_unique for unique_ptr -*- C++ -*-
+
+#ifndef RAII_ALLOCATE_UNIQUE_HPP
+#define RAII_ALLOCATE_UNIQUE_HPP
+
+#include "compressed_pair.hpp"
+#include "raii_defs.hpp"
+#include "unique_ptr.hpp"
+
+#include <cstddef>// std::size_t
+#include <memory>// std::allocator_traits, std::destroy_at, std::construct_at
+#include <type_traits>
+#include <utility>// std::forward
+
+
+RAII_NS_BEGIN
+
+namespace detail {
+
+  // Holds an allocator, empty allocators are stored as a base class (EBO), so that allocator_delete stays empty too.
+  // Allocators, which are not assignable (e.g. std::pmr::polymorphic_allocator), are re-constructed on assignment,
+  // because unique_ptr move assignment assigns the deleter
+  template<typename Alloc, bool = ebo_eligible<Alloc>> class allocator_holder
+  {
+  public:
+    constexpr allocator_holder() noexcept
+      requires std::is_default_constructible_v<Alloc>
+    = default;
+
+    raii_inline constexpr explicit allocator_holder(const Alloc &alloc) noexcept : alloc_{ alloc } {}
+
+    constexpr allocator_holder(const allocator_holder &) noexcept = default;
+
+    // cppcheck-suppress operatorEqVarError; alloc_ is re-constructed in place
+    raii_inline constexpr allocator_holder &operator=(const allocator_holder &rhs) noexcept
+    {
+      if constexpr (std::is_copy_assignable_v<Alloc>) {
+        alloc_ = rhs.alloc_;
+      } else if (this != &rhs) {
+        std::destroy_at(&alloc_);
+        std::construct_at(&alloc_, rhs.alloc_);
+      }
+      return *this;
+    }
+
+    constexpr ~allocator_holder() noexcept = default;
+
+    [[nodiscard]] raii_inline constexpr Alloc &allocator() noexcept { return alloc_; }
+
+    [[nodiscard]] raii_inline constexpr const Alloc &allocator() const noexcept { return alloc_; }
+
+  private:
+    Alloc alloc_;
+  };
+
+  template<typename Alloc> class allocator_holder<Alloc, true> : private Alloc
+  {
+  public:
+    constexpr allocator_holder() noexcept
+      requires std::is_default_constructible_v<Alloc>
+    = default;
+
+    raii_inline constexpr explicit allocator_holder(const Alloc &alloc) noexcept : Alloc(alloc) {}
+
+    [[nodiscard]] raii_inline constexpr Alloc &allocator() noexcept { return *this; }
+
+    [[nodiscard]] raii_inline constexpr const Alloc &allocator() const noexcept { return *this; }
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief Destroys an object and deallocates its memory via a copy of the allocator, which allocated it.
+ * Stateless allocators (e.g. std::allocator) take no storage, so unique_ptr keeps the size of a pointer.
+ * @tparam T the type of the object
+ * @tparam Alloc allocator, it is rebound to T
+ * @note With std::pmr::polymorphic_allocator, destructors are still run, even if the memory resource
+ * (e.g. std::pmr::monotonic_buffer_resource) ignores deallocation
+ **/
+template<typename T, typename Alloc>
+class allocator_delete
+  : private detail::allocator_holder<typename std::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+public:
+  using allocator_type = std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+private:
+  using Base = detail::allocator_holder<allocator_type>;
+  using traits = std::allocator_traits<allocator_type>;
+
+  static_assert(std::is_same_v<typename traits::pointer, T *>, "fancy pointers are not supported");
+
+public:
+  constexpr allocator_delete() noexcept
+    requires std::is_default_constructible_v<allocator_type>
+  = default;
+
+  raii_inline constexpr explicit allocator_delete(const allocator_type &alloc) noexcept : Base(alloc) {}
+
+  [[nodiscard]] raii_inline constexpr allocator_type get_allocator() const noexcept { return Base::allocator(); }
+
+  raii_inline constexpr void operator()(T *ptr) noexcept
+  {
+    // cppcheck-suppress sizeofVoid;
+    // NOLINTNEXTLINE(bugprone-sizeof-expression)
+    static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type");
+
+    traits::destroy(Base::allocator(), ptr);
+    traits::deallocate(Base::allocator(), ptr, 1);
+  }
+};
+
+/**
+ * @brief Destroys and deallocates an array allocated via Alloc. Allocator deallocate() needs the element count,
+ * so the deleter stores it alongside the allocator
+ * @note unique_ptr::reset(p) doesn't update the stored count, replace the whole owner instead
+ **/
+template<typename T, typename Alloc>
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+class allocator_delete<T[], Alloc>
+{
+public:
+  using allocator_type = std::allocator_traits<Alloc>::template rebind_alloc<T>;
+  using size_type = std::size_t;
+
+private:
+  using traits = std::allocator_traits<allocator_type>;
+
+  static_assert(std::is_same_v<typename traits::pointer, T *>, "fancy pointers are not supported");
+
+public:
+  raii_inline constexpr allocator_delete() noexcept
+    requires std::is_default_constructible_v<allocator_type>
+    : size_alloc_{ size_type{ 0 }, holder{} }
+  {}
+
+  raii_inline constexpr allocator_delete(const allocator_type &alloc, size_type size) noexcept
+    : size_alloc_{ size, holder{ alloc } }
+  {}
+
+  [[nodiscard]] raii_inline constexpr allocator_type get_allocator() const noexcept
+  { return size_alloc_.second().allocator(); }
+
+  /// @brief Number of elements in the owned array
+  [[nodiscard]] raii_inline constexpr size_type size() const noexcept { return size_alloc_.first(); }
+
+  raii_inline constexpr void operator()(T *ptr) noexcept
+  {
+    // cppcheck-suppress sizeofVoid;
+    // NOLINTNEXTLINE(bugprone-sizeof-expression)
+    static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type");
+
+    auto &alloc = size_alloc_.second().allocator();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (size_type i = size(); i != 0; --i) { traits::destroy(alloc, ptr + (i - 1)); }
+    traits::deallocate(alloc, ptr, size());
+  }
+
+private:
+  using holder = detail::allocator_holder<allocator_type>;
+
+  detail::compressed_pair<size_type, holder> size_alloc_;
+};
+
+
+/// @brief unique_ptr returned by allocate_unique, the allocator is rebound to the element type, e.g.
+/// `allocated_unique_ptr<Node, std::pmr::polymorphic_allocator<>>`
+template<typename T, typename Alloc>
+using allocated_unique_ptr = unique_ptr<T,
+  allocator_delete<T, typename std::allocator_traits<Alloc>::template rebind_alloc<std::remove_extent_t<T>>>>;
+
+
+namespace detail {
+
+  template<typename T, typename Alloc, typename Init>
+  [[nodiscard]] raii_inline constexpr allocated_unique_ptr<T, Alloc> allocate_unique_single(const Alloc &alloc,
+    Init init)
+  {
+    using deleter = allocated_unique_ptr<T, Alloc>::deleter_type;
+    using traits = std::allocator_traits<typename deleter::allocator_type>;
+
+    typename deleter::allocator_type rebound{ alloc };
+    T *const ptr = traits::allocate(rebound, 1);
+    try {
+      init(rebound, ptr);
+    } catch (...) {
+      traits::deallocate(rebound, ptr, 1);
+      throw;
+    }
+    return allocated_unique_ptr<T, Alloc>{ ptr, deleter{ rebound } };
+  }
+
+  template<typename T, typename Alloc, typename Init>
+  [[nodiscard]] raii_inline constexpr allocated_unique_ptr<T, Alloc>
+    allocate_unique_array(const Alloc &alloc, std::size_t size, Init init)
+  {
+    using Elem = std::remove_extent_t<T>;
+    using deleter = allocated_unique_ptr<T, Alloc>::deleter_type;
+    using traits = std::allocator_traits<typename deleter::allocator_type>;
+
+    typename deleter::allocator_type rebound{ alloc };
+    Elem *const ptr = traits::allocate(rebound, size);
+
+    std::size_t constructed = 0;
+    try {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      for (; constructed != size; ++constructed) { init(rebound, ptr + constructed); }
+    } catch (...) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      for (; constructed != 0; --constructed) { traits::destroy(rebound, ptr + (constructed - 1)); }
+      traits::deallocate(rebound, ptr, size);
+      throw;
+    }
+    return allocated_unique_ptr<T, Alloc>{ ptr, deleter{ rebound, size } };
+  }
+
+}// namespace detail
+
+
+// allocate_unique and allocate_unique_for_overwrite
+
+/// @brief Creates an object via allocator_traits<Alloc>::construct, i.e. with uses-allocator construction for
+/// std::pmr::polymorphic_allocator
+template<class T, class Alloc, class... Types>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline constexpr allocated_unique_ptr<T, Alloc> allocate_unique(const Alloc &alloc,
+  Types &&...Args)
+{
+  return detail::allocate_unique_single<T>(alloc, [&](auto &rebound, T *ptr) {
+    std::allocator_traits<std::remove_reference_t<decltype(rebound)>>::construct(
+      rebound, ptr, std::forward<Types>(Args)...);
+  });
+}
+
+/// @brief Creates an array of size value-initialised elements
+template<class T, class Alloc>
+  requires std::is_unbounded_array_v<T>
+[[nodiscard]] raii_inline constexpr allocated_unique_ptr<T, Alloc> allocate_unique(const Alloc &alloc,
+  const std::size_t size)
+{
+  return detail::allocate_unique_array<T>(alloc, size, [](auto &rebound, std::remove_extent_t<T> *ptr) {
+    std::allocator_traits<std::remove_reference_t<decltype(rebound)>>::construct(rebound, ptr);
+  });
+}
+
+template<class T, class Alloc, class... Types>
+  requires std::is_bounded_array_v<T>
+void allocate_unique(const Alloc &, Types &&...) = delete;
+
+/// @brief Creates a default-initialised object, allocator construct() is bypassed
+template<typename T, class Alloc>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline allocated_unique_ptr<T, Alloc> allocate_unique_for_overwrite(const Alloc &alloc)
+{
+  return detail::allocate_unique_single<T>(
+    alloc, [](auto & /*rebound*/, T *ptr) { ::new (static_cast<void *>(ptr)) T; });
+}
+
+/// @brief Creates an array of size default-initialised elements, allocator construct() is bypassed
+template<typename T, class Alloc>
+  requires std::is_unbounded_array_v<T>
+[[nodiscard]] raii_inline allocated_unique_ptr<T, Alloc> allocate_unique_for_overwrite(const Alloc &alloc,
+  const std::size_t size)
+{
+  using Elem = std::remove_extent_t<T>;
+  return detail::allocate_unique_array<T>(
+    alloc, size, [](auto & /*rebound*/, Elem *ptr) { ::new (static_cast<void *>(ptr)) Elem; });
+}
+
+template<typename T, class Alloc, class... Types>
+  requires std::is_bounded_array_v<T>
+void allocate_unique_for_overwrite(const Alloc &, Types &&...) = delete;
+
+RAII_NS_END
+
+#endif// RAII_ALLOCATE_UNIQUE_HPP
@@ -0,0 +1,263 @@
+// arena bump allocator and arena_delete for unique_ptr -*- C++ -*-
+
+#ifndef RAII_ARENA_HPP
+#define RAII_ARENA_HPP
+
+#include "raii_defs.hpp"
+#include "unique_ptr.hpp"
+
+#include <algorithm>// std::max
+#include <bit>// std::has_single_bit
+#include <cassert>
+#include <cstddef>// std::size_t, std::byte, std::max_align_t
+#include <cstdint>// std::uintptr_t
+#include <limits>
+#include <memory>// std::destroy_at, std::uninitialized_value_construct_n
+#include <new>// std::bad_array_new_length
+#include <type_traits>
+#include <utility>// std::forward, std::exchange
+
+
+RAII_NS_BEGIN
+
+/**
+ * @brief Bump allocator, which hands out memory from a list of chunks and frees all of them at once.
+ * Individual allocations are never freed, so objects placed in an arena are released by running their destructors
+ * only, see arena_delete.
+ * @note Not thread-safe, use one arena per thread or per request
+ * @note All objects allocated from the arena must be destroyed before reset(), release() or the arena destructor
+ **/
+class arena
+{
+public:
+  static constexpr std::size_t default_chunk_size = 4096;
+  static constexpr std::size_t max_chunk_size = std::size_t{ 1 } << 20U;
+
+  /// @brief Creates an empty arena, memory is allocated on the first allocate() call
+  /// @param chunk_size size of the first chunk, subsequent chunks grow twice up to max_chunk_size
+  raii_inline explicit arena(std::size_t chunk_size = default_chunk_size) noexcept : next_chunk_size_{ chunk_size } {}
+
+  arena(const arena &) = delete;
+  arena &operator=(const arena &) = delete;
+
+  raii_inline arena(arena &&src) noexcept
+    : head_{ std::exchange(src.head_, nullptr) }, cur_{ std::exchange(src.cur_, nullptr) },
+      end_{ std::exchange(src.end_, nullptr) }, next_chunk_size_{ src.next_chunk_size_ }
+  {}
+
+  arena &operator=(arena &&) = delete;
+
+  raii_inline ~arena() noexcept { release(); }
+
+  /// @brief Returns size bytes aligned to align, never returns nullptr
+  /// @throw std::bad_alloc if a new chunk cannot be allocated
+  [[nodiscard]] raii_inline void *allocate(std::size_t size, std::size_t align = alignof(std::max_align_t))
+  {
+    assert(std::has_single_bit(align) && "alignment must be a power of two");
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+    const auto cur = reinterpret_cast<std::uintptr_t>(cur_);
+    const auto end = reinterpret_cast<std::uintptr_t>(end_);
+    const std::uintptr_t aligned = (cur + (align - 1)) & ~(std::uintptr_t{ align } - 1);
+    if (cur_ != nullptr && aligned <= end && size <= end - aligned) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      cur_ += (aligned - cur) + size;
+      return reinterpret_cast<void *>(aligned);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+    return allocate_slow(size, align);
+  }
+
+  /// @brief Makes all memory available again, keeps only the most recently allocated chunk
+  raii_inline void reset() noexcept
+  {
+    if (head_ == nullptr) { return; }
+
+    free_chunks(head_->next);
+    head_->next = nullptr;
+    cur_ = head_->data();
+    end_ = head_->end();
+  }
+
+  /// @brief Frees all chunks
+  raii_inline void release() noexcept
+  {
+    free_chunks(head_);
+    head_ = nullptr;
+    cur_ = nullptr;
+    end_ = nullptr;
+  }
+
+  /// @brief Number of chunks currently held by the arena
+  [[nodiscard]] raii_inline std::size_t chunk_count() const noexcept
+  {
+    std::size_t count = 0;
+    for (const chunk *cur = head_; cur != nullptr; cur = cur->next) { ++count; }
+    return count;
+  }
+
+  /// @brief Bytes, which can be allocated from the current chunk without allocating a new one
+  [[nodiscard]] raii_inline std::size_t available() const noexcept
+  { return static_cast<std::size_t>(end_ - cur_); }
+
+private:
+  struct alignas(std::max_align_t) chunk
+  {
+    chunk *next;
+    std::size_t size;
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+    [[nodiscard]] std::byte *data() noexcept { return reinterpret_cast<std::byte *>(this) + sizeof(chunk); }
+
+    [[nodiscard]] std::byte *end() noexcept { return reinterpret_cast<std::byte *>(this) + size; }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+  };
+
+  static void free_chunks(chunk *cur) noexcept
+  {
+    while (cur != nullptr) {
+      chunk *const next = cur->next;
+      ::operator delete(static_cast<void *>(cur), cur->size);
+      cur = next;
+    }
+  }
+
+  // Allocates a new chunk large enough for size bytes aligned to align, and allocates from it
+  void *allocate_slow(std::size_t size, std::size_t align)
+  {
+    constexpr std::size_t max_size = std::numeric_limits<std::size_t>::max();
+    if (size > max_size - sizeof(chunk) - align) { throw std::bad_array_new_length{}; }
+
+    const std::size_t chunk_size = std::max(next_chunk_size_, sizeof(chunk) + size + align);
+    auto *const fresh = static_cast<chunk *>(::operator new(chunk_size));
+    fresh->next = head_;
+    fresh->size = chunk_size;
+
+    head_ = fresh;
+    cur_ = fresh->data();
+    end_ = fresh->end();
+    next_chunk_size_ = std::min(next_chunk_size_ * 2, std::max(max_chunk_size, next_chunk_size_));
+
+    return allocate(size, align);
+  }
+
+  chunk *head_{ nullptr };
+  std::byte *cur_{ nullptr };
+  std::byte *end_{ nullptr };
+  std::size_t next_chunk_size_;
+};
+
+
+/**
+ * @brief Runs the destructor of an object placed in an arena, memory is reclaimed by the arena itself.
+ * Stateless, therefore unique_ptr<T, arena_delete<T>> has the size of a pointer
+ * @note For trivially destructible T the deleter does nothing, therefore it opts in to accepts_invalid_handle
+ * and the owner skips the ownership check
+ **/
+template<typename T> struct arena_delete
+{
+  static constexpr bool accepts_invalid_handle = std::is_trivially_destructible_v<T>;
+
+  constexpr arena_delete() noexcept = default;
+
+  template<typename U>
+    requires std::is_convertible_v<U *, T *>
+  // cppcheck-suppress noExplicitConstructor; intended converting constructor
+  // NOLINTNEXTLINE(hicpp-explicit-conversions)
+  raii_inline constexpr arena_delete(const arena_delete<U> & /*src*/) noexcept
+  {}
+
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static constexpr void operator()(T *ptr) noexcept
+#else
+  raii_inline constexpr void operator()(T *ptr) const noexcept
+#endif
+  {
+    // cppcheck-suppress sizeofVoid;
+    // NOLINTNEXTLINE(bugprone-sizeof-expression)
+    static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type");
+
+    if constexpr (!std::is_trivially_destructible_v<T>) { std::destroy_at(ptr); }
+  }
+};
+
+/// @brief Array form, element count is not stored, therefore elements must be trivially destructible
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays)
+template<typename T> struct arena_delete<T[]>
+{
+  static_assert(std::is_trivially_destructible_v<T>, "arena array elements must be trivially destructible");
+
+  static constexpr bool accepts_invalid_handle = true;
+
+  constexpr arena_delete() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static constexpr void operator()(T * /*ptr*/) noexcept
+#else
+  raii_inline constexpr void operator()(T * /*ptr*/) const noexcept
+#endif
+  {}
+};
+
+template<typename T> using arena_unique_ptr = unique_ptr<T, arena_delete<T>>;
+
+
+// make_arena_unique and make_arena_unique_for_overwrite
+
+template<class T, class... Types>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline arena_unique_ptr<T> make_arena_unique(arena &mem, Types &&...Args)
+{
+  // Memory is owned by the arena, nothing to free if the constructor throws
+  // NOLINTNEXTLINE(clang-diagnostic-missing-field-initializers)
+  return arena_unique_ptr<T>{ ::new (mem.allocate(sizeof(T), alignof(T))) T{ std::forward<Types>(Args)... } };
+}
+
+template<class T>
+  requires std::is_unbounded_array_v<T>
+[[nodiscard]] raii_inline arena_unique_ptr<T> make_arena_unique(arena &mem, const std::size_t size)
+{
+  using Elem = std::remove_extent_t<T>;
+  if (size > std::numeric_limits<std::size_t>::max() / sizeof(Elem)) { throw std::bad_array_new_length{}; }
+
+  auto *const ptr = static_cast<Elem *>(mem.allocate(size * sizeof(Elem), alignof(Elem)));
+  std::uninitialized_value_construct_n(ptr, size);
+  return arena_unique_ptr<T>{ ptr };
+}
+
+template<class T, class... Types>
+  requires std::is_bounded_array_v<T>
+void make_arena_unique(arena &, Types &&...) = delete;
+
+template<typename T>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline arena_unique_ptr<T> make_arena_unique_for_overwrite(arena &mem)
+{
+  // with default initialization
+  return arena_unique_ptr<T>{ ::new (mem.allocate(sizeof(T), alignof(T))) T };
+}
+
+template<typename T>
+  requires std::is_unbounded_array_v<T>
+[[nodiscard]] raii_inline arena_unique_ptr<T> make_arena_unique_for_overwrite(arena &mem, const std::size_t size)
+{
+  using Elem = std::remove_extent_t<T>;
+  if (size > std::numeric_limits<std::size_t>::max() / sizeof(Elem)) { throw std::bad_array_new_length{}; }
+
+  auto *const ptr = static_cast<Elem *>(mem.allocate(size * sizeof(Elem), alignof(Elem)));
+  // only memory allocation
+  std::uninitialized_default_construct_n(ptr, size);
+  return arena_unique_ptr<T>{ ptr };
+}
+
+template<typename T, class... Types>
+  requires std::is_bounded_array_v<T>
+void make_arena_unique_for_overwrite(arena &, Types &&...) = delete;
+
+RAII_NS_END
+
+#endif// RAII_ARENA_HPP
@@ -0,0 +1,248 @@
+// Releasing handles on a background closer thread -*- C++ -*-
+
+#ifndef RAII_ASYNC_DELETE_HPP
+#define RAII_ASYNC_DELETE_HPP
+
+#include "bounded_queue.hpp"
+#include "raii_defs.hpp"
+
+#include <atomic>
+#include <cstddef>// std::size_t, std::byte
+#include <cstdint>// std::uint32_t, std::uint64_t
+#include <cstring>// std::memcpy
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+
+RAII_NS_BEGIN
+
+namespace detail {
+
+  /**
+   * @brief Handle queued for the closer thread together with the function, which releases it.
+   *
+   * The handle is copied into the request by value, the deleter is stateless and default constructed on the closer
+   * thread, so requests of any deleter fit into a single trivially copyable slot.
+   **/
+  struct close_request
+  {
+    static constexpr std::size_t storage_size = 2 * sizeof(void *);
+
+    void (*release)(const std::byte *storage) noexcept;
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+    alignas(void *) std::byte storage[storage_size];
+
+    template<class Deleter, typename Handle> [[nodiscard]] static close_request make(Handle hnd) noexcept
+    {
+      close_request req{ &release_as<Deleter, Handle>, {} };
+      std::memcpy(static_cast<void *>(req.storage), &hnd, sizeof(Handle));
+      return req;
+    }
+
+    void operator()() const noexcept { release(storage); }
+
+    template<class Deleter, typename Handle> static void release_as(const std::byte *storage) noexcept
+    {
+      Handle hnd;// NOLINT(cppcoreguidelines-init-variables)
+      std::memcpy(&hnd, storage, sizeof(Handle));
+      Deleter{}(hnd);
+    }
+  };
+
+  template<class Deleter, typename Handle>
+  concept async_releasable = std::is_empty_v<Deleter> && std::is_nothrow_default_constructible_v<Deleter>
+                             && std::is_nothrow_invocable_v<Deleter &, Handle> && std::is_trivially_copyable_v<Handle>
+                             && (sizeof(Handle) <= close_request::storage_size)
+                             && (alignof(Handle) <= alignof(void *));
+
+}// namespace detail
+
+
+/**
+ * @brief Dedicated thread, which releases handles handed over by other threads, e.g. calls fclose, which flushes
+ * and may block for milliseconds on a slow or a network file system.
+ *
+ * Producers push into a bounded lock-free queue and wake the closer only when it sleeps. If the queue is full,
+ * the handle is released synchronously by the caller, so the memory and the number of open handles stay bounded.
+ * The destructor releases the handles still queued and joins the thread.
+ **/
+class async_closer
+{
+public:
+  static constexpr std::size_t default_capacity = 4096;
+
+  /// @param capacity maximum number of queued handles, rounded up to a power of two
+  explicit async_closer(std::size_t capacity = default_capacity)
+    : queue_{ capacity }, thread_{ [this] { run(); } }
+  {}
+
+  async_closer(const async_closer &) = delete;
+  async_closer &operator=(const async_closer &) = delete;
+  async_closer(async_closer &&) = delete;
+  async_closer &operator=(async_closer &&) = delete;
+
+  ~async_closer()
+  {
+    stop_.store(true, std::memory_order_release);
+    wake();
+    thread_.join();
+  }
+
+  /**
+   * @brief Closer used by raii::async_delete, started on the first use. Handles released while the static objects
+   * are being destroyed, after the closer is gone, are released synchronously.
+   **/
+  [[nodiscard]] static async_closer *global() noexcept;
+
+  /// @brief Queues hnd to be released by Deleter{}(hnd) on the closer thread, releases it inline, if the queue is full
+  template<class Deleter, typename Handle>
+    requires detail::async_releasable<Deleter, Handle>
+  void close(Handle hnd) noexcept
+  {
+    if (queue_.try_push(detail::close_request::make<Deleter>(hnd))) {
+      wake();
+      return;
+    }
+    closed_inline_.fetch_add(1, std::memory_order_relaxed);
+    Deleter{}(hnd);
+  }
+
+  /// @brief Blocks until every handle queued before the call is released
+  void flush() noexcept
+  {
+    // Barriers run in the order of the queue, so once as many of them as tickets taken up to this one are done,
+    // one of them belongs to this or a later ticket. The queue claims slots with relaxed operations, the acq_rel
+    // ticket makes a thread, which takes a later ticket, see the slots of the handles queued here before the call,
+    // so its barrier gets a later slot
+    const std::uint64_t ticket = flush_tickets_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    const auto barrier = detail::close_request::make<flush_signal>(this);
+    // The barrier is not a handle, it has to wait for a free slot instead of running inline
+    while (!queue_.try_push(barrier)) { std::this_thread::yield(); }
+    wake();
+    for (std::uint64_t done = flushed_.load(std::memory_order_acquire); done < ticket;
+         done = flushed_.load(std::memory_order_acquire)) {
+      flushed_.wait(done, std::memory_order_acquire);
+    }
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return queue_.capacity(); }
+
+  /// @brief Returns number of handles released by the closer thread so far
+  [[nodiscard]] std::size_t closed_async() const noexcept { return closed_async_.load(std::memory_order_relaxed); }
+
+  /// @brief Returns number of handles released by the callers, because the queue was full
+  [[nodiscard]] std::size_t closed_inline() const noexcept { return closed_inline_.load(std::memory_order_relaxed); }
+
+private:
+  class global_instance;
+
+  // Released by the closer thread, once the requests queued before the barrier of flush() are done. The counter is
+  // a member of the closer, which outlives the flushing threads, so it is still there, when it is notified
+  struct flush_signal
+  {
+    void operator()(async_closer *closer) const noexcept
+    {
+      closer->flushed_.fetch_add(1, std::memory_order_release);
+      closer->flushed_.notify_all();
+    }
+  };
+
+  static constexpr auto flush_release = &detail::close_request::release_as<flush_signal, async_closer *>;
+
+  void wake() noexcept
+  {
+    wakeups_.fetch_add(1, std::memory_order_release);
+    wakeups_.notify_one();
+  }
+
+  void run() noexcept
+  {
+    for (;;) {
+      const std::uint32_t seen = wakeups_.load(std::memory_order_acquire);
+      while (const std::optional<detail::close_request> req = queue_.try_pop()) {
+        (*req)();
+        if (req->release != flush_release) { closed_async_.fetch_add(1, std::memory_order_relaxed); }
+      }
+      if (stop_.load(std::memory_order_acquire)) {
+        if (queue_.empty()) { return; }
+        continue;
+      }
+      // A push after the load of seen has bumped wakeups_ as well, so the wait returns right away
+      wakeups_.wait(seen, std::memory_order_acquire);
+    }
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  static inline std::atomic<bool> global_closed{ false };
+
+  bounded_queue<detail::close_request> queue_;
+  std::atomic<std::uint32_t> wakeups_{ 0 };
+  std::atomic<std::uint64_t> flush_tickets_{ 0 };
+  std::atomic<std::uint64_t> flushed_{ 0 };
+  std::atomic<bool> stop_{ false };
+  std::atomic<std::size_t> closed_async_{ 0 };
+  std::atomic<std::size_t> closed_inline_{ 0 };
+  std::thread thread_;
+};
+
+class async_closer::global_instance : public async_closer
+{
+public:
+  global_instance() = default;
+
+  global_instance(const global_instance &) = delete;
+  global_instance &operator=(const global_instance &) = delete;
+  global_instance(global_instance &&) = delete;
+  global_instance &operator=(global_instance &&) = delete;
+
+  ~global_instance() { global_closed.store(true, std::memory_order_release); }
+};
+
+inline async_closer *async_closer::global() noexcept
+{
+  if (global_closed.load(std::memory_order_acquire)) [[unlikely]] { return nullptr; }
+  static global_instance instance;
+  return &instance;
+}
+
+
+/**
+ * @brief Deleter adapter, which hands the handle over to the closer thread of raii::async_closer::global() instead
+ * of calling Deleter in the destructor of the owner.
+ * @tparam Deleter stateless deleter, its operator() is called on the closer thread, so it has to be safe to release
+ * the handle on another thread, e.g. stdio_fclose or deleter::posix::close_fd
+ * @note Empty like Deleter, so `unique_rc<FILE *, async_delete<stdio_fclose>>` keeps the size of FILE *
+ * @code
+ * using async_file = raii::unique_rc<FILE *, raii::async_delete<raii::stdio_fclose>>;
+ * // at shutdown, before the data has to be on disk
+ * raii::async_closer::global()->flush();
+ * @endcode
+ **/
+template<class Deleter>
+  requires std::is_empty_v<Deleter>
+struct async_delete
+{
+  constexpr async_delete() noexcept = default;
+
+  template<typename Handle>
+    requires detail::async_releasable<Deleter, Handle>
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static void operator()(Handle hnd) noexcept
+#else
+  raii_inline void operator()(Handle hnd) const noexcept
+#endif
+  {
+    if (async_closer *const closer = async_closer::global()) [[likely]] {
+      closer->template close<Deleter>(hnd);
+    } else {
+      Deleter{}(hnd);
+    }
+  }
+};
+
+RAII_NS_END
+
+#endif// RAII_ASYNC_DELETE_HPP
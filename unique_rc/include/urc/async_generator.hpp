@@ -0,0 +1,201 @@
+// Asynchronous generator, a producer coroutine, which may co_await between its values -*- C++ -*-
+
+#ifndef RAII_ASYNC_GENERATOR_HPP
+#define RAII_ASYNC_GENERATOR_HPP
+
+#include "frame_allocator.hpp"
+#include "raii_defs.hpp"
+#include "task.hpp"
+#include "unique_coroutine_handle.hpp"
+
+#include <concepts>
+#include <coroutine>
+#include <exception>// std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional>// std::invoke
+#include <memory>// std::addressof
+#include <type_traits>
+#include <utility>// std::move, std::exchange
+
+
+RAII_NS_BEGIN
+
+template<typename T> class async_generator;
+
+namespace detail {
+
+  /**
+   * @brief Promise of an asynchronous generator.
+   *
+   * The producer runs only, while the consumer awaits the next value, and hands control back by symmetric transfer,
+   * when it yields or finishes. In between it may co_await anything, e.g. I/O or a thread pool, the consumer is
+   * resumed on whichever thread the producer yields from.
+   **/
+  template<typename T> class async_generator_promise : public pooled_frame_promise
+  {
+  public:
+    async_generator<T> get_return_object() noexcept;
+
+    static std::suspend_always initial_suspend() noexcept { return {}; }
+
+    [[nodiscard]] static auto final_suspend() noexcept { return yield_awaiter{}; }
+
+    /// @brief Yields an lvalue or a temporary, which stays alive in the producer frame until the consumer asks again
+    [[nodiscard]] auto yield_value(T &val) noexcept
+    {
+      value_ = std::addressof(val);
+      return yield_awaiter{};
+    }
+
+    [[nodiscard]] auto yield_value(T &&val) noexcept
+    {
+      value_ = std::addressof(val);
+      return yield_awaiter{};
+    }
+
+    /// @brief Yields a copy of a const lvalue
+    [[nodiscard]] auto yield_value(const T &val) noexcept(std::is_nothrow_copy_constructible_v<T>)
+      requires std::copy_constructible<T>
+    {
+      return copy_awaiter{ T(val) };
+    }
+
+    static constexpr void return_void() noexcept {}
+
+    void unhandled_exception() noexcept { except_ = std::current_exception(); }
+
+  private:
+    friend class async_generator<T>;
+
+    struct yield_awaiter
+    {
+      static constexpr bool await_ready() noexcept { return false; }
+
+      [[nodiscard]] static std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<async_generator_promise> hnd) noexcept
+      { return hnd.promise().consumer_; }
+
+      static constexpr void await_resume() noexcept {}
+    };
+
+    struct copy_awaiter
+    {
+      T value;
+
+      static constexpr bool await_ready() noexcept { return false; }
+
+      [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<async_generator_promise> hnd) noexcept
+      {
+        hnd.promise().value_ = std::addressof(value);
+        return hnd.promise().consumer_;
+      }
+
+      static constexpr void await_resume() noexcept {}
+    };
+
+    T *value_{ nullptr };
+    std::coroutine_handle<> consumer_{ std::noop_coroutine() };
+    std::exception_ptr except_;
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief raii::async_generator is a lazily started producer coroutine, which may co_await between the values it
+ * yields. The consumer asks for each value with `co_await gen.next()`, the producer does not run ahead, so a slow
+ * consumer holds back the producer and nothing is buffered.
+ *
+ * The frame is owned by raii::unique_coroutine_handle and allocated from per-thread frame pools,
+ * see raii::pooled_frame_promise. A generator may be destroyed, whenever no next() is being awaited.
+ * @code
+ * raii::async_generator<std::string> chunks(file &in) { while (!in.eof()) { co_yield co_await in.read(4096); } }
+ * raii::task<> copy(file &in) { auto gen = chunks(in); while (std::string *chunk = co_await gen.next()) { ... } }
+ * @endcode
+ **/
+template<typename T> class async_generator
+{
+  static_assert(std::is_object_v<T> && !std::is_const_v<T>, "async_generator yields non-const objects");
+
+public:
+  using value_type = T;
+  using promise_type = detail::async_generator_promise<T>;
+  using handle = std::coroutine_handle<promise_type>;
+
+  async_generator() noexcept = default;
+
+  async_generator(async_generator &&) noexcept = default;
+  async_generator &operator=(async_generator &&) noexcept = default;
+
+  async_generator(const async_generator &) = delete;
+  async_generator &operator=(const async_generator &) = delete;
+
+  ~async_generator() = default;
+
+  [[nodiscard]] explicit operator bool() const noexcept { return static_cast<bool>(coro_); }
+
+  /// @brief Returns true, once the producer has finished
+  [[nodiscard]] bool done() const noexcept { return !coro_ || coro_.get().done(); }
+
+  /**
+   * @brief Awaitable, which resumes the producer until it yields the next value.
+   * @return pointer to the value, valid until next() is awaited again, or nullptr, once the producer has finished
+   * @throw exception thrown by the producer
+   **/
+  [[nodiscard]] auto next() noexcept
+  {
+    struct awaiter
+    {
+      handle coro;
+
+      [[nodiscard]] bool await_ready() const noexcept { return !coro || coro.done(); }
+
+      [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept
+      {
+        coro.promise().consumer_ = consumer;
+        return coro;
+      }
+
+      [[nodiscard]] T *await_resume() const
+      {
+        if (!coro) { return nullptr; }
+        promise_type &promise = coro.promise();
+        if (coro.done()) {
+          if (promise.except_) { std::rethrow_exception(std::exchange(promise.except_, nullptr)); }
+          return nullptr;
+        }
+        return promise.value_;
+      }
+    };
+    return awaiter{ coro_.get() };
+  }
+
+private:
+  friend promise_type;
+
+  explicit async_generator(handle coro) noexcept : coro_{ coro } {}
+
+  unique_coroutine_handle<promise_type> coro_;
+};
+
+template<typename T> async_generator<T> detail::async_generator_promise<T>::get_return_object() noexcept
+{ return async_generator<T>{ std::coroutine_handle<async_generator_promise>::from_promise(*this) }; }
+
+
+/**
+ * @brief Consumes an asynchronous generator, a `for co_await` loop: calls fn for every value and awaits the result of
+ * fn, if it returns raii::task
+ **/
+template<typename T, std::invocable<T &> Fn> task<> for_each(async_generator<T> gen, Fn fn)
+{
+  while (T *val = co_await gen.next()) {
+    if constexpr (std::is_void_v<std::invoke_result_t<Fn &, T &>>) {
+      std::invoke(fn, *val);
+    } else {
+      co_await std::invoke(fn, *val);
+    }
+  }
+}
+
+RAII_NS_END
+
+#endif// RAII_ASYNC_GENERATOR_HPP
@@ -0,0 +1,138 @@
+// Bounded lock-free multi-producer multi-consumer queue -*- C++ -*-
+
+#ifndef RAII_BOUNDED_QUEUE_HPP
+#define RAII_BOUNDED_QUEUE_HPP
+
+#include "raii_defs.hpp"
+
+#include <atomic>
+#include <bit>// std::bit_ceil
+#include <cstddef>// std::size_t, std::byte
+#include <memory>// std::unique_ptr, std::construct_at, std::destroy_at
+#include <new>// std::launder
+#include <optional>
+#include <type_traits>
+#include <utility>// std::move
+
+
+RAII_NS_BEGIN
+
+/**
+ * @brief Bounded multi-producer multi-consumer queue after Dmitry Vyukov's array-based design.
+ *
+ * Every slot carries a sequence number, which tells producers and consumers whose turn it is, so push and pop
+ * cost a single CAS on the shared position and no locks. Slots are padded to cache lines, neighbouring slots
+ * are written by different threads without false sharing.
+ * @tparam T element type, moving it must not throw, since an element is moved into a slot, once the slot is claimed
+ **/
+template<typename T> class bounded_queue
+{
+  static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>,
+    "bounded_queue element type must be nothrow move constructible and destructible");
+
+public:
+  static constexpr std::size_t cache_line = 64;
+
+  /// @param capacity maximum number of elements, rounded up to a power of two, at least 2
+  explicit bounded_queue(std::size_t capacity)
+    : mask_{ std::bit_ceil(capacity < 2 ? std::size_t{ 2 } : capacity) - 1 }, slots_{ new slot[mask_ + 1] }
+  {
+    for (std::size_t i = 0; i <= mask_; ++i) { slots_[i].sequence.store(i, std::memory_order_relaxed); }
+  }
+
+  bounded_queue(const bounded_queue &) = delete;
+  bounded_queue &operator=(const bounded_queue &) = delete;
+  bounded_queue(bounded_queue &&) = delete;
+  bounded_queue &operator=(bounded_queue &&) = delete;
+
+  ~bounded_queue()
+  {
+    while (try_pop()) {}
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+  /// @brief Moves value into the queue, value is left intact, if the queue is full
+  [[nodiscard]] bool try_push(T &&value) noexcept
+  {
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      slot &cur = slots_[pos & mask_];
+      const std::size_t seq = cur.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+          std::construct_at(reinterpret_cast<T *>(cur.storage), std::move(value));
+          cur.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  [[nodiscard]] bool try_push(const T &value) noexcept(std::is_nothrow_copy_constructible_v<T>)
+  {
+    T copy{ value };
+    return try_push(std::move(copy));
+  }
+
+  /// @brief Removes the oldest element, returns std::nullopt, if the queue is empty
+  [[nodiscard]] std::optional<T> try_pop() noexcept
+  {
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      slot &cur = slots_[pos & mask_];
+      const std::size_t seq = cur.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          std::optional<T> res{ std::move(*cur.value()) };
+          std::destroy_at(cur.value());
+          cur.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return res;
+        }
+      } else if (diff < 0) {
+        return std::nullopt;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Returns true, if the queue looked empty at the time of the call
+  [[nodiscard]] bool empty() const noexcept
+  {
+    const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    return static_cast<std::ptrdiff_t>(slots_[pos & mask_].sequence.load(std::memory_order_acquire) - (pos + 1)) < 0;
+  }
+
+private:
+  struct alignas(cache_line) slot
+  {
+    std::atomic<std::size_t> sequence;
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+    alignas(T) std::byte storage[sizeof(T)];
+
+    [[nodiscard]] T *value() noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return std::launder(reinterpret_cast<T *>(storage));
+    }
+  };
+
+  const std::size_t mask_;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  const std::unique_ptr<slot[]> slots_;
+
+  alignas(cache_line) std::atomic<std::size_t> enqueue_pos_{ 0 };
+  alignas(cache_line) std::atomic<std::size_t> dequeue_pos_{ 0 };
+};
+
+RAII_NS_END
+
+#endif// RAII_BOUNDED_QUEUE_HPP
@@ -0,0 +1,345 @@
+// Bounded channel between coroutines -*- C++ -*-
+
+#ifndef RAII_CHANNEL_HPP
+#define RAII_CHANNEL_HPP
+
+#include "bounded_queue.hpp"
+#include "raii_defs.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>// std::size_t
+#include <mutex>
+#include <optional>
+#include <utility>// std::move, std::exchange
+
+
+RAII_NS_BEGIN
+
+namespace detail {
+
+  /// @brief Intrusive FIFO of suspended coroutines, the nodes are the awaiters inside the suspended frames
+  template<typename Node> class waiter_list
+  {
+  public:
+    [[nodiscard]] bool empty() const noexcept { return head_ == nullptr; }
+
+    void push_back(Node *node) noexcept
+    {
+      node->next_ = nullptr;
+      if (tail_ == nullptr) {
+        head_ = node;
+      } else {
+        tail_->next_ = node;
+      }
+      tail_ = node;
+    }
+
+    void push_front(Node *node) noexcept
+    {
+      node->next_ = head_;
+      head_ = node;
+      if (tail_ == nullptr) { tail_ = node; }
+    }
+
+    [[nodiscard]] Node *pop_front() noexcept
+    {
+      Node *const node = head_;
+      if (node != nullptr) {
+        head_ = node->next_;
+        if (head_ == nullptr) { tail_ = nullptr; }
+      }
+      return node;
+    }
+
+    /// @brief Empties the list and returns its former head
+    [[nodiscard]] Node *take_all() noexcept
+    {
+      tail_ = nullptr;
+      return std::exchange(head_, nullptr);
+    }
+
+  private:
+    Node *head_{ nullptr };
+    Node *tail_{ nullptr };
+  };
+
+  // A coroutine registers itself as a waiter and retries the ring, the other side publishes to the ring and checks
+  // the number of waiters. Either the retry sees the slot or the check sees the waiter. TSan does not support fences,
+  // the registering RMW is enough there and the checking side uses an RMW instead of the fence.
+  template<typename Int> raii_inline void register_waiter(std::atomic<Int> &waiting) noexcept
+  {
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+#ifndef RAII_THREAD_SANITIZER
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+  template<typename Int> [[nodiscard]] raii_inline bool has_waiters(std::atomic<Int> &waiting) noexcept
+  {
+#ifdef RAII_THREAD_SANITIZER
+    return waiting.fetch_add(0, std::memory_order_seq_cst) != 0;
+#else
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return waiting.load(std::memory_order_seq_cst) != 0;
+#endif
+  }
+
+}// namespace detail
+
+
+/**
+ * @brief Bounded multi-producer multi-consumer channel between coroutines.
+ *
+ * Values go through a lock-free raii::bounded_queue, as long as it is neither full nor empty no lock is taken.
+ * A sender suspends on a full channel, a receiver on an empty one. Suspended coroutines are kept in intrusive lists
+ * of their awaiters, the channel allocates nothing per waiter. A waiter is resumed by the thread, which makes
+ * progress possible for it, with the value already received or sent on its behalf.
+ *
+ * close() resumes all waiters: suspended receivers get the values still in the channel or std::nullopt, suspended
+ * senders get false. The destructor closes the channel, so no coroutine stays suspended on a channel, which no
+ * longer exists. After they are resumed by the destructor, waiters must not use the channel again.
+ * @code
+ * raii::channel<int> ch{ 64 };
+ * raii::task<> produce(raii::channel<int> &ch) { for (int i = 0; i < 100; ++i) { co_await ch.send(i); } ch.close(); }
+ * raii::task<> consume(raii::channel<int> &ch)
+ * {
+ *   while (std::optional<int> val = co_await ch.receive()) { use(*val); }
+ * }
+ * @endcode
+ **/
+template<typename T> class channel
+{
+public:
+  class send_awaiter;
+  class receive_awaiter;
+
+  /// @param capacity number of values buffered, rounded up to a power of two, at least 2
+  explicit channel(std::size_t capacity) : queue_{ capacity } {}
+
+  channel(const channel &) = delete;
+  channel &operator=(const channel &) = delete;
+  channel(channel &&) = delete;
+  channel &operator=(channel &&) = delete;
+
+  ~channel() { close(); }
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return queue_.capacity(); }
+
+  [[nodiscard]] bool closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+  /// @brief Sends without suspending, value is left intact, if the channel is full or closed
+  [[nodiscard]] bool try_send(T &&value)
+  {
+    if (closed() || !queue_.try_push(std::move(value))) { return false; }
+    wake_receiver();
+    return true;
+  }
+
+  [[nodiscard]] bool try_send(const T &value)
+  {
+    T copy{ value };
+    return try_send(std::move(copy));
+  }
+
+  /// @brief Receives without suspending, returns std::nullopt, if the channel is empty
+  [[nodiscard]] std::optional<T> try_receive()
+  {
+    std::optional<T> res = queue_.try_pop();
+    if (res) { wake_sender(); }
+    return res;
+  }
+
+  /// @brief Awaitable, which returns true, once value is in the channel, or false, if the channel has been closed
+  [[nodiscard]] send_awaiter send(T value) noexcept { return send_awaiter{ *this, std::move(value) }; }
+
+  /// @brief Awaitable, which returns the next value or std::nullopt, if the channel is closed and empty
+  [[nodiscard]] receive_awaiter receive() noexcept { return receive_awaiter{ *this }; }
+
+  /// @brief Rejects further sends and resumes all suspended coroutines, values already sent can still be received
+  void close() noexcept
+  {
+    send_awaiter *senders = nullptr;
+    receive_awaiter *receivers = nullptr;
+    {
+      const std::lock_guard lock{ mutex_ };
+      closed_.store(true, std::memory_order_release);
+      senders = senders_.take_all();
+      receivers = receivers_.take_all();
+      waiting_senders_.store(0, std::memory_order_relaxed);
+      waiting_receivers_.store(0, std::memory_order_relaxed);
+    }
+    // The next node is read before resuming, the resumed coroutine may destroy its awaiter
+    while (senders != nullptr) {
+      send_awaiter *const next = senders->next_;
+      senders->sent_ = false;
+      senders->hnd_.resume();
+      senders = next;
+    }
+    while (receivers != nullptr) {
+      receive_awaiter *const next = receivers->next_;
+      receivers->result_ = queue_.try_pop();
+      receivers->hnd_.resume();
+      receivers = next;
+    }
+  }
+
+  class send_awaiter
+  {
+  public:
+    send_awaiter(const send_awaiter &) = delete;
+    send_awaiter &operator=(const send_awaiter &) = delete;
+    send_awaiter(send_awaiter &&) = delete;
+    send_awaiter &operator=(send_awaiter &&) = delete;
+    ~send_awaiter() = default;
+
+    [[nodiscard]] bool await_ready()
+    {
+      sent_ = chan_->try_send(std::move(value_));
+      return sent_ || chan_->closed();
+    }
+
+    bool await_suspend(std::coroutine_handle<> hnd) { return chan_->suspend_sender(*this, hnd); }
+
+    [[nodiscard]] bool await_resume() const noexcept { return sent_; }
+
+  private:
+    friend class channel;
+    friend class detail::waiter_list<send_awaiter>;
+
+    send_awaiter(channel &chan, T &&value) noexcept : chan_{ &chan }, value_{ std::move(value) } {}
+
+    channel *chan_;
+    send_awaiter *next_{ nullptr };
+    std::coroutine_handle<> hnd_;
+    T value_;
+    bool sent_{ false };
+  };
+
+  class receive_awaiter
+  {
+  public:
+    receive_awaiter(const receive_awaiter &) = delete;
+    receive_awaiter &operator=(const receive_awaiter &) = delete;
+    receive_awaiter(receive_awaiter &&) = delete;
+    receive_awaiter &operator=(receive_awaiter &&) = delete;
+    ~receive_awaiter() = default;
+
+    [[nodiscard]] bool await_ready()
+    {
+      // Values sent before close() are visible, once the closed flag is
+      const bool was_closed = chan_->closed();
+      result_ = chan_->try_receive();
+      return result_.has_value() || was_closed;
+    }
+
+    bool await_suspend(std::coroutine_handle<> hnd) { return chan_->suspend_receiver(*this, hnd); }
+
+    [[nodiscard]] std::optional<T> await_resume() noexcept { return std::move(result_); }
+
+  private:
+    friend class channel;
+    friend class detail::waiter_list<receive_awaiter>;
+
+    explicit receive_awaiter(channel &chan) noexcept : chan_{ &chan } {}
+
+    channel *chan_;
+    receive_awaiter *next_{ nullptr };
+    std::coroutine_handle<> hnd_;
+    std::optional<T> result_;
+  };
+
+private:
+  // The awaiter must not be touched, once it is in the list and the lock is released
+  bool suspend_sender(send_awaiter &waiter, std::coroutine_handle<> hnd)
+  {
+    std::unique_lock lock{ mutex_ };
+    if (closed_.load(std::memory_order_relaxed)) { return false; }
+
+    detail::register_waiter(waiting_senders_);
+    waiter.sent_ = queue_.try_push(std::move(waiter.value_));
+    if (!waiter.sent_) {
+      waiter.hnd_ = hnd;
+      senders_.push_back(&waiter);
+      return true;
+    }
+    waiting_senders_.fetch_sub(1, std::memory_order_relaxed);
+    lock.unlock();
+    wake_receiver();
+    return false;
+  }
+
+  bool suspend_receiver(receive_awaiter &waiter, std::coroutine_handle<> hnd)
+  {
+    std::unique_lock lock{ mutex_ };
+    detail::register_waiter(waiting_receivers_);
+    waiter.result_ = queue_.try_pop();
+    if (!waiter.result_ && !closed_.load(std::memory_order_relaxed)) {
+      waiter.hnd_ = hnd;
+      receivers_.push_back(&waiter);
+      return true;
+    }
+    waiting_receivers_.fetch_sub(1, std::memory_order_relaxed);
+    lock.unlock();
+    if (waiter.result_) { wake_sender(); }
+    return false;
+  }
+
+  // Called after a value has been pushed, hands a value to the oldest suspended receiver
+  void wake_receiver()
+  {
+    if (!detail::has_waiters(waiting_receivers_)) { return; }
+
+    receive_awaiter *waiter = nullptr;
+    {
+      const std::lock_guard lock{ mutex_ };
+      waiter = receivers_.pop_front();
+      if (waiter == nullptr) { return; }
+      waiter->result_ = queue_.try_pop();
+      if (!waiter->result_) {
+        // Another receiver was faster
+        receivers_.push_front(waiter);
+        return;
+      }
+      waiting_receivers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    wake_sender();
+    waiter->hnd_.resume();
+  }
+
+  // Called after a value has been popped, pushes the value of the oldest suspended sender
+  void wake_sender()
+  {
+    if (!detail::has_waiters(waiting_senders_)) { return; }
+
+    send_awaiter *waiter = nullptr;
+    {
+      const std::lock_guard lock{ mutex_ };
+      waiter = senders_.pop_front();
+      if (waiter == nullptr) { return; }
+      waiter->sent_ = queue_.try_push(std::move(waiter->value_));
+      if (!waiter->sent_) {
+        // Another sender was faster
+        senders_.push_front(waiter);
+        return;
+      }
+      waiting_senders_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    wake_receiver();
+    waiter->hnd_.resume();
+  }
+
+  bounded_queue<T> queue_;
+
+  alignas(bounded_queue<T>::cache_line) std::atomic<std::size_t> waiting_senders_{ 0 };
+  std::atomic<std::size_t> waiting_receivers_{ 0 };
+  std::atomic<bool> closed_{ false };
+
+  std::mutex mutex_;
+  detail::waiter_list<send_awaiter> senders_;
+  detail::waiter_list<receive_awaiter> receivers_;
+};
+
+RAII_NS_END
+
+#endif// RAII_CHANNEL_HPP
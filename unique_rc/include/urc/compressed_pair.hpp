@@ -0,0 +1,77 @@
+// compressed_pair implementation -*- C++ -*-
+
+#ifndef RAII_COMPRESSED_PAIR_HPP
+#define RAII_COMPRESSED_PAIR_HPP
+
+#include "raii_defs.hpp"
+
+#include <type_traits>
+#include <utility>// std::forward
+
+
+RAII_NS_BEGIN
+
+namespace detail {
+
+// Empty, non-final class types can be stored as a base class, which is guaranteed by the empty base optimisation
+// on every compiler, unlike layout of std::tuple which is implementation defined
+template<typename T>
+concept ebo_eligible = std::conjunction_v<std::is_class<T>, std::is_empty<T>, std::negation<std::is_final<T>>>;
+
+/**
+ * @brief Stores a handle and its deleter, so that a stateless deleter occupies no storage.
+ * Empty deleters are stored via EBO, the rest (including final ones and lvalue references) as a member marked
+ * RAII_NO_UNIQUE_ADDRESS
+ * @tparam First type of the first member, usually a handle
+ * @tparam Second type of the second member, usually a deleter
+ **/
+template<typename First, typename Second> class compressed_pair
+{
+public:
+  template<typename U1, typename U2>
+  raii_inline constexpr compressed_pair(U1 &&first, U2 &&second) noexcept(
+    std::is_nothrow_constructible_v<First, U1> && std::is_nothrow_constructible_v<Second, U2>)
+    : first_{ std::forward<U1>(first) }, second_{ std::forward<U2>(second) }
+  {}
+
+  [[nodiscard]] raii_inline constexpr First &first() noexcept { return first_; }
+
+  [[nodiscard]] raii_inline constexpr const First &first() const noexcept { return first_; }
+
+  [[nodiscard]] raii_inline constexpr Second &second() noexcept { return second_; }
+
+  [[nodiscard]] raii_inline constexpr const Second &second() const noexcept { return second_; }
+
+private:
+  First first_;
+  RAII_NO_UNIQUE_ADDRESS Second second_;
+};
+
+template<typename First, typename Second>
+  requires ebo_eligible<Second>
+class compressed_pair<First, Second> : private Second
+{
+public:
+  template<typename U1, typename U2>
+  raii_inline constexpr compressed_pair(U1 &&first, U2 &&second) noexcept(
+    std::is_nothrow_constructible_v<First, U1> && std::is_nothrow_constructible_v<Second, U2>)
+    : Second(std::forward<U2>(second)), first_{ std::forward<U1>(first) }
+  {}
+
+  [[nodiscard]] raii_inline constexpr First &first() noexcept { return first_; }
+
+  [[nodiscard]] raii_inline constexpr const First &first() const noexcept { return first_; }
+
+  [[nodiscard]] raii_inline constexpr Second &second() noexcept { return *this; }
+
+  [[nodiscard]] raii_inline constexpr const Second &second() const noexcept { return *this; }
+
+private:
+  First first_;
+};
+
+}// namespace detail
+
+RAII_NS_END
+
+#endif// RAII_COMPRESSED_PAIR_HPP
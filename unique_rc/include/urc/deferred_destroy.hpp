@@ -0,0 +1,242 @@
+// Deferred destruction of coroutine frames -*- C++ -*-
+
+#ifndef RAII_DEFERRED_DESTROY_HPP
+#define RAII_DEFERRED_DESTROY_HPP
+
+#include "raii_defs.hpp"
+#include "unique_coroutine_handle.hpp"
+
+#include <algorithm>// std::min
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>// std::size_t, std::ptrdiff_t
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>// std::move
+#include <vector>
+
+
+RAII_NS_BEGIN
+
+namespace detail {
+
+  /**
+   * @brief Per-thread queue of coroutine frames waiting to be destroyed.
+   *
+   * A frame is destroyed inline, if it is released while the calling thread is exiting and its queue is gone.
+   **/
+  class deferred_destroy_queue
+  {
+  public:
+    static constexpr std::size_t initial_capacity = 256;
+
+    deferred_destroy_queue(const deferred_destroy_queue &) = delete;
+    deferred_destroy_queue &operator=(const deferred_destroy_queue &) = delete;
+    deferred_destroy_queue(deferred_destroy_queue &&) = delete;
+    deferred_destroy_queue &operator=(deferred_destroy_queue &&) = delete;
+
+    raii_inline static void push(std::coroutine_handle<> hnd) noexcept
+    {
+      if (closed) [[unlikely]] {
+        hnd.destroy();
+        return;
+      }
+      try {
+        local().frames_.push_back(hnd);
+      } catch (...) {
+        // Out of memory, the frame is destroyed right away instead
+        hnd.destroy();
+      }
+    }
+
+    raii_inline static std::size_t drain(std::size_t limit) noexcept
+    {
+      if (closed) { return 0; }
+      return local().destroy_oldest(limit);
+    }
+
+    [[nodiscard]] raii_inline static std::size_t pending() noexcept { return closed ? 0 : local().frames_.size(); }
+
+    /// @brief Takes all pending frames of the calling thread at once
+    [[nodiscard]] raii_inline static std::vector<std::coroutine_handle<>> take()
+    {
+      if (closed) { return {}; }
+      std::vector<std::coroutine_handle<>> res;
+      res.reserve(initial_capacity);
+      res.swap(local().frames_);
+      return res;
+    }
+
+    raii_inline static void destroy_all(std::vector<std::coroutine_handle<>> &frames) noexcept
+    {
+      // A destroyed frame may release further deferred handles, they go to the queue of the destroying thread
+      for (const std::coroutine_handle<> hnd : frames) { hnd.destroy(); }
+      frames.clear();
+    }
+
+  private:
+    deferred_destroy_queue() { frames_.reserve(initial_capacity); }
+
+    ~deferred_destroy_queue() noexcept
+    {
+      while (!frames_.empty()) { destroy_oldest(frames_.size()); }
+      closed = true;
+    }
+
+    [[nodiscard]] static deferred_destroy_queue &local()
+    {
+      static thread_local deferred_destroy_queue queue;
+      return queue;
+    }
+
+    std::size_t destroy_oldest(std::size_t limit) noexcept
+    {
+      // Frames released by the destroyed ones are appended and picked up by the next drain
+      const std::size_t count = std::min(limit, frames_.size());
+      for (std::size_t i = 0; i != count; ++i) { frames_[i].destroy(); }
+      frames_.erase(frames_.begin(), frames_.begin() + static_cast<std::ptrdiff_t>(count));
+      return count;
+    }
+
+    std::vector<std::coroutine_handle<>> frames_;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    static inline thread_local bool closed{ false };
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief Deleter for unique_coroutine_handle, which postpones destruction of the frame, destructors of the locals
+ * in the frame and the deallocation, until the calling thread drains its queue with raii::drain_deferred_destroys()
+ * at a point of its choosing, e.g. in the idle loop or at the end of a tick, or hands it over to a
+ * raii::deferred_destroy_thread. Frames still queued are destroyed, when the thread exits.
+ **/
+struct deferred_coroutine_destroy
+{
+  constexpr deferred_coroutine_destroy() noexcept = default;
+
+  template<typename Promise>
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static void operator()(std::coroutine_handle<Promise> hnd) noexcept
+#else
+  raii_inline void operator()(std::coroutine_handle<Promise> hnd) const noexcept
+#endif
+  { detail::deferred_destroy_queue::push(hnd); }
+};
+
+template<typename Promise>
+using deferred_coroutine_handle = unique_coroutine_handle<Promise, deferred_coroutine_destroy>;
+
+/// @brief Destroys up to limit frames queued by the calling thread, the oldest first
+/// @return number of frames destroyed
+raii_inline std::size_t drain_deferred_destroys(std::size_t limit = std::numeric_limits<std::size_t>::max()) noexcept
+{ return detail::deferred_destroy_queue::drain(limit); }
+
+/// @brief Returns number of frames queued by the calling thread
+[[nodiscard]] raii_inline std::size_t pending_deferred_destroys() noexcept
+{ return detail::deferred_destroy_queue::pending(); }
+
+
+/**
+ * @brief Background thread, which destroys batches of frames handed over by other threads.
+ *
+ * Only suitable for coroutines, whose locals may be destroyed on another thread. Frames allocated by
+ * raii::pooled_frame_promise are returned to the pool of the thread, which allocated them.
+ **/
+class deferred_destroy_thread
+{
+public:
+  deferred_destroy_thread()
+    : thread_{ [this] { run(); } }
+  {}
+
+  deferred_destroy_thread(const deferred_destroy_thread &) = delete;
+  deferred_destroy_thread &operator=(const deferred_destroy_thread &) = delete;
+  deferred_destroy_thread(deferred_destroy_thread &&) = delete;
+  deferred_destroy_thread &operator=(deferred_destroy_thread &&) = delete;
+
+  /// @brief Destroys the remaining frames and joins the thread
+  ~deferred_destroy_thread()
+  {
+    {
+      const std::lock_guard lock{ mutex_ };
+      stop_ = true;
+    }
+    ready_.notify_one();
+    thread_.join();
+  }
+
+  /// @brief Moves the frames queued by the calling thread to the background thread, the cost does not depend
+  /// on the number of frames
+  void hand_off()
+  {
+    std::vector<std::coroutine_handle<>> frames = detail::deferred_destroy_queue::take();
+    if (frames.empty()) { return; }
+    {
+      const std::lock_guard lock{ mutex_ };
+      batches_.push_back(std::move(frames));
+    }
+    ready_.notify_one();
+  }
+
+  /// @brief Returns number of frames destroyed so far
+  [[nodiscard]] std::size_t destroyed() const
+  {
+    const std::lock_guard lock{ mutex_ };
+    return destroyed_;
+  }
+
+  /// @brief Blocks until all batches handed over so far have been destroyed
+  void wait_idle()
+  {
+    std::unique_lock lock{ mutex_ };
+    idle_.wait(lock, [this] { return batches_.empty() && !busy_; });
+  }
+
+private:
+  void run()
+  {
+    std::vector<std::vector<std::coroutine_handle<>>> work;
+    std::unique_lock lock{ mutex_ };
+    for (;;) {
+      ready_.wait(lock, [this] { return stop_ || !batches_.empty(); });
+      if (batches_.empty()) { break; }
+
+      work.swap(batches_);
+      busy_ = true;
+      lock.unlock();
+
+      std::size_t count = 0;
+      for (auto &batch : work) {
+        count += batch.size();
+        detail::deferred_destroy_queue::destroy_all(batch);
+      }
+      work.clear();
+      // Deferred handles released by the destroyed frames
+      while (const std::size_t nested = drain_deferred_destroys()) { count += nested; }
+
+      lock.lock();
+      busy_ = false;
+      destroyed_ += count;
+      idle_.notify_all();
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable idle_;
+  std::vector<std::vector<std::coroutine_handle<>>> batches_;
+  std::size_t destroyed_{ 0 };
+  bool busy_{ false };
+  bool stop_{ false };
+  std::thread thread_;
+};
+
+RAII_NS_END
+
+#endif// RAII_DEFERRED_DESTROY_HPP
@@ -0,0 +1,71 @@
+// Deleters for Linux specific file descriptors, epoll, eventfd, timerfd, signalfd and pidfd -*- C++ -*-
+
+#ifndef RAII_DELETER_LINUX_HPP
+#define RAII_DELETER_LINUX_HPP
+
+#include "deleter_posix.hpp"
+#include "raii_defs.hpp"
+#include "unique_rc.hpp"
+
+
+RAII_NS_BEGIN
+
+namespace deleter {
+namespace posix {
+
+  // All of them are released by close(), like any descriptor, and -1 marks an invalid one. The deleters differ only
+  // by type, so an epoll instance can't be passed where an eventfd is expected, each of them converts to close_fd,
+  // so they can be handed over to raii::unique_fd
+
+  /// @brief Closes an epoll instance created by epoll_create1
+  struct close_epoll : close_fd
+  {
+    constexpr close_epoll() noexcept = default;
+  };
+
+  /// @brief Closes an event counter created by eventfd
+  struct close_eventfd : close_fd
+  {
+    constexpr close_eventfd() noexcept = default;
+  };
+
+  /// @brief Closes a timer created by timerfd_create, disarming it
+  struct close_timerfd : close_fd
+  {
+    constexpr close_timerfd() noexcept = default;
+  };
+
+  /// @brief Closes a descriptor created by signalfd, the signals stay blocked
+  struct close_signalfd : close_fd
+  {
+    constexpr close_signalfd() noexcept = default;
+  };
+
+  /// @brief Closes a process descriptor created by pidfd_open or clone3 with CLONE_PIDFD, the process is not killed
+  struct close_pidfd : close_fd
+  {
+    constexpr close_pidfd() noexcept = default;
+  };
+
+}// namespace posix
+}// namespace deleter
+
+
+using unique_epoll =
+  unique_rc<int, deleter::posix::close_epoll, resolve_handle_type, int, deleter::posix::invalid_fd_policy>;
+
+using unique_eventfd =
+  unique_rc<int, deleter::posix::close_eventfd, resolve_handle_type, int, deleter::posix::invalid_fd_policy>;
+
+using unique_timerfd =
+  unique_rc<int, deleter::posix::close_timerfd, resolve_handle_type, int, deleter::posix::invalid_fd_policy>;
+
+using unique_signalfd =
+  unique_rc<int, deleter::posix::close_signalfd, resolve_handle_type, int, deleter::posix::invalid_fd_policy>;
+
+using unique_pidfd =
+  unique_rc<int, deleter::posix::close_pidfd, resolve_handle_type, int, deleter::posix::invalid_fd_policy>;
+
+RAII_NS_END
+
+#endif// RAII_DELETER_LINUX_HPP
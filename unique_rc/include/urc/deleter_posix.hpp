@@ -0,0 +1,236 @@
+// Deleters and invalid handle policies for POSIX file descriptors, mappings, directories, shared objects and
+// memory allocated by the C library -*- C++ -*-
+
+#ifndef RAII_DELETER_POSIX_HPP
+#define RAII_DELETER_POSIX_HPP
+
+#include "raii_defs.hpp"
+#include "unique_rc.hpp"
+
+#include <dirent.h>// closedir
+#include <dlfcn.h>// dlclose
+#include <netdb.h>// freeaddrinfo
+#include <sys/mman.h>// munmap, MAP_FAILED
+#include <unistd.h>
+
+#include <algorithm>// std::ranges::swap
+#include <cstddef>// std::size_t
+#include <cstdlib>// std::free
+#include <type_traits>// std::remove_cv_t
+
+
+RAII_NS_BEGIN
+
+namespace deleter {
+namespace posix {
+
+  /**
+   * @brief Closes a file descriptor returned by open, openat, socket, pipe, dup, etc.
+   * @note The descriptor is released even if close() reports an error, so the result is ignored,
+   * see NOTES in close(2)
+   **/
+  struct close_fd
+  {
+    constexpr close_fd() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(int fd) noexcept
+#else
+    raii_inline void operator()(int fd) const noexcept
+#endif
+    { static_cast<void>(::close(fd)); }
+  };
+
+
+  /**
+   * @brief File descriptors are marked invalid by -1, zero is a valid descriptor (stdin)
+   * @tparam Handle type of system resource, usually int
+   * @tparam Invalid invalid handle type, same as Handle
+   **/
+  template<typename Handle, typename Invalid> struct invalid_fd_policy
+  {
+    using invalid_type = Invalid;
+
+    [[nodiscard]] raii_inline static constexpr invalid_type invalid() noexcept { return -1; }
+
+    [[nodiscard]] raii_inline static constexpr bool is_owned(Handle hnd) noexcept { return hnd >= 0; }
+
+    /// @brief Disabled because policy provides only typedefs and static methods
+    constexpr invalid_fd_policy() = delete;
+    constexpr ~invalid_fd_policy() = delete;
+
+    constexpr invalid_fd_policy(const invalid_fd_policy &) = delete;
+    constexpr invalid_fd_policy &operator=(const invalid_fd_policy &) = delete;
+
+    constexpr invalid_fd_policy(invalid_fd_policy &&) = delete;
+    constexpr invalid_fd_policy &operator=(invalid_fd_policy &&) = delete;
+  };
+
+
+  /**
+   * @brief Unmaps a memory mapping created by mmap, the handle keeps the length munmap() needs next to the address
+   **/
+  struct unmap
+  {
+    struct handle
+    {
+      void *addr;
+      std::size_t len;
+
+      // NOLINTNEXTLINE(bugprone-easily-swappable-parameters, cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+      raii_inline constexpr handle(void *address, std::size_t length) noexcept : addr{ address }, len{ length } {}
+
+      raii_inline constexpr handle() noexcept : handle(nullptr, 0) {}
+
+      constexpr handle(const handle &) noexcept = default;
+      constexpr handle(handle &&) noexcept = default;
+
+      constexpr handle &operator=(const handle &) noexcept = default;
+      constexpr handle &operator=(handle &&) noexcept = default;
+
+      constexpr ~handle() noexcept = default;
+
+      [[nodiscard]] raii_inline constexpr void *operator*() const noexcept { return addr; }
+
+      [[nodiscard]] friend raii_inline constexpr bool operator==(const handle &lhs, const handle &rhs) noexcept
+      { return (lhs.addr == rhs.addr) && (lhs.len == rhs.len); }
+
+      friend raii_inline constexpr void swap(handle &lhs, handle &rhs) noexcept
+      {
+        std::ranges::swap(lhs.addr, rhs.addr);
+        std::ranges::swap(lhs.len, rhs.len);
+      }
+    };// handle
+
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(handle hnd) noexcept
+#else
+    raii_inline void operator()(handle hnd) const noexcept
+#endif
+    { static_cast<void>(::munmap(hnd.addr, hnd.len)); }
+  };// unmap
+
+  /**
+   * @brief Empty mappings are {nullptr, 0}, the result of a failed mmap, MAP_FAILED, is not owned either
+   * @note is_owned() is not constexpr, MAP_FAILED is a cast of -1 to a pointer
+   **/
+  template<typename Handle, typename Invalid = Handle> struct invalid_mapping_policy
+  {
+    using invalid_type = Invalid;
+
+    [[nodiscard]] raii_inline static constexpr invalid_type invalid() noexcept { return {}; }
+
+    [[nodiscard]] raii_inline static bool is_owned(Handle hnd) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast, performance-no-int-to-ptr)
+      return (hnd.addr != nullptr) && (hnd.addr != MAP_FAILED);
+    }
+
+    /// @brief Disabled because policy provides only typedefs and static methods
+    constexpr invalid_mapping_policy() = delete;
+    constexpr ~invalid_mapping_policy() = delete;
+
+    constexpr invalid_mapping_policy(const invalid_mapping_policy &) = delete;
+    constexpr invalid_mapping_policy &operator=(const invalid_mapping_policy &) = delete;
+
+    constexpr invalid_mapping_policy(invalid_mapping_policy &&) = delete;
+    constexpr invalid_mapping_policy &operator=(invalid_mapping_policy &&) = delete;
+  };// invalid_mapping_policy
+
+
+  /// @brief Closes a directory stream opened by opendir or fdopendir
+  struct close_dir
+  {
+    constexpr close_dir() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(DIR *dir) noexcept
+#else
+    raii_inline void operator()(DIR *dir) const noexcept
+#endif
+    { static_cast<void>(::closedir(dir)); }
+  };
+
+
+  /// @brief Decrements the reference count of a shared object opened by dlopen
+  struct dl_close
+  {
+    constexpr dl_close() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(void *lib) noexcept
+#else
+    raii_inline void operator()(void *lib) const noexcept
+#endif
+    { static_cast<void>(::dlclose(lib)); }
+  };
+
+
+  /// @brief Frees the list returned by getaddrinfo
+  struct free_addrinfo
+  {
+    constexpr free_addrinfo() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(addrinfo *info) noexcept
+#else
+    raii_inline void operator()(addrinfo *info) const noexcept
+#endif
+    { ::freeaddrinfo(info); }
+  };
+
+
+  /// @brief Releases memory allocated by the C library, e.g. by strdup, realpath, getline or scandir
+  struct c_free
+  {
+    constexpr c_free() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    template<typename T> raii_inline static void operator()(T *ptr) noexcept
+#else
+    template<typename T> raii_inline void operator()(T *ptr) const noexcept
+#endif
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-owning-memory, cppcoreguidelines-no-malloc, hicpp-no-malloc)
+      std::free(const_cast<std::remove_cv_t<T> *>(ptr));
+    }
+  };
+
+}// namespace posix
+}// namespace deleter
+
+
+/// @brief Owned file descriptor, has the size of int
+using unique_fd = unique_rc<int, deleter::posix::close_fd, resolve_handle_type, int, deleter::posix::invalid_fd_policy>;
+
+/// @brief Owned memory mapping, address and length
+using unique_mapping = unique_rc<deleter::posix::unmap::handle,
+  deleter::posix::unmap,
+  resolve_handle_type,
+  deleter::posix::unmap::handle,
+  deleter::posix::invalid_mapping_policy>;
+
+using unique_dir = unique_rc<DIR *, deleter::posix::close_dir>;
+
+using unique_dl = unique_rc<void *, deleter::posix::dl_close>;
+
+using unique_addrinfo = unique_rc<addrinfo *, deleter::posix::free_addrinfo>;
+
+template<typename T> using unique_c_ptr = unique_rc<T *, deleter::posix::c_free>;
+
+RAII_NS_END
+
+#endif// RAII_DELETER_POSIX_HPP
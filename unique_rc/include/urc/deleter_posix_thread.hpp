@@ -0,0 +1,180 @@
+// Deleters for POSIX thread synchronisation objects and attributes -*- C++ -*-
+
+#ifndef RAII_DELETER_POSIX_THREAD_HPP
+#define RAII_DELETER_POSIX_THREAD_HPP
+
+#include "raii_defs.hpp"
+#include "unique_rc.hpp"
+
+#include <pthread.h>
+#include <unistd.h>// _POSIX_BARRIERS, _POSIX_SPIN_LOCKS
+
+
+RAII_NS_BEGIN
+
+namespace deleter {
+namespace posix {
+
+  // pthread objects live in storage of their own, e.g. a member or a shared memory segment, the handle points
+  // to the initialised object and the deleter destroys it without releasing the storage, nullptr marks an invalid
+  // handle. Destroying a locked mutex or a condition variable with waiters is undefined, see pthread_mutex_destroy(3p)
+
+  struct mutex_destroy
+  {
+    constexpr mutex_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_mutex_t *mtx) noexcept
+#else
+    raii_inline void operator()(pthread_mutex_t *mtx) const noexcept
+#endif
+    { static_cast<void>(::pthread_mutex_destroy(mtx)); }
+  };
+
+  struct cond_destroy
+  {
+    constexpr cond_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_cond_t *cond) noexcept
+#else
+    raii_inline void operator()(pthread_cond_t *cond) const noexcept
+#endif
+    { static_cast<void>(::pthread_cond_destroy(cond)); }
+  };
+
+  struct rwlock_destroy
+  {
+    constexpr rwlock_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_rwlock_t *lock) noexcept
+#else
+    raii_inline void operator()(pthread_rwlock_t *lock) const noexcept
+#endif
+    { static_cast<void>(::pthread_rwlock_destroy(lock)); }
+  };
+
+#if defined(_POSIX_BARRIERS) && (_POSIX_BARRIERS > 0)
+  struct barrier_destroy
+  {
+    constexpr barrier_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_barrier_t *barrier) noexcept
+#else
+    raii_inline void operator()(pthread_barrier_t *barrier) const noexcept
+#endif
+    { static_cast<void>(::pthread_barrier_destroy(barrier)); }
+  };
+#endif
+
+#if defined(_POSIX_SPIN_LOCKS) && (_POSIX_SPIN_LOCKS > 0)
+  struct spin_destroy
+  {
+    constexpr spin_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_spinlock_t *lock) noexcept
+#else
+    raii_inline void operator()(pthread_spinlock_t *lock) const noexcept
+#endif
+    { static_cast<void>(::pthread_spin_destroy(lock)); }
+  };
+#endif
+
+  struct attr_destroy
+  {
+    constexpr attr_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_attr_t *attr) noexcept
+#else
+    raii_inline void operator()(pthread_attr_t *attr) const noexcept
+#endif
+    { static_cast<void>(::pthread_attr_destroy(attr)); }
+  };
+
+  struct mutexattr_destroy
+  {
+    constexpr mutexattr_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_mutexattr_t *attr) noexcept
+#else
+    raii_inline void operator()(pthread_mutexattr_t *attr) const noexcept
+#endif
+    { static_cast<void>(::pthread_mutexattr_destroy(attr)); }
+  };
+
+  struct condattr_destroy
+  {
+    constexpr condattr_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_condattr_t *attr) noexcept
+#else
+    raii_inline void operator()(pthread_condattr_t *attr) const noexcept
+#endif
+    { static_cast<void>(::pthread_condattr_destroy(attr)); }
+  };
+
+  struct rwlockattr_destroy
+  {
+    constexpr rwlockattr_destroy() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(pthread_rwlockattr_t *attr) noexcept
+#else
+    raii_inline void operator()(pthread_rwlockattr_t *attr) const noexcept
+#endif
+    { static_cast<void>(::pthread_rwlockattr_destroy(attr)); }
+  };
+
+}// namespace posix
+}// namespace deleter
+
+
+using unique_pthread_mutex = unique_rc<pthread_mutex_t *, deleter::posix::mutex_destroy>;
+
+using unique_pthread_cond = unique_rc<pthread_cond_t *, deleter::posix::cond_destroy>;
+
+using unique_pthread_rwlock = unique_rc<pthread_rwlock_t *, deleter::posix::rwlock_destroy>;
+
+#if defined(_POSIX_BARRIERS) && (_POSIX_BARRIERS > 0)
+using unique_pthread_barrier = unique_rc<pthread_barrier_t *, deleter::posix::barrier_destroy>;
+#endif
+
+#if defined(_POSIX_SPIN_LOCKS) && (_POSIX_SPIN_LOCKS > 0)
+using unique_pthread_spinlock = unique_rc<pthread_spinlock_t *, deleter::posix::spin_destroy>;
+#endif
+
+using unique_pthread_attr = unique_rc<pthread_attr_t *, deleter::posix::attr_destroy>;
+
+using unique_pthread_mutexattr = unique_rc<pthread_mutexattr_t *, deleter::posix::mutexattr_destroy>;
+
+using unique_pthread_condattr = unique_rc<pthread_condattr_t *, deleter::posix::condattr_destroy>;
+
+using unique_pthread_rwlockattr = unique_rc<pthread_rwlockattr_t *, deleter::posix::rwlockattr_destroy>;
+
+RAII_NS_END
+
+#endif// RAII_DELETER_POSIX_THREAD_HPP
@@ -0,0 +1,250 @@
+// Copying data between owned descriptors inside the kernel -*- C++ -*-
+
+#ifndef RAII_FILE_TRANSFER_HPP
+#define RAII_FILE_TRANSFER_HPP
+
+#include "deleter_posix.hpp"
+#include "raii_defs.hpp"
+#include "unique_array.hpp"
+
+#include <fcntl.h>// open, splice, posix_fadvise, O_CLOEXEC
+#include <sys/sendfile.h>
+#include <sys/stat.h>// fstat
+#include <sys/types.h>// ssize_t
+#include <unistd.h>// copy_file_range, ftruncate, pipe2, read, write
+
+#include <algorithm>// std::min
+#include <array>
+#include <cerrno>
+#include <cstddef>// std::size_t, std::byte
+#include <cstdint>// std::uint8_t, std::uint64_t
+#include <system_error>
+
+
+RAII_NS_BEGIN
+
+/// @brief Ways to move data between descriptors, from the cheapest, each one is tried after the previous one
+/// turned out to be unsupported for the pair of descriptors
+enum class transfer_method : std::uint8_t {
+  copy_file_range,///< file to file, may share extents (reflink) or copy on the server for NFS and SMB
+  sendfile,///< from a file, which supports mmap, to any descriptor, e.g. a socket
+  splice,///< moves page references through an owned pipe, one of them copies nothing at all
+  buffer///< read and write through a reusable user-space buffer
+};
+
+struct transfer_result
+{
+  std::uint64_t bytes = 0;
+
+  /// @brief Method, which moved the last chunk
+  transfer_method method = transfer_method::copy_file_range;
+};
+
+
+/**
+ * @brief Copies data between owned descriptors with the cheapest method the kernel supports for them.
+ *
+ * The descriptors are read and written at their current positions, which are advanced, so a transfer can
+ * continue with another method midway. The pipe used by splice and the buffer are created on the first use and kept
+ * for the following transfers, a file_transfer object is meant to be reused by a single thread.
+ * @note Descriptors have to be blocking, errors other than "not supported for these descriptors" throw
+ * @code
+ * raii::file_transfer copier;
+ * for (const auto &artifact : artifacts) { copier.copy_file(artifact.src.c_str(), artifact.dst.c_str()); }
+ * @endcode
+ **/
+class file_transfer
+{
+public:
+  /// @brief Count, which transfers until the end of input
+  static constexpr std::uint64_t to_end = ~std::uint64_t{ 0 };
+
+  static constexpr std::size_t default_buffer_size = std::size_t{ 1 } << 20;
+
+  /// @param buffer_size size of the fallback buffer and the largest chunk moved by a single system call
+  explicit file_transfer(std::size_t buffer_size = default_buffer_size) noexcept
+    : buffer_size_{ std::max(buffer_size, std::size_t{ 4096 }) }
+  {}
+
+  /**
+   * @brief Copies count bytes or until the end of input from in to out
+   * @param first the method to start with, later ones are used, if it is not supported
+   * @throw std::system_error, if reading or writing fails
+   **/
+  transfer_result transfer(int in,
+    int out,
+    std::uint64_t count = to_end,
+    transfer_method first = transfer_method::copy_file_range)
+  {
+    transfer_result res{ 0, first };
+    while (res.bytes != count) {
+      const std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(count - res.bytes, max_chunk));
+      const ssize_t moved = move_chunk(in, out, chunk, res.method);
+      if (moved < 0) {
+        // Not supported for these descriptors, retried with the next method
+        res.method = static_cast<transfer_method>(static_cast<std::uint8_t>(res.method) + 1);
+        continue;
+      }
+      if (moved == 0) {
+        // copy_file_range reports 0 for files of procfs and sysfs, which claim to be empty, another method reads them
+        if (res.bytes == 0 && res.method == transfer_method::copy_file_range) {
+          res.method = transfer_method::sendfile;
+          continue;
+        }
+        break;
+      }
+      res.bytes += static_cast<std::uint64_t>(moved);
+    }
+    return res;
+  }
+
+  transfer_result transfer(const unique_fd &in,
+    const unique_fd &out,
+    std::uint64_t count = to_end,
+    transfer_method first = transfer_method::copy_file_range)
+  { return transfer(in.get(), out.get(), count, first); }
+
+  /**
+   * @brief Copies the contents of the file from into the file to, which is created with the permissions of from
+   * or truncated
+   * @throw std::system_error, if a file cannot be opened or the copy fails, with EINVAL, if from and to are the same
+   * file, e.g. hard links, like cp does, to is not truncated then
+   **/
+  transfer_result copy_file(const char *from, const char *to)
+  {
+    const unique_fd in{ ::open(from, O_RDONLY | O_CLOEXEC) };
+    if (!in) { throw std::system_error{ errno, std::system_category(), "open" }; }
+    struct stat info{};
+    if (::fstat(in.get(), &info) != 0) { throw std::system_error{ errno, std::system_category(), "fstat" }; }
+    static_cast<void>(::posix_fadvise(in.get(), 0, 0, POSIX_FADV_SEQUENTIAL));
+
+    // Truncated only after it is known not to be the source, which O_TRUNC would destroy
+    const unique_fd out{ ::open(to, O_WRONLY | O_CREAT | O_CLOEXEC, info.st_mode & 07777) };
+    if (!out) { throw std::system_error{ errno, std::system_category(), "open" }; }
+    struct stat out_info{};
+    if (::fstat(out.get(), &out_info) != 0) { throw std::system_error{ errno, std::system_category(), "fstat" }; }
+    if (out_info.st_dev == info.st_dev && out_info.st_ino == info.st_ino) {
+      throw std::system_error{ EINVAL, std::system_category(), "copy_file: source and target are the same file" };
+    }
+    if (::ftruncate(out.get(), 0) != 0) { throw std::system_error{ errno, std::system_category(), "ftruncate" }; }
+    return transfer(in, out);
+  }
+
+private:
+  // Largest count accepted by a single call, rounded down to a page, like MAX_RW_COUNT of the kernel
+  static constexpr std::size_t max_chunk = 0x7ffff000;
+
+  // Returns number of bytes moved, 0 at the end of input, -1 if method is not supported for the descriptors.
+  // method is switched to a later one, if the chunk was moved, but the rest should not use method any more
+  ssize_t move_chunk(int in, int out, std::size_t chunk, transfer_method &method)
+  {
+    for (;;) {
+      ssize_t moved = -1;
+      switch (method) {
+      case transfer_method::copy_file_range:
+        moved = ::copy_file_range(in, nullptr, out, nullptr, chunk, 0);
+        break;
+      case transfer_method::sendfile:
+        moved = ::sendfile(out, in, nullptr, chunk);
+        break;
+      case transfer_method::splice:
+        return splice_chunk(in, out, chunk, method);
+      case transfer_method::buffer:
+      default:
+        return copy_chunk(in, out, chunk);
+      }
+      if (moved >= 0) { return moved; }
+      if (errno == EINTR) { continue; }
+      if (is_unsupported(errno)) { return -1; }
+      throw std::system_error{ errno, std::system_category(), method_name(method) };
+    }
+  }
+
+  ssize_t splice_chunk(int in, int out, std::size_t chunk, transfer_method &method)
+  {
+    if (!pipe_read_) {
+      std::array<int, 2> fds{ -1, -1 };
+      if (::pipe2(fds.data(), O_CLOEXEC) != 0) { throw std::system_error{ errno, std::system_category(), "pipe2" }; }
+      pipe_read_.reset(fds[0]);
+      pipe_write_.reset(fds[1]);
+      // A bigger pipe moves more pages per splice, the default of 64 KiB is kept, if the limit is lower
+      const auto pipe_size = static_cast<int>(std::min(buffer_size_, max_chunk));
+      static_cast<void>(::fcntl(pipe_write_.get(), F_SETPIPE_SZ, pipe_size));
+    }
+
+    const ssize_t filled = retry(
+      [&] { return ::splice(in, nullptr, pipe_write_.get(), nullptr, chunk, SPLICE_F_MOVE); });
+    if (filled < 0) {
+      if (is_unsupported(errno)) { return -1; }
+      throw std::system_error{ errno, std::system_category(), "splice" };
+    }
+    // The pipe has to be drained completely, it is shared by the following chunks
+    for (ssize_t left = filled; left != 0;) {
+      const ssize_t drained = retry([&] {
+        return ::splice(pipe_read_.get(), nullptr, out, nullptr, static_cast<std::size_t>(left), SPLICE_F_MOVE);
+      });
+      if (drained < 0 && is_unsupported(errno)) {
+        // out doesn't accept splice, e.g. it is opened with O_APPEND, the pipe is drained through the buffer and
+        // the following chunks skip the pipe
+        left -= copy_chunk(pipe_read_.get(), out, static_cast<std::size_t>(left));
+        method = transfer_method::buffer;
+        continue;
+      }
+      if (drained <= 0) { throw std::system_error{ (drained < 0) ? errno : EIO, std::system_category(), "splice" }; }
+      left -= drained;
+    }
+    return filled;
+  }
+
+  ssize_t copy_chunk(int in, int out, std::size_t chunk)
+  {
+    if (buffer_.empty()) { buffer_ = make_unique_array_for_overwrite<std::byte>(buffer_size_); }
+
+    const ssize_t filled =
+      retry([&] { return ::read(in, buffer_.data(), std::min(chunk, buffer_.size())); });
+    if (filled < 0) { throw std::system_error{ errno, std::system_category(), "read" }; }
+    for (ssize_t written = 0; written != filled;) {
+      const ssize_t res = retry([&] {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return ::write(out, buffer_.data() + written, static_cast<std::size_t>(filled - written));
+      });
+      if (res < 0) { throw std::system_error{ errno, std::system_category(), "write" }; }
+      written += res;
+    }
+    return filled;
+  }
+
+  template<typename Call> static ssize_t retry(Call call)
+  {
+    ssize_t res = call();
+    while (res < 0 && errno == EINTR) { res = call(); }
+    return res;
+  }
+
+  [[nodiscard]] static bool is_unsupported(int err) noexcept
+  {
+    // EXDEV: copy_file_range across file systems before Linux 5.3 and for some file systems since 5.19
+    // EINVAL: the descriptors are of the wrong kind, e.g. sendfile from a pipe or copy_file_range to a socket
+    return err == EXDEV || err == EINVAL || err == ENOSYS || err == EOPNOTSUPP || err == EBADF || err == ESPIPE;
+  }
+
+  [[nodiscard]] static const char *method_name(transfer_method method) noexcept
+  { return (method == transfer_method::copy_file_range) ? "copy_file_range" : "sendfile"; }
+
+  std::size_t buffer_size_;
+  unique_fd pipe_read_;
+  unique_fd pipe_write_;
+  unique_array<std::byte> buffer_;
+};
+
+
+/// @brief Copies count bytes or until the end of input, see raii::file_transfer::transfer
+inline transfer_result transfer(const unique_fd &in, const unique_fd &out, std::uint64_t count = file_transfer::to_end)
+{ return file_transfer{}.transfer(in, out, count); }
+
+/// @brief Copies the file from into to, see raii::file_transfer::copy_file
+inline transfer_result copy_file(const char *from, const char *to) { return file_transfer{}.copy_file(from, to); }
+
+RAII_NS_END
+
+#endif// RAII_FILE_TRANSFER_HPP
@@ -0,0 +1,212 @@
+// Pooled coroutine frame allocation for promise types -*- C++ -*-
+
+#ifndef RAII_FRAME_ALLOCATOR_HPP
+#define RAII_FRAME_ALLOCATOR_HPP
+
+#include "pool_delete.hpp"
+#include "raii_defs.hpp"
+
+#include <cstddef>// std::size_t, std::byte
+#include <cstring>// std::memcpy
+#include <memory>// std::allocator_arg_t, std::allocator_traits, std::construct_at, std::destroy_at
+#include <new>
+#include <type_traits>
+#include <utility>// std::move
+
+
+RAII_NS_BEGIN
+
+namespace detail {
+
+  // Frames up to max_frame_class bytes are served by per-thread pools of power of two size classes,
+  // larger ones go to the global heap
+  inline constexpr std::size_t frame_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+  inline constexpr std::size_t min_frame_class = 64;
+  inline constexpr std::size_t max_frame_class = 4096;
+
+  template<std::size_t Size> struct frame_block
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+    alignas(frame_alignment) std::byte storage[Size];
+  };
+
+  template<std::size_t Size = min_frame_class> [[nodiscard]] raii_inline void *allocate_frame(std::size_t size)
+  {
+    if constexpr (Size > max_frame_class) {
+      return ::operator new(size);
+    } else {
+      if (size <= Size) { return object_pool<frame_block<Size>>::allocate(); }
+      return allocate_frame<Size * 2>(size);
+    }
+  }
+
+  template<std::size_t Size = min_frame_class> raii_inline void deallocate_frame(void *frame, std::size_t size) noexcept
+  {
+    if constexpr (Size > max_frame_class) {
+      ::operator delete(frame, size);
+    } else {
+      if (size <= Size) {
+        object_pool<frame_block<Size>>::deallocate(frame);
+      } else {
+        deallocate_frame<Size * 2>(frame, size);
+      }
+    }
+  }
+
+  template<std::size_t Size = min_frame_class> [[nodiscard]] raii_inline pool_stats frame_stats() noexcept
+  {
+    if constexpr (Size > max_frame_class) {
+      return {};
+    } else {
+      const pool_stats cur = pool_statistics<frame_block<Size>>();
+      const pool_stats rest = frame_stats<Size * 2>();
+      return { cur.hits + rest.hits,
+        cur.misses + rest.misses,
+        cur.remote_frees + rest.remote_frees,
+        cur.cached + rest.cached };
+    }
+  }
+
+  // Every frame is followed by a pointer to the function, which deallocates it, so that the single
+  // promise_type::operator delete can release frames allocated either from the pools or by a user allocator
+  using frame_deallocate_fn = void (*)(void *frame, std::size_t size) noexcept;
+
+  [[nodiscard]] raii_inline constexpr std::size_t round_up(std::size_t size, std::size_t align) noexcept
+  { return (size + align - 1) & ~(align - 1); }
+
+  [[nodiscard]] raii_inline constexpr std::size_t deallocate_fn_offset(std::size_t size) noexcept
+  { return round_up(size, alignof(frame_deallocate_fn)); }
+
+  raii_inline void store_deallocate_fn(void *frame, std::size_t size, frame_deallocate_fn deallocate) noexcept
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(static_cast<std::byte *>(frame) + deallocate_fn_offset(size), &deallocate, sizeof(deallocate));
+  }
+
+  [[nodiscard]] raii_inline frame_deallocate_fn load_deallocate_fn(void *frame, std::size_t size) noexcept
+  {
+    frame_deallocate_fn deallocate{};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(&deallocate, static_cast<std::byte *>(frame) + deallocate_fn_offset(size), sizeof(deallocate));
+    return deallocate;
+  }
+
+  struct pooled_frame
+  {
+    [[nodiscard]] static std::size_t total_size(std::size_t size) noexcept
+    { return deallocate_fn_offset(size) + sizeof(frame_deallocate_fn); }
+
+    [[nodiscard]] static void *allocate(std::size_t size)
+    {
+      void *const frame = allocate_frame(total_size(size));
+      store_deallocate_fn(frame, size, &deallocate);
+      return frame;
+    }
+
+    static void deallocate(void *frame, std::size_t size) noexcept { deallocate_frame(frame, total_size(size)); }
+  };
+
+  // Frame allocated by a user allocator, a copy of the allocator is kept after the deallocation function, unless
+  // the allocator is stateless
+  template<typename Alloc> struct allocator_frame
+  {
+    struct alignas(frame_alignment) unit
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+      std::byte bytes[frame_alignment];
+    };
+
+    using alloc_type = std::allocator_traits<Alloc>::template rebind_alloc<unit>;
+    using traits = std::allocator_traits<alloc_type>;
+
+    static constexpr bool stores_allocator =
+      !(traits::is_always_equal::value && std::is_default_constructible_v<alloc_type>);
+
+    [[nodiscard]] static std::size_t allocator_offset(std::size_t size) noexcept
+    { return round_up(deallocate_fn_offset(size) + sizeof(frame_deallocate_fn), alignof(alloc_type)); }
+
+    [[nodiscard]] static std::size_t unit_count(std::size_t size) noexcept
+    {
+      const std::size_t total = allocator_offset(size) + (stores_allocator ? sizeof(alloc_type) : 0);
+      return (total + sizeof(unit) - 1) / sizeof(unit);
+    }
+
+    [[nodiscard]] static alloc_type *allocator_of(void *frame, std::size_t size) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+      return reinterpret_cast<alloc_type *>(static_cast<std::byte *>(frame) + allocator_offset(size));
+    }
+
+    [[nodiscard]] static void *allocate(const Alloc &alloc, std::size_t size)
+    {
+      alloc_type rebound{ alloc };
+      void *const frame = traits::allocate(rebound, unit_count(size));
+      store_deallocate_fn(frame, size, &deallocate);
+      if constexpr (stores_allocator) { std::construct_at(allocator_of(frame, size), std::move(rebound)); }
+      return frame;
+    }
+
+    static void deallocate(void *frame, std::size_t size) noexcept
+    {
+      if constexpr (stores_allocator) {
+        alloc_type *const stored = allocator_of(frame, size);
+        alloc_type rebound{ std::move(*stored) };
+        std::destroy_at(stored);
+        traits::deallocate(rebound, static_cast<unit *>(frame), unit_count(size));
+      } else {
+        alloc_type rebound{};
+        traits::deallocate(rebound, static_cast<unit *>(frame), unit_count(size));
+      }
+    }
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief Promise mixin, which allocates coroutine frames from per-thread size-class pools instead of the global
+ * heap. Frames released on another thread are returned to the pool of the thread, which allocated them.
+ *
+ * A coroutine, which takes `std::allocator_arg_t, const Alloc &` as its first parameters (after the object
+ * parameter for member coroutines), allocates its frame with that allocator instead.
+ *
+ * @code
+ * struct promise_type : raii::pooled_frame_promise { ... };
+ * @endcode
+ * @note Frames are released by the promise's operator delete, which std::coroutine_handle::destroy() invokes,
+ * so raii::unique_coroutine_handle and raii::coroutine_destroy need no changes
+ * @note GCC 12 reports coroutines using the std::allocator_arg overloads with -Wmismatched-new-delete, it is a false
+ * positive, coroutine frames are always released by the usual operator delete
+ **/
+struct pooled_frame_promise
+{
+  [[nodiscard]] static void *operator new(std::size_t size) { return detail::pooled_frame::allocate(size); }
+
+  template<typename Alloc, typename... Args>
+  [[nodiscard]] static void *
+    operator new(std::size_t size, std::allocator_arg_t /*tag*/, const Alloc &alloc, const Args &.../*args*/)
+  {
+    return detail::allocator_frame<Alloc>::allocate(alloc, size);
+  }
+
+  /// @brief Member coroutine overload, the first argument is the object parameter
+  template<typename This, typename Alloc, typename... Args>
+  [[nodiscard]] static void *operator new(std::size_t size,
+    const This & /*self*/,
+    std::allocator_arg_t /*tag*/,
+    const Alloc &alloc,
+    const Args &.../*args*/)
+  {
+    return detail::allocator_frame<Alloc>::allocate(alloc, size);
+  }
+
+  static void operator delete(void *frame, std::size_t size) noexcept
+  { detail::load_deallocate_fn(frame, size)(frame, size); }
+};
+
+/// @brief Sums pool statistics of all frame size classes for the calling thread
+[[nodiscard]] raii_inline pool_stats frame_pool_statistics() noexcept { return detail::frame_stats(); }
+
+RAII_NS_END
+
+#endif// RAII_FRAME_ALLOCATOR_HPP
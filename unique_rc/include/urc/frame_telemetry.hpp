@@ -0,0 +1,297 @@
+// Opt-in telemetry of coroutine frame sizes and lifetimes per promise type -*- C++ -*-
+
+#ifndef RAII_FRAME_TELEMETRY_HPP
+#define RAII_FRAME_TELEMETRY_HPP
+
+#include "coroutine_destroy.hpp"
+#include "frame_allocator.hpp"
+#include "raii_defs.hpp"
+#include "unique_coroutine_handle.hpp"
+
+#include <algorithm>// std::max, std::min
+#include <array>
+#include <atomic>
+#include <bit>// std::bit_width
+#include <chrono>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>// std::size_t
+#include <cstdint>// std::uint64_t
+#include <string_view>
+
+
+RAII_NS_BEGIN
+
+/// @brief Snapshot of the telemetry of one promise type
+struct frame_statistics
+{
+  /// @brief Bucket i counts frames of more than 2^(i-1) and at most 2^i bytes, the pool size class they fall into
+  static constexpr std::size_t size_buckets = 24;
+  /// @brief Bucket i counts frames, which lived at least 2^(i-1) and less than 2^i nanoseconds
+  static constexpr std::size_t lifetime_buckets = 48;
+
+  /// @brief Frames allocated by operator new of the promise
+  std::size_t allocations;
+  /// @brief Sum of the frame sizes requested from operator new
+  std::size_t total_bytes;
+  /// @brief Largest frame size requested from operator new
+  std::size_t max_size;
+  /// @brief Frames allocated and not deallocated yet
+  std::size_t live;
+  /// @brief Largest number of live frames at the same time
+  std::size_t peak;
+  std::array<std::size_t, size_buckets> size_histogram;
+
+  /// @brief Frames released through raii::instrumented_destroy, whose lifetime has been recorded
+  std::size_t lifetimes;
+  std::array<std::size_t, lifetime_buckets> lifetime_histogram;
+
+  [[nodiscard]] constexpr std::size_t mean_size() const noexcept
+  { return (allocations == 0) ? 0 : total_bytes / allocations; }
+};
+
+namespace detail {
+
+  // Name of T for reports, taken from the signature of this function, empty if the compiler is not recognised
+  template<typename T> [[nodiscard]] std::string_view type_name() noexcept
+  {
+#if defined(__clang__) || defined(__GNUC__)
+    const std::string_view sig{ static_cast<const char *>(__PRETTY_FUNCTION__) };
+    const std::size_t first = sig.find("T = ");
+    if (first == std::string_view::npos) { return {}; }
+    const std::size_t last = sig.find_first_of(";]", first);
+    return sig.substr(first + 4, last - first - 4);
+#elif defined(_MSC_VER)
+    const std::string_view sig{ __FUNCSIG__ };
+    const std::size_t first = sig.find("type_name<");
+    const std::size_t last = sig.rfind(">(void)");
+    if (first == std::string_view::npos || last == std::string_view::npos) { return {}; }
+    return sig.substr(first + 10, last - first - 10);
+#else
+    return {};
+#endif
+  }
+
+  /**
+   * @brief Counters of one promise type, shared by all threads.
+   *
+   * Every telemetry registers itself in a global lock-free list on first use, the list only grows, telemetries are
+   * never destroyed before the end of the program.
+   **/
+  class frame_telemetry
+  {
+  public:
+    frame_telemetry(const frame_telemetry &) = delete;
+    frame_telemetry &operator=(const frame_telemetry &) = delete;
+    frame_telemetry(frame_telemetry &&) = delete;
+    frame_telemetry &operator=(frame_telemetry &&) = delete;
+    ~frame_telemetry() = default;
+
+    template<typename Tag> [[nodiscard]] static frame_telemetry &of() noexcept
+    {
+      static frame_telemetry telemetry{ type_name<Tag>() };
+      return telemetry;
+    }
+
+    template<typename Fn> static void for_each(Fn &&fn)
+    {
+      for (const frame_telemetry *cur = head().load(std::memory_order_acquire); cur != nullptr; cur = cur->next_) {
+        fn(cur->name_, cur->snapshot());
+      }
+    }
+
+    void record_allocation(std::size_t size) noexcept
+    {
+      total_bytes_.fetch_add(size, std::memory_order_relaxed);
+      update_max(max_size_, size);
+      update_max(peak_, live_.fetch_add(1, std::memory_order_relaxed) + 1);
+      size_histogram_[bucket(size - 1, frame_statistics::size_buckets)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record_deallocation() noexcept { live_.fetch_sub(1, std::memory_order_relaxed); }
+
+    void record_lifetime(std::chrono::nanoseconds lifetime) noexcept
+    {
+      const auto nanos = static_cast<std::uint64_t>(std::max(lifetime.count(), std::chrono::nanoseconds::rep{ 0 }));
+      lifetime_histogram_[bucket(nanos, frame_statistics::lifetime_buckets)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] frame_statistics snapshot() const noexcept
+    {
+      frame_statistics res{};
+      res.total_bytes = total_bytes_.load(std::memory_order_relaxed);
+      res.max_size = max_size_.load(std::memory_order_relaxed);
+      res.live = live_.load(std::memory_order_relaxed);
+      res.peak = peak_.load(std::memory_order_relaxed);
+      // The totals are the sums of the histograms, which saves two atomic increments per frame
+      for (std::size_t i = 0; i != frame_statistics::size_buckets; ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        res.size_histogram[i] = size_histogram_[i].load(std::memory_order_relaxed);
+        res.allocations += res.size_histogram[i];// NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+      }
+      for (std::size_t i = 0; i != frame_statistics::lifetime_buckets; ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        res.lifetime_histogram[i] = lifetime_histogram_[i].load(std::memory_order_relaxed);
+        res.lifetimes += res.lifetime_histogram[i];// NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+      }
+      return res;
+    }
+
+    /// @brief Clears the counters except for the live frames, the peak restarts from them
+    void reset() noexcept
+    {
+      total_bytes_.store(0, std::memory_order_relaxed);
+      max_size_.store(0, std::memory_order_relaxed);
+      peak_.store(live_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      for (auto &count : size_histogram_) { count.store(0, std::memory_order_relaxed); }
+      for (auto &count : lifetime_histogram_) { count.store(0, std::memory_order_relaxed); }
+    }
+
+  private:
+    explicit frame_telemetry(std::string_view name) noexcept : name_{ name }
+    {
+      std::atomic<frame_telemetry *> &list = head();
+      next_ = list.load(std::memory_order_relaxed);
+      while (!list.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    [[nodiscard]] static std::atomic<frame_telemetry *> &head() noexcept
+    {
+      static constinit std::atomic<frame_telemetry *> list{ nullptr };
+      return list;
+    }
+
+    [[nodiscard]] static std::size_t bucket(std::uint64_t val, std::size_t count) noexcept
+    {
+      // std::bit_width returns std::uint64_t here before LWG 3656 and int after it, unsigned widens implicitly
+      const auto width = static_cast<unsigned>(std::bit_width(val));
+      return std::min<std::size_t>(width, count - 1);
+    }
+
+    static void update_max(std::atomic<std::size_t> &max, std::size_t val) noexcept
+    {
+      std::size_t cur = max.load(std::memory_order_relaxed);
+      while (cur < val && !max.compare_exchange_weak(cur, val, std::memory_order_relaxed)) {}
+    }
+
+    std::atomic<std::size_t> total_bytes_{ 0 };
+    std::atomic<std::size_t> max_size_{ 0 };
+    std::atomic<std::size_t> live_{ 0 };
+    std::atomic<std::size_t> peak_{ 0 };
+    std::array<std::atomic<std::size_t>, frame_statistics::size_buckets> size_histogram_{};
+    std::array<std::atomic<std::size_t>, frame_statistics::lifetime_buckets> lifetime_histogram_{};
+
+    std::string_view name_;
+    frame_telemetry *next_{ nullptr };
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief Promise mixin, which records the frame sizes requested from operator new, the live frames and their peak
+ * for the promise type Promise, and stamps every frame with its creation time for raii::instrumented_destroy.
+ *
+ * Frames are allocated by Base, raii::pooled_frame_promise by default, including its std::allocator_arg overloads.
+ * The counters are shared by all threads, the instrumentation costs five atomic increments, which contend between
+ * threads, and two clock reads per frame. It is meant for sizing the frame pools and for finding heavy frames, not
+ * for production builds.
+ * @code
+ * struct promise_type : raii::instrumented_frame_promise<promise_type> { ... };
+ * raii::frame_statistics stats = raii::frame_statistics_of<promise_type>();
+ * @endcode
+ * @tparam Promise the promise type deriving from the mixin, it names the counters
+ **/
+template<typename Promise, typename Base = pooled_frame_promise> struct instrumented_frame_promise : Base
+{
+  using frame_telemetry_tag = Promise;
+
+  [[nodiscard]] static void *operator new(std::size_t size)
+  {
+    void *const frame = Base::operator new(size);
+    detail::frame_telemetry::of<Promise>().record_allocation(size);
+    return frame;
+  }
+
+  /// @brief Forwards the coroutine arguments to the allocating overloads of Base, e.g. std::allocator_arg
+  template<typename... Args>
+    requires(sizeof...(Args) > 0)
+            && requires(std::size_t size, const Args &...args) { Base::operator new(size, args...); }
+  [[nodiscard]] static void *operator new(std::size_t size, const Args &...args)
+  {
+    void *const frame = Base::operator new(size, args...);
+    detail::frame_telemetry::of<Promise>().record_allocation(size);
+    return frame;
+  }
+
+  static void operator delete(void *frame, std::size_t size) noexcept
+  {
+    detail::frame_telemetry::of<Promise>().record_deallocation();
+    Base::operator delete(frame, size);
+  }
+
+  /// @brief Time since the promise, and with it the frame, was created
+  [[nodiscard]] std::chrono::nanoseconds frame_age() const noexcept
+  { return std::chrono::steady_clock::now() - created_; }
+
+private:
+  std::chrono::steady_clock::time_point created_{ std::chrono::steady_clock::now() };
+};
+
+template<typename Promise>
+concept instrumented_promise = requires(const Promise &promise) {
+  typename Promise::frame_telemetry_tag;
+  { promise.frame_age() } -> std::same_as<std::chrono::nanoseconds>;
+};
+
+
+/**
+ * @brief Deleter for unique_coroutine_handle, which records the lifetime of the frame in the histogram of its promise
+ * type and passes the handle on to Deleter, raii::coroutine_destroy by default.
+ *
+ * Frames of promise types without raii::instrumented_frame_promise are passed on without recording anything. With
+ * raii::deferred_coroutine_destroy the lifetime ends, when the owner releases the frame, not when it is drained.
+ **/
+template<typename Deleter = coroutine_destroy> struct instrumented_destroy
+{
+  constexpr instrumented_destroy() noexcept = default;
+
+  template<typename Promise>
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static void operator()(std::coroutine_handle<Promise> hnd) noexcept
+#else
+  raii_inline void operator()(std::coroutine_handle<Promise> hnd) const noexcept
+#endif
+  {
+    if constexpr (instrumented_promise<Promise>) {
+      detail::frame_telemetry::of<typename Promise::frame_telemetry_tag>().record_lifetime(hnd.promise().frame_age());
+    }
+    Deleter{}(hnd);
+  }
+};
+
+template<typename Promise, typename Deleter = coroutine_destroy>
+using instrumented_coroutine_handle = unique_coroutine_handle<Promise, instrumented_destroy<Deleter>>;
+
+
+/// @brief Returns the telemetry of the promise type Promise, as named by raii::instrumented_frame_promise
+template<typename Promise> [[nodiscard]] frame_statistics frame_statistics_of() noexcept
+{ return detail::frame_telemetry::of<Promise>().snapshot(); }
+
+/// @brief Clears the telemetry of the promise type Promise, the live frames are kept
+template<typename Promise> void reset_frame_statistics() noexcept { detail::frame_telemetry::of<Promise>().reset(); }
+
+/**
+ * @brief Calls fn(std::string_view name, const frame_statistics &stats) for every promise type, which has allocated
+ * a frame or was queried, e.g. to dump the telemetry at exit
+ **/
+template<typename Fn>
+  requires std::invocable<Fn &, std::string_view, const frame_statistics &>
+void for_each_frame_statistics(Fn &&fn)
+{ detail::frame_telemetry::for_each(fn); }
+
+RAII_NS_END
+
+#endif// RAII_FRAME_TELEMETRY_HPP
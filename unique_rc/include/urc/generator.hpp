@@ -0,0 +1,288 @@
+// generator implementation -*- C++ -*-
+
+#ifndef RAII_GENERATOR_HPP
+#define RAII_GENERATOR_HPP
+
+#include "frame_allocator.hpp"
+#include "raii_defs.hpp"
+#include "unique_coroutine_handle.hpp"
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>// std::ptrdiff_t
+#include <exception>// std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <iterator>// std::default_sentinel_t
+#include <memory>// std::addressof
+#include <ranges>
+#include <type_traits>
+#include <utility>// std::move, std::exchange
+
+
+RAII_NS_BEGIN
+
+/// @brief Wraps a range to be yielded element by element, `co_yield raii::elements_of(other_generator())`
+template<typename Range> struct elements_of
+{
+  // cppcheck-suppress unusedStructMember
+  Range range;
+};
+
+template<typename Range> elements_of(Range &&) -> elements_of<Range &&>;
+
+template<typename Ref, typename Val = void> class generator;
+
+namespace detail {
+
+  /**
+   * @brief Promise state shared by all generators yielding the same reference type.
+   *
+   * Nested generators (`co_yield elements_of(...)`) form a stack. The outermost (root) promise tracks the innermost
+   * active coroutine and the address of the current value, so that the iterator resumes and dereferences in O(1),
+   * whatever the nesting depth. A finished nested generator transfers control back to its parent symmetrically.
+   **/
+  template<typename Yielded> class generator_promise_base : public pooled_frame_promise
+  {
+  public:
+    generator_promise_base() noexcept = default;
+
+    generator_promise_base(const generator_promise_base &) = delete;
+    generator_promise_base &operator=(const generator_promise_base &) = delete;
+    generator_promise_base(generator_promise_base &&) = delete;
+    generator_promise_base &operator=(generator_promise_base &&) = delete;
+
+    ~generator_promise_base() = default;
+
+    static std::suspend_always initial_suspend() noexcept { return {}; }
+
+    [[nodiscard]] static auto final_suspend() noexcept { return final_awaiter{}; }
+
+    std::suspend_always yield_value(Yielded val) noexcept
+    {
+      root_->value_ = std::addressof(val);
+      return {};
+    }
+
+    /// @brief Yields a copy of an lvalue, when the reference type is an rvalue reference
+    [[nodiscard]] auto yield_value(const std::remove_reference_t<Yielded> &lval) noexcept(
+      std::is_nothrow_constructible_v<std::remove_cvref_t<Yielded>, const std::remove_reference_t<Yielded> &>)
+      requires std::is_rvalue_reference_v<Yielded>
+               && std::constructible_from<std::remove_cvref_t<Yielded>, const std::remove_reference_t<Yielded> &>
+    {
+      return copy_awaiter{ std::remove_cvref_t<Yielded>(lval), root_ };
+    }
+
+    /// @brief Yields all elements of a nested generator, which is resumed directly by the outermost iterator
+    template<typename Ref2, typename Val2>
+      requires std::same_as<typename generator<Ref2, Val2>::yielded, Yielded>
+    [[nodiscard]] auto yield_value(elements_of<generator<Ref2, Val2> &&> nested) noexcept
+    {
+      return nested_awaiter<generator<Ref2, Val2>>{ std::move(nested.range) };
+    }
+
+    /// @brief Yields all elements of an arbitrary range
+    template<std::ranges::input_range Range>
+      requires std::convertible_to<std::ranges::range_reference_t<Range>, Yielded>
+               || (std::is_rvalue_reference_v<Yielded>
+                   && std::constructible_from<std::remove_cvref_t<Yielded>, std::ranges::range_reference_t<Range>>)
+    [[nodiscard]] auto yield_value(elements_of<Range> nested)
+    {
+      return nested_awaiter<generator<Yielded>>{ yield_range(
+        std::ranges::begin(nested.range), std::ranges::end(nested.range)) };
+    }
+
+    void await_transform() = delete;
+
+    static constexpr void return_void() noexcept {}
+
+    void unhandled_exception()
+    {
+      // The root rethrows to the caller of begin() or operator++, nested generators hand it over to the parent
+      if (except_ == nullptr) { throw; }
+      *except_ = std::current_exception();
+    }
+
+  private:
+    template<typename, typename> friend class raii::generator;
+
+    struct final_awaiter
+    {
+      static constexpr bool await_ready() noexcept { return false; }
+
+      template<typename Promise>
+      [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> hnd) noexcept
+      {
+        generator_promise_base &promise = hnd.promise();
+        if (promise.parent_) {
+          promise.root_->active_ = promise.parent_;
+          return promise.parent_;
+        }
+        return std::noop_coroutine();
+      }
+
+      static constexpr void await_resume() noexcept {}
+    };
+
+    struct copy_awaiter
+    {
+      std::remove_cvref_t<Yielded> value;
+      generator_promise_base *root;
+
+      static constexpr bool await_ready() noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<> /*hnd*/) noexcept { root->value_ = std::addressof(value); }
+
+      static constexpr void await_resume() noexcept {}
+    };
+
+    template<typename Gen> struct nested_awaiter
+    {
+      Gen gen;
+      std::exception_ptr except{};
+
+      [[nodiscard]] bool await_ready() const noexcept { return !gen.coro_; }
+
+      template<typename Promise>
+      [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> hnd) noexcept
+      {
+        auto nested = gen.coro_.get();
+        generator_promise_base &current = hnd.promise();
+        generator_promise_base &inner = nested.promise();
+
+        inner.root_ = current.root_;
+        inner.parent_ = hnd;
+        inner.except_ = &except;
+        current.root_->active_ = nested;
+        return nested;
+      }
+
+      void await_resume()
+      {
+        if (except) { std::rethrow_exception(std::move(except)); }
+      }
+    };
+
+    template<typename Iter, typename Sent> static generator<Yielded> yield_range(Iter first, Sent last)
+    {
+      for (; first != last; ++first) {
+        if constexpr (std::convertible_to<decltype(*first), Yielded>) {
+          co_yield static_cast<Yielded>(*first);
+        } else {
+          // e.g. elements of std::vector<T>& yielded by generator<T>, each one is copied
+          co_yield std::remove_cvref_t<Yielded>(*first);
+        }
+      }
+    }
+
+    std::add_pointer_t<Yielded> value_{ nullptr };
+    generator_promise_base *root_{ this };
+    // Innermost generator to be resumed, valid in the root promise only
+    std::coroutine_handle<> active_;
+    std::coroutine_handle<> parent_;
+    std::exception_ptr *except_{ nullptr };
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief raii::generator is a move-only view over the values yielded by a coroutine, in the spirit of std::generator.
+ * The coroutine frame is owned by raii::unique_coroutine_handle and allocated from per-thread frame pools,
+ * see raii::pooled_frame_promise, or by an allocator passed via std::allocator_arg.
+ * @tparam Ref reference type of the range, e.g. `generator<int>` yields `int&&`, `generator<const T&>` yields
+ * `const T&`
+ * @tparam Val value type of the range, remove_cvref_t<Ref> by default
+ **/
+template<typename Ref, typename Val>
+class generator : public std::ranges::view_interface<generator<Ref, Val>>
+{
+public:
+  using value = std::conditional_t<std::is_void_v<Val>, std::remove_cvref_t<Ref>, Val>;
+  using reference = std::conditional_t<std::is_void_v<Val>, Ref &&, Ref>;
+  using yielded = std::conditional_t<std::is_reference_v<reference>, reference, const reference &>;
+
+  static_assert(std::same_as<std::remove_cvref_t<value>, value> && std::is_object_v<value>,
+    "generator value type must be a cv-unqualified object type");
+
+  struct promise_type : detail::generator_promise_base<yielded>
+  {
+    generator get_return_object() noexcept
+    { return generator{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+  };
+
+private:
+  using handle = std::coroutine_handle<promise_type>;
+
+public:
+  class iterator
+  {
+  public:
+    using value_type = generator::value;
+    using difference_type = std::ptrdiff_t;
+
+    iterator(iterator &&src) noexcept : coro_{ std::exchange(src.coro_, {}) } {}
+
+    iterator &operator=(iterator &&src) noexcept
+    {
+      coro_ = std::exchange(src.coro_, {});
+      return *this;
+    }
+
+    ~iterator() = default;
+
+    iterator(const iterator &) = delete;
+    iterator &operator=(const iterator &) = delete;
+
+    [[nodiscard]] reference operator*() const noexcept(std::is_nothrow_copy_constructible_v<reference>)
+    { return static_cast<reference>(*coro_.promise().value_); }
+
+    iterator &operator++()
+    {
+      coro_.promise().active_.resume();
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    [[nodiscard]] friend bool operator==(const iterator &iter, std::default_sentinel_t /*end*/) noexcept
+    { return iter.coro_.done(); }
+
+  private:
+    friend generator;
+
+    explicit iterator(handle coro) noexcept : coro_{ coro } {}
+
+    handle coro_;
+  };
+
+  generator() noexcept = default;
+
+  generator(generator &&) noexcept = default;
+  generator &operator=(generator &&) noexcept = default;
+
+  generator(const generator &) = delete;
+  generator &operator=(const generator &) = delete;
+
+  ~generator() = default;
+
+  /// @brief Starts the coroutine, shall be called at most once
+  [[nodiscard]] iterator begin()
+  {
+    const handle coro = coro_.get();
+    coro.promise().active_ = coro;
+    coro.resume();
+    return iterator{ coro };
+  }
+
+  [[nodiscard]] static constexpr std::default_sentinel_t end() noexcept { return {}; }
+
+private:
+  template<typename> friend class detail::generator_promise_base;
+
+  explicit generator(handle coro) noexcept : coro_{ coro } {}
+
+  unique_coroutine_handle<promise_type> coro_;
+};
+
+RAII_NS_END
+
+#endif// RAII_GENERATOR_HPP
@@ -0,0 +1,889 @@
+// Asynchronous file I/O on io_uring, with a thread pool fallback -*- C++ -*-
+
+#ifndef RAII_IO_CONTEXT_HPP
+#define RAII_IO_CONTEXT_HPP
+
+#include "deleter_posix.hpp"
+#include "raii_defs.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+#include "unique_rc.hpp"
+
+#include <fcntl.h>// AT_FDCWD, openat
+#include <linux/io_uring.h>
+#include <sys/mman.h>// mmap, munmap
+#include <sys/syscall.h>// __NR_io_uring_setup, __NR_io_uring_enter, __NR_io_uring_register
+#include <sys/types.h>// mode_t
+#include <sys/uio.h>// iovec
+#include <unistd.h>// syscall, pread, pwrite, fsync, fdatasync
+
+#include <algorithm>// std::max, std::min, std::ranges::swap
+#include <array>
+#include <atomic>// std::atomic_ref
+#include <cerrno>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>// std::size_t, std::byte
+#include <cstdint>// std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t, std::uintptr_t
+#include <mutex>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <thread>// std::this_thread::yield
+#include <type_traits>
+#include <utility>// std::exchange, std::move
+#include <vector>
+
+
+RAII_NS_BEGIN
+
+namespace deleter {
+namespace posix {
+
+  /// @brief Unmaps the submission queue entries and the rings of an io_uring instance and closes its descriptor
+  struct io_uring_close
+  {
+    struct handle
+    {
+      int fd;
+      void *sq_ring;
+      void *cq_ring;// same as sq_ring, if the kernel maps both rings at once (IORING_FEAT_SINGLE_MMAP)
+      void *sqes;
+      std::size_t sq_ring_size;
+      std::size_t cq_ring_size;
+      std::size_t sqes_size;
+
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+      raii_inline constexpr explicit handle(int ring_fd) noexcept
+        : fd{ ring_fd }, sq_ring{ nullptr }, cq_ring{ nullptr }, sqes{ nullptr }, sq_ring_size{ 0 }, cq_ring_size{ 0 },
+          sqes_size{ 0 }
+      {}
+
+      raii_inline constexpr handle() noexcept : handle(-1) {}
+
+      constexpr handle(const handle &) noexcept = default;
+      constexpr handle(handle &&) noexcept = default;
+
+      constexpr handle &operator=(const handle &) noexcept = default;
+      constexpr handle &operator=(handle &&) noexcept = default;
+
+      constexpr ~handle() noexcept = default;
+
+      [[nodiscard]] raii_inline constexpr int operator*() const noexcept { return fd; }
+
+      // The mappings are derived from the descriptor
+      [[nodiscard]] friend raii_inline constexpr bool operator==(const handle &lhs, const handle &rhs) noexcept
+      { return lhs.fd == rhs.fd; }
+
+      friend raii_inline constexpr void swap(handle &lhs, handle &rhs) noexcept
+      {
+        std::ranges::swap(lhs.fd, rhs.fd);
+        std::ranges::swap(lhs.sq_ring, rhs.sq_ring);
+        std::ranges::swap(lhs.cq_ring, rhs.cq_ring);
+        std::ranges::swap(lhs.sqes, rhs.sqes);
+        std::ranges::swap(lhs.sq_ring_size, rhs.sq_ring_size);
+        std::ranges::swap(lhs.cq_ring_size, rhs.cq_ring_size);
+        std::ranges::swap(lhs.sqes_size, rhs.sqes_size);
+      }
+    };// handle
+
+
+#ifdef __cpp_static_call_operator
+    // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+    // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+    raii_inline static void operator()(handle hnd) noexcept
+#else
+    raii_inline void operator()(handle hnd) const noexcept
+#endif
+    {
+      // A partially set up instance has some of the mappings missing
+      if (hnd.sqes != nullptr) { static_cast<void>(munmap(hnd.sqes, hnd.sqes_size)); }
+      if (hnd.cq_ring != nullptr && hnd.cq_ring != hnd.sq_ring) {
+        static_cast<void>(munmap(hnd.cq_ring, hnd.cq_ring_size));
+      }
+      if (hnd.sq_ring != nullptr) { static_cast<void>(munmap(hnd.sq_ring, hnd.sq_ring_size)); }
+      static_cast<void>(::close(hnd.fd));
+    }
+  };// io_uring_close
+
+  template<typename Handle, typename Invalid = Handle> struct io_uring_invalid_handle_policy
+  {
+    using invalid_type = Invalid;
+
+    [[nodiscard]] raii_inline static constexpr invalid_type invalid() noexcept { return {}; }
+
+    [[nodiscard]] raii_inline static constexpr bool is_owned(Handle hnd) noexcept { return hnd.fd >= 0; }
+
+    /// @brief Disabled because policy provides only typedefs and static methods
+    constexpr io_uring_invalid_handle_policy() = delete;
+    constexpr ~io_uring_invalid_handle_policy() = delete;
+
+    constexpr io_uring_invalid_handle_policy(const io_uring_invalid_handle_policy &) = delete;
+    constexpr io_uring_invalid_handle_policy &operator=(const io_uring_invalid_handle_policy &) = delete;
+
+    constexpr io_uring_invalid_handle_policy(io_uring_invalid_handle_policy &&) = delete;
+    constexpr io_uring_invalid_handle_policy &operator=(io_uring_invalid_handle_policy &&) = delete;
+  };// io_uring_invalid_handle_policy
+
+}// namespace posix
+}// namespace deleter
+
+
+/// @brief Owned io_uring instance, the ring descriptor together with the mapped rings
+using unique_io_uring = unique_rc<deleter::posix::io_uring_close::handle,
+  deleter::posix::io_uring_close,
+  resolve_handle_type,
+  deleter::posix::io_uring_close::handle,
+  deleter::posix::io_uring_invalid_handle_policy>;
+
+
+/// @brief Index into the files registered with io_context::register_files
+struct fixed_file
+{
+  unsigned index;
+};
+
+/// @brief Index into the buffers registered with io_context::register_buffers
+struct fixed_buffer
+{
+  unsigned index;
+};
+
+/// @brief File an operation works on: a borrowed descriptor, an owned one or a registered file
+class file_ref
+{
+public:
+  // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+  constexpr file_ref(int fd) noexcept : fd_{ fd } {}
+
+  // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+  constexpr file_ref(const unique_fd &fd) noexcept : fd_{ fd.get() } {}
+
+  // NOLINTNEXTLINE(google-explicit-constructor, hicpp-explicit-conversions)
+  constexpr file_ref(fixed_file file) noexcept : fd_{ static_cast<int>(file.index) }, fixed_{ true } {}
+
+  /// @brief Returns the descriptor or the index of the registered file
+  [[nodiscard]] constexpr int get() const noexcept { return fd_; }
+
+  [[nodiscard]] constexpr bool fixed() const noexcept { return fixed_; }
+
+private:
+  int fd_;
+  bool fixed_{ false };
+};
+
+enum class io_backend : std::uint8_t
+{
+  io_uring,
+  thread_pool
+};
+
+class io_context;
+
+namespace detail {
+
+  // One operation, described the same way for both backends
+  struct io_request
+  {
+    std::uint64_t addr{ 0 };
+    std::uint64_t offset{ 0 };
+    std::uint32_t len{ 0 };
+    std::uint32_t op_flags{ 0 };// open flags for openat, IORING_FSYNC_DATASYNC for fsync
+    int fd{ -1 };
+    std::uint16_t buf_index{ 0 };
+    std::uint8_t opcode{ IORING_OP_NOP };
+    bool fixed_file{ false };
+    bool fixed_buffer{ false };
+  };
+
+  // The part of an awaiter, which the context sees, user_data of the submission queue entry points to it
+  class io_operation
+  {
+  public:
+    io_operation(const io_operation &) = delete;
+    io_operation &operator=(const io_operation &) = delete;
+    io_operation(io_operation &&) = delete;
+    io_operation &operator=(io_operation &&) = delete;
+
+  protected:
+    io_operation(io_context &ctx, const io_request &req) noexcept : ctx_{ &ctx }, request_{ req } {}
+    ~io_operation() = default;
+
+    // Throws std::system_error for a failed operation
+    void check_result() const
+    {
+      if (result_ < 0) { throw std::system_error{ -result_, std::system_category(), name() }; }
+    }
+
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    io_context *ctx_;
+    io_request request_;
+    int result_{ 0 };
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+
+  private:
+    friend io_context;
+
+    [[nodiscard]] const char *name() const noexcept
+    {
+      switch (request_.opcode) {
+      case IORING_OP_READ:
+      case IORING_OP_READ_FIXED:
+        return "raii::io_context::read";
+      case IORING_OP_WRITE:
+      case IORING_OP_WRITE_FIXED:
+        return "raii::io_context::write";
+      case IORING_OP_OPENAT:
+        return "raii::io_context::openat";
+      case IORING_OP_CLOSE:
+        return "raii::io_context::close";
+      case IORING_OP_FSYNC:
+        return "raii::io_context::fsync";
+      default:
+        return "raii::io_context";
+      }
+    }
+
+    std::coroutine_handle<> waiter_;
+    io_operation *next_{ nullptr };
+  };
+
+  template<typename T> T *ring_field(void *base, std::uint32_t offset) noexcept
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return static_cast<T *>(static_cast<void *>(static_cast<std::byte *>(base) + offset));
+  }
+
+  /**
+   * @brief Submission and completion rings of an io_uring instance, used by one thread.
+   *
+   * Only the indices shared with the kernel are accessed atomically, entries are written and read in place, there is
+   * no copy and no lock.
+   **/
+  class io_uring_queue
+  {
+  public:
+    io_uring_queue() noexcept = default;
+
+    /// @brief Sets up an instance, returns an empty queue, if io_uring or one of the operations is not available
+    [[nodiscard]] static io_uring_queue create(unsigned entries) noexcept
+    {
+      io_uring_params params{};
+      unique_io_uring ring{ setup(entries, params) };
+      if (!ring || !supports_operations(ring.get().fd)) { return {}; }
+      return io_uring_queue{ std::move(ring), params };
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept { return static_cast<bool>(ring_); }
+
+    [[nodiscard]] int fd() const noexcept { return ring_.get().fd; }
+
+    /// @brief Number of operations, which may be in flight without overflowing the completion ring
+    [[nodiscard]] unsigned capacity() const noexcept { return cq_entries_; }
+
+    /// @brief Copies the request into the next free entry, returns false, if the submission ring is full
+    [[nodiscard]] bool try_push(const io_request &req, std::uint64_t user_data) noexcept
+    {
+      const unsigned head = std::atomic_ref<unsigned>{ *sq_head_ }.load(std::memory_order_acquire);
+      if (sq_tail_ - head == sq_entries_) { return false; }
+
+      const unsigned index = sq_tail_ & sq_mask_;
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      io_uring_sqe &sqe = sqes_[index];
+      sqe = io_uring_sqe{};
+      sqe.opcode = req.opcode;
+      sqe.flags = req.fixed_file ? static_cast<std::uint8_t>(IOSQE_FIXED_FILE) : std::uint8_t{ 0 };
+      sqe.fd = req.fd;
+      sqe.off = req.offset;
+      sqe.addr = req.addr;
+      sqe.len = req.len;
+      // rw_flags, open_flags and fsync_flags share the storage
+      sqe.open_flags = req.op_flags;
+      sqe.buf_index = req.buf_index;
+      sqe.user_data = user_data;
+
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      sq_array_[index] = index;
+      ++sq_tail_;
+      std::atomic_ref<unsigned>{ *sq_tail_ptr_ }.store(sq_tail_, std::memory_order_release);
+      ++to_submit_;
+      return true;
+    }
+
+    [[nodiscard]] bool completions_ready() const noexcept
+    {
+      return std::atomic_ref<unsigned>{ *cq_tail_ }.load(std::memory_order_acquire)
+             != std::atomic_ref<unsigned>{ *cq_head_ }.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Submits the new entries and waits for at least min_complete completions
+    /// @throw std::system_error, if io_uring_enter fails for another reason than an interrupt or a full ring
+    void enter(unsigned min_complete)
+    {
+      if (to_submit_ == 0 && min_complete == 0) { return; }
+      const unsigned flags = (min_complete != 0) ? IORING_ENTER_GETEVENTS : 0U;
+      const long res = syscall(__NR_io_uring_enter, fd(), to_submit_, min_complete, flags, nullptr, 0);
+      if (res >= 0) {
+        to_submit_ -= static_cast<unsigned>(res);
+        return;
+      }
+      // Interrupted, or the kernel wants the completions to be reaped first, the caller comes back
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) { return; }
+      throw std::system_error{ errno, std::system_category(), "io_uring_enter" };
+    }
+
+    /// @brief Calls fn with the user_data and the result of every completion, which is ready
+    template<typename Fn> std::size_t reap(Fn &&fn)
+    {
+      std::atomic_ref<unsigned> head_ref{ *cq_head_ };
+      unsigned head = head_ref.load(std::memory_order_relaxed);
+      const unsigned tail = std::atomic_ref<unsigned>{ *cq_tail_ }.load(std::memory_order_acquire);
+      std::size_t count = 0;
+      for (; head != tail; ++head, ++count) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+        const std::uint64_t user_data = cqe.user_data;
+        const int res = cqe.res;
+        // The entry is handed back to the kernel before fn runs, fn may submit and reap again
+        head_ref.store(head + 1, std::memory_order_release);
+        fn(user_data, res);
+      }
+      return count;
+    }
+
+    void register_resource(unsigned opcode, const void *arg, unsigned count)
+    {
+      if (syscall(__NR_io_uring_register, fd(), opcode, arg, count) < 0) {
+        throw std::system_error{ errno, std::system_category(), "io_uring_register" };
+      }
+    }
+
+  private:
+    io_uring_queue(unique_io_uring ring, const io_uring_params &params) noexcept : ring_{ std::move(ring) }
+    {
+      const auto &hnd = ring_.get();
+      sq_head_ = ring_field<unsigned>(hnd.sq_ring, params.sq_off.head);
+      sq_tail_ptr_ = ring_field<unsigned>(hnd.sq_ring, params.sq_off.tail);
+      sq_mask_ = *ring_field<unsigned>(hnd.sq_ring, params.sq_off.ring_mask);
+      sq_array_ = ring_field<unsigned>(hnd.sq_ring, params.sq_off.array);
+      sq_entries_ = params.sq_entries;
+      sq_tail_ = *sq_tail_ptr_;
+      sqes_ = static_cast<io_uring_sqe *>(hnd.sqes);
+
+      cq_head_ = ring_field<unsigned>(hnd.cq_ring, params.cq_off.head);
+      cq_tail_ = ring_field<unsigned>(hnd.cq_ring, params.cq_off.tail);
+      cq_mask_ = *ring_field<unsigned>(hnd.cq_ring, params.cq_off.ring_mask);
+      cqes_ = ring_field<io_uring_cqe>(hnd.cq_ring, params.cq_off.cqes);
+      cq_entries_ = params.cq_entries;
+    }
+
+    [[nodiscard]] static unique_io_uring::handle setup(unsigned entries, io_uring_params &params) noexcept
+    {
+      const long ring_fd = syscall(__NR_io_uring_setup, entries, &params);
+      if (ring_fd < 0) { return {}; }
+
+      unique_io_uring::handle hnd{ static_cast<int>(ring_fd) };
+      hnd.sq_ring_size = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+      hnd.cq_ring_size = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+      if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        hnd.sq_ring_size = hnd.cq_ring_size = std::max(hnd.sq_ring_size, hnd.cq_ring_size);
+      }
+      hnd.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+      const auto map = [&hnd](std::size_t size, off_t offset) noexcept -> void * {
+        void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, hnd.fd, offset);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast, performance-no-int-to-ptr)
+        return (addr == MAP_FAILED) ? nullptr : addr;
+      };
+      hnd.sq_ring = map(hnd.sq_ring_size, IORING_OFF_SQ_RING);
+      hnd.cq_ring =
+        ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) ? hnd.sq_ring : map(hnd.cq_ring_size, IORING_OFF_CQ_RING);
+      hnd.sqes = map(hnd.sqes_size, IORING_OFF_SQES);
+      if (hnd.sq_ring == nullptr || hnd.cq_ring == nullptr || hnd.sqes == nullptr) {
+        deleter::posix::io_uring_close{}(hnd);
+        return {};
+      }
+      return hnd;
+    }
+
+    // IORING_REGISTER_PROBE arrived together with the read, write, openat and close operations (Linux 5.6)
+    [[nodiscard]] static bool supports_operations(int ring_fd) noexcept
+    {
+      constexpr unsigned max_ops = 256;
+      alignas(io_uring_probe) std::array<std::byte, sizeof(io_uring_probe) + (max_ops * sizeof(io_uring_probe_op))>
+        buffer{};
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+      if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, max_ops) < 0) { return false; }
+
+      constexpr std::array<std::uint8_t, 7> required{ IORING_OP_READ,
+        IORING_OP_WRITE,
+        IORING_OP_READ_FIXED,
+        IORING_OP_WRITE_FIXED,
+        IORING_OP_OPENAT,
+        IORING_OP_CLOSE,
+        IORING_OP_FSYNC };
+      return std::ranges::all_of(required, [probe](std::uint8_t opcode) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+        return opcode < probe->ops_len && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+      });
+    }
+
+    unique_io_uring ring_;
+
+    unsigned *sq_head_{ nullptr };
+    unsigned *sq_tail_ptr_{ nullptr };
+    unsigned *sq_array_{ nullptr };
+    io_uring_sqe *sqes_{ nullptr };
+    unsigned sq_mask_{ 0 };
+    unsigned sq_entries_{ 0 };
+    unsigned sq_tail_{ 0 };
+    unsigned to_submit_{ 0 };
+
+    unsigned *cq_head_{ nullptr };
+    unsigned *cq_tail_{ nullptr };
+    io_uring_cqe *cqes_{ nullptr };
+    unsigned cq_mask_{ 0 };
+    unsigned cq_entries_{ 0 };
+  };
+
+  // Converts an address stored in a 64-bit field, addr of a request or user_data of a completion, back to a pointer.
+  // The integer is narrowed only where pointers are narrower, elsewhere the cast would be useless. Address is
+  // a template parameter, so the discarded branch is not checked for 64-bit targets
+  template<typename T, typename Address = std::uintptr_t>
+  [[nodiscard]] raii_inline T *address_cast(std::uint64_t addr) noexcept
+  {
+    if constexpr (sizeof(Address) < sizeof(addr)) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+      return reinterpret_cast<T *>(static_cast<Address>(addr));
+    } else {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+      return reinterpret_cast<T *>(addr);
+    }
+  }
+
+  // Runs the request as a blocking system call, used by the thread pool fallback
+  [[nodiscard]] raii_inline int run_blocking(const io_request &req) noexcept
+  {
+    void *buf = address_cast<void>(req.addr);
+    const auto offset = static_cast<off_t>(req.offset);
+    long res = 0;
+    switch (req.opcode) {
+    case IORING_OP_READ:
+    case IORING_OP_READ_FIXED:
+      res = (req.offset == ~std::uint64_t{ 0 }) ? ::read(req.fd, buf, req.len) : ::pread(req.fd, buf, req.len, offset);
+      break;
+    case IORING_OP_WRITE:
+    case IORING_OP_WRITE_FIXED:
+      res =
+        (req.offset == ~std::uint64_t{ 0 }) ? ::write(req.fd, buf, req.len) : ::pwrite(req.fd, buf, req.len, offset);
+      break;
+    case IORING_OP_OPENAT: {
+      const mode_t mode = req.len;
+      res = ::openat(req.fd, static_cast<const char *>(buf), static_cast<int>(req.op_flags), mode);
+      break;
+    }
+    case IORING_OP_CLOSE:
+      res = ::close(req.fd);
+      break;
+    case IORING_OP_FSYNC:
+      res = ((req.op_flags & IORING_FSYNC_DATASYNC) != 0) ? ::fdatasync(req.fd) : ::fsync(req.fd);
+      break;
+    default:
+      return -EINVAL;
+    }
+    return (res < 0) ? -errno : static_cast<int>(res);
+  }
+
+}// namespace detail
+
+
+/**
+ * @brief raii::io_context runs asynchronous file operations for coroutines on io_uring.
+ *
+ * The io_uring instance is owned by raii::unique_io_uring, the deleter unmaps the rings and closes the descriptor.
+ * Operations are queued, when they are awaited, and submitted in a batch with a single io_uring_enter, when the
+ * context runs, so a coroutine reading many small records costs no system call per read. Buffers and files, which are
+ * used over and over, may be registered to avoid mapping them for every operation.
+ *
+ * If io_uring is not available (an old kernel, a seccomp filter, kernel.io_uring_disabled), the operations run as
+ * blocking system calls on a raii::thread_pool instead.
+ *
+ * Awaiting coroutines are resumed on the thread, which runs the context, with either backend. The context is used by
+ * one thread: the operations must be awaited on that thread and an awaiting coroutine must not be destroyed, while
+ * its operation is in flight.
+ * @code
+ * raii::task<std::size_t> count(raii::io_context &ctx) {
+ *   raii::unique_fd file = co_await ctx.openat(AT_FDCWD, "app.log", O_RDONLY);
+ *   std::array<std::byte, 4096> buf;
+ *   std::size_t total = 0;
+ *   while (const std::size_t len = co_await ctx.read(file, buf, total)) { total += len; }
+ *   co_return total;
+ * }
+ * raii::io_context ctx;
+ * std::size_t size = ctx.run(count(ctx));
+ * @endcode
+ **/
+class io_context
+{
+public:
+  /// @brief Offset of read and write, which uses and advances the file position, e.g. for pipes
+  static constexpr std::uint64_t current_position = ~std::uint64_t{ 0 };
+
+  /**
+   * @param entries size of the submission ring, the kernel rounds it up to a power of two
+   * @param backend io_backend::thread_pool skips io_uring, io_backend::io_uring falls back to the thread pool, if
+   * io_uring is not available
+   **/
+  explicit io_context(unsigned entries = 256, io_backend backend = io_backend::io_uring)
+  {
+    if (backend == io_backend::io_uring) { ring_ = detail::io_uring_queue::create(std::max(entries, 1U)); }
+    if (!ring_) { pool_.emplace(); }
+  }
+
+  io_context(const io_context &) = delete;
+  io_context &operator=(const io_context &) = delete;
+  io_context(io_context &&) = delete;
+  io_context &operator=(io_context &&) = delete;
+
+  ~io_context() = default;
+
+  [[nodiscard]] io_backend backend() const noexcept { return ring_ ? io_backend::io_uring : io_backend::thread_pool; }
+
+  /// @brief Number of operations awaited and not completed yet
+  [[nodiscard]] std::size_t in_flight() const noexcept { return in_flight_; }
+
+  /// @brief Awaitable, which reads up to buf.size() bytes at offset, returns the number of bytes read, 0 at the end
+  /// @throw std::system_error, if the read fails
+  [[nodiscard]] auto read(file_ref file, std::span<std::byte> buf, std::uint64_t offset = current_position) noexcept
+  { return io_awaiter<std::size_t>{ *this, rw_request(IORING_OP_READ, file, buf.data(), buf.size(), offset) }; }
+
+  /// @brief Reads into a part of a registered buffer
+  [[nodiscard]] auto read(file_ref file, std::span<std::byte> buf, std::uint64_t offset, fixed_buffer index) noexcept
+  {
+    return io_awaiter<std::size_t>{ *this,
+      fixed_request(rw_request(IORING_OP_READ_FIXED, file, buf.data(), buf.size(), offset), index) };
+  }
+
+  /// @brief Awaitable, which writes up to buf.size() bytes at offset, returns the number of bytes written
+  /// @throw std::system_error, if the write fails
+  [[nodiscard]] auto write(file_ref file,
+    std::span<const std::byte> buf,
+    std::uint64_t offset = current_position) noexcept
+  { return io_awaiter<std::size_t>{ *this, rw_request(IORING_OP_WRITE, file, buf.data(), buf.size(), offset) }; }
+
+  /// @brief Writes from a part of a registered buffer
+  [[nodiscard]] auto write(file_ref file,
+    std::span<const std::byte> buf,
+    std::uint64_t offset,
+    fixed_buffer index) noexcept
+  {
+    return io_awaiter<std::size_t>{ *this,
+      fixed_request(rw_request(IORING_OP_WRITE_FIXED, file, buf.data(), buf.size(), offset), index) };
+  }
+
+  /**
+   * @brief Awaitable, which opens a file relative to the directory dir (or AT_FDCWD) with O_CLOEXEC, returns the
+   * owned descriptor
+   * @param path has to stay valid until the operation completes
+   * @throw std::system_error, if the file cannot be opened
+   **/
+  [[nodiscard]] auto openat(int dir, const char *path, int flags, mode_t mode = 0) noexcept
+  {
+    detail::io_request req;
+    req.opcode = IORING_OP_OPENAT;
+    req.fd = dir;
+    req.addr = reinterpret_cast<std::uintptr_t>(path);// NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    req.len = mode;
+    req.op_flags = static_cast<std::uint32_t>(flags | O_CLOEXEC);
+    return io_awaiter<unique_fd>{ *this, req };
+  }
+
+  /// @brief Awaitable, which closes the descriptor, the descriptor is closed by the destructor of the awaiter, if
+  /// the awaiter is never awaited
+  /// @throw std::system_error, if close reports an error, the descriptor is released anyway
+  [[nodiscard]] auto close(unique_fd file) noexcept
+  {
+    detail::io_request req;
+    req.opcode = IORING_OP_CLOSE;
+    return close_awaiter{ *this, req, std::move(file) };
+  }
+
+  /// @brief Awaitable, which flushes the data and, unless data_only is set, the metadata of the file to the device
+  /// @throw std::system_error, if the flush fails
+  [[nodiscard]] auto fsync(file_ref file, bool data_only = false) noexcept
+  {
+    detail::io_request req;
+    req.opcode = IORING_OP_FSYNC;
+    set_file(req, file);
+    req.op_flags = data_only ? IORING_FSYNC_DATASYNC : 0U;
+    return io_awaiter<void>{ *this, req };
+  }
+
+  /**
+   * @brief Registers buffers, the kernel pins their pages once instead of for every operation, which uses them.
+   * Replaces the buffers registered before, the buffers have to outlive their registration.
+   * @throw std::system_error, if the kernel refuses, e.g. RLIMIT_MEMLOCK is exceeded
+   **/
+  void register_buffers(std::span<const std::span<std::byte>> buffers)
+  {
+    if (!ring_) { return; }
+    unregister_buffers();
+    std::vector<iovec> vecs;
+    vecs.reserve(buffers.size());
+    for (const auto &buf : buffers) { vecs.push_back(iovec{ buf.data(), buf.size() }); }
+    ring_.register_resource(IORING_REGISTER_BUFFERS, vecs.data(), static_cast<unsigned>(vecs.size()));
+    buffers_registered_ = true;
+  }
+
+  void unregister_buffers()
+  {
+    if (ring_ && std::exchange(buffers_registered_, false)) {
+      ring_.register_resource(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+    }
+  }
+
+  /**
+   * @brief Registers files, the kernel looks the descriptors up once instead of for every operation, which uses
+   * fixed_file{ index }. Replaces the files registered before, the descriptors stay owned by the caller.
+   * @throw std::system_error, if the kernel refuses
+   **/
+  void register_files(std::span<const int> fds)
+  {
+    unregister_files();
+    if (ring_) {
+      ring_.register_resource(IORING_REGISTER_FILES, fds.data(), static_cast<unsigned>(fds.size()));
+      files_registered_ = true;
+    } else {
+      files_.assign(fds.begin(), fds.end());
+    }
+  }
+
+  void unregister_files()
+  {
+    files_.clear();
+    if (ring_ && std::exchange(files_registered_, false)) {
+      ring_.register_resource(IORING_UNREGISTER_FILES, nullptr, 0);
+    }
+  }
+
+  /**
+   * @brief Submits the queued operations, waits until at least one of them completes and resumes the awaiting
+   * coroutines of all completed operations
+   * @return number of resumed coroutines, 0 if no operation is in flight
+   * @throw std::system_error, if io_uring_enter fails
+   **/
+  std::size_t run_once()
+  {
+    if (ring_) { return run_ring(); }
+    return run_pool();
+  }
+
+  /**
+   * @brief Runs the task on the calling thread and the operations it awaits, until it completes
+   * @return the result of the task
+   * @throw any exception thrown by the task
+   **/
+  template<typename T> T run(task<T> work)
+  {
+    detail::task_result<T> result;
+    task<> driver = drive(work, result);
+    driver.get().resume();
+    while (!driver.done()) {
+      if (run_once() == 0) { std::this_thread::yield(); }
+    }
+    if constexpr (std::is_void_v<T>) {
+      result.get();
+    } else {
+      return std::move(result).get();
+    }
+  }
+
+private:
+  template<typename Result> class io_awaiter : public detail::io_operation
+  {
+  public:
+    io_awaiter(io_context &ctx, const detail::io_request &req) noexcept : io_operation{ ctx, req } {}
+
+    static constexpr bool await_ready() noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> waiter) { ctx_->submit(*this, waiter); }
+
+    Result await_resume()
+    {
+      check_result();
+      if constexpr (std::is_same_v<Result, std::size_t>) {
+        return static_cast<std::size_t>(result_);
+      } else if constexpr (std::is_same_v<Result, unique_fd>) {
+        // The descriptor is handed over once, another call reports EBADF instead of creating a second owner
+        return unique_fd{ std::exchange(result_, -EBADF) };
+      }
+    }
+  };
+
+  class close_awaiter : public io_awaiter<void>
+  {
+  public:
+    close_awaiter(io_context &ctx, const detail::io_request &req, unique_fd file) noexcept
+      : io_awaiter<void>{ ctx, req }, file_{ std::move(file) }
+    {}
+
+    void await_suspend(std::coroutine_handle<> waiter)
+    {
+      request_.fd = file_.release();
+      ctx_->submit(*this, waiter);
+    }
+
+  private:
+    unique_fd file_;
+  };
+
+  static void set_file(detail::io_request &req, file_ref file) noexcept
+  {
+    req.fd = file.get();
+    req.fixed_file = file.fixed();
+  }
+
+  [[nodiscard]] static detail::io_request
+    rw_request(std::uint8_t opcode, file_ref file, const std::byte *buf, std::size_t len, std::uint64_t offset) noexcept
+  {
+    // Linux transfers at most 0x7ffff000 bytes in one call
+    constexpr std::size_t max_len = 0x7ffff000;
+    detail::io_request req;
+    req.opcode = opcode;
+    set_file(req, file);
+    req.addr = reinterpret_cast<std::uintptr_t>(buf);// NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    req.len = static_cast<std::uint32_t>(std::min(len, max_len));
+    req.offset = offset;
+    return req;
+  }
+
+  [[nodiscard]] static detail::io_request fixed_request(detail::io_request req, fixed_buffer index) noexcept
+  {
+    req.buf_index = static_cast<std::uint16_t>(index.index);
+    req.fixed_buffer = true;
+    return req;
+  }
+
+  template<typename T> static task<> drive(task<T> &work, detail::task_result<T> &result)
+  {
+    try {
+      if constexpr (std::is_void_v<T>) {
+        co_await std::move(work);
+      } else {
+        result.set_value(co_await std::move(work));
+      }
+    } catch (...) {
+      result.set_exception(std::current_exception());
+    }
+  }
+
+  void submit(detail::io_operation &op, std::coroutine_handle<> waiter)
+  {
+    op.waiter_ = waiter;
+    if (ring_) {
+      // Kept back, while the completion ring could overflow, run_once submits it later
+      if (pending_head_ != nullptr || in_flight_ >= ring_.capacity() || !push(op)) { push_pending(op); }
+      return;
+    }
+
+    // Registered files are looked up here, the workers never read files_
+    if (op.request_.fixed_file) {
+      const auto index = static_cast<std::size_t>(op.request_.fd);
+      op.request_.fd = (index < files_.size()) ? files_[index] : -1;
+      op.request_.fixed_file = false;
+    }
+    task<> blocking = blocking_call(*this, op);
+    ++in_flight_;
+    pool_->spawn(std::move(blocking));
+  }
+
+  [[nodiscard]] bool push(detail::io_operation &op) noexcept
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (!ring_.try_push(op.request_, reinterpret_cast<std::uintptr_t>(&op))) { return false; }
+    ++in_flight_;
+    return true;
+  }
+
+  void push_pending(detail::io_operation &op) noexcept
+  {
+    op.next_ = nullptr;
+    if (pending_tail_ != nullptr) {
+      pending_tail_->next_ = &op;
+    } else {
+      pending_head_ = &op;
+    }
+    pending_tail_ = &op;
+  }
+
+  std::size_t run_ring()
+  {
+    while (pending_head_ != nullptr && in_flight_ < ring_.capacity() && push(*pending_head_)) {
+      pending_head_ = pending_head_->next_;
+      if (pending_head_ == nullptr) { pending_tail_ = nullptr; }
+    }
+    if (in_flight_ == 0) { return 0; }
+
+    ring_.enter(ring_.completions_ready() ? 0U : 1U);
+    return ring_.reap([this](std::uint64_t user_data, int res) {
+      auto *op = detail::address_cast<detail::io_operation>(user_data);
+      op->result_ = res;
+      --in_flight_;
+      op->waiter_.resume();
+    });
+  }
+
+  static task<> blocking_call(io_context &ctx, detail::io_operation &op)
+  {
+    op.result_ = detail::run_blocking(op.request_);
+    {
+      const std::lock_guard lock{ ctx.completed_mutex_ };
+      op.next_ = std::exchange(ctx.completed_, &op);
+    }
+    ctx.completed_ready_.notify_one();
+    co_return;
+  }
+
+  std::size_t run_pool()
+  {
+    if (in_flight_ == 0) { return 0; }
+
+    std::unique_lock lock{ completed_mutex_ };
+    completed_ready_.wait(lock, [this] { return completed_ != nullptr; });
+    detail::io_operation *done = std::exchange(completed_, nullptr);
+    lock.unlock();
+
+    // Completed operations are pushed in front, reversed they are resumed in the order of completion
+    detail::io_operation *ordered = nullptr;
+    while (done != nullptr) { ordered = std::exchange(done, std::exchange(done->next_, ordered)); }
+
+    std::size_t count = 0;
+    while (ordered != nullptr) {
+      detail::io_operation *op = std::exchange(ordered, ordered->next_);
+      --in_flight_;
+      ++count;
+      op->waiter_.resume();
+    }
+    return count;
+  }
+
+  detail::io_uring_queue ring_;
+  std::size_t in_flight_{ 0 };
+  detail::io_operation *pending_head_{ nullptr };
+  detail::io_operation *pending_tail_{ nullptr };
+  bool buffers_registered_{ false };
+  bool files_registered_{ false };
+
+  // Thread pool fallback
+  std::vector<int> files_;
+  std::mutex completed_mutex_;
+  std::condition_variable completed_ready_;
+  detail::io_operation *completed_{ nullptr };
+  // Declared last, the workers are joined before the completion list goes away
+  std::optional<thread_pool> pool_;
+};
+
+RAII_NS_END
+
+#endif// RAII_IO_CONTEXT_HPP
@@ -0,0 +1,226 @@
+// Structured concurrency scope owning the frames of spawned coroutines -*- C++ -*-
+
+#ifndef RAII_NURSERY_HPP
+#define RAII_NURSERY_HPP
+
+#include "frame_allocator.hpp"
+#include "raii_defs.hpp"
+#include "task.hpp"
+#include "unique_coroutine_handle.hpp"
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>// std::size_t
+#include <exception>// std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <mutex>
+#include <utility>// std::move, std::exchange
+
+
+RAII_NS_BEGIN
+
+class nursery;
+
+namespace detail {
+
+  /**
+   * @brief Coroutine, which runs one child of a nursery.
+   *
+   * The promise is the node of the intrusive list of children: every node owns the next one by
+   * unique_coroutine_handle, so each frame has exactly one owner, the nursery or the previous sibling, at any time.
+   **/
+  class nursery_child
+  {
+  public:
+    struct promise_type;
+    using owner = unique_coroutine_handle<promise_type>;
+
+    struct promise_type : pooled_frame_promise
+    {
+      nursery_child get_return_object() noexcept
+      { return nursery_child{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+
+      static std::suspend_always initial_suspend() noexcept { return {}; }
+
+      [[nodiscard]] static auto final_suspend() noexcept;
+
+      static constexpr void return_void() noexcept {}
+
+      void unhandled_exception() noexcept;
+
+      nursery *scope{ nullptr };
+      owner next;
+      promise_type *prev{ nullptr };
+    };
+
+    [[nodiscard]] owner release() && noexcept { return std::move(coro_); }
+
+  private:
+    explicit nursery_child(std::coroutine_handle<promise_type> coro) noexcept : coro_{ coro } {}
+
+    owner coro_;
+  };
+
+  template<typename T> nursery_child run_in_nursery(task<T> work) { static_cast<void>(co_await std::move(work)); }
+
+}// namespace detail
+
+
+/**
+ * @brief raii::nursery is a scope for fire-and-forget coroutines. Spawned tasks start right away and the nursery
+ * owns their frames, until they complete, then the frames are destroyed by the thread completing them.
+ * `co_await scope.join()` waits until all children have completed and rethrows the first exception of a child.
+ *
+ * The children are kept in an intrusive list, whose nodes are the promises of the coroutines running the children,
+ * there is no separate list node per child. Every frame is owned by exactly one raii::unique_coroutine_handle at any
+ * time, so no frame is leaked and none is destroyed twice.
+ *
+ * The destructor cancels the children still in the scope by destroying their frames, the destructors of their
+ * locals run as if the children had returned at their current suspension points. A child must therefore not run on
+ * another thread, nor be queued for resumption elsewhere, when the nursery is destroyed, joining first guarantees it.
+ * @code
+ * raii::task<> serve(raii::thread_pool &pool, listener &lst) {
+ *   raii::nursery scope;
+ *   while (auto conn = co_await lst.accept()) { scope.spawn(handle_connection(pool, std::move(conn))); }
+ *   co_await scope.join();
+ * }
+ * @endcode
+ **/
+class nursery
+{
+public:
+  nursery() noexcept = default;
+
+  nursery(const nursery &) = delete;
+  nursery &operator=(const nursery &) = delete;
+  nursery(nursery &&) = delete;
+  nursery &operator=(nursery &&) = delete;
+
+  ~nursery()
+  {
+    // Iteratively, releasing the head would otherwise destroy the siblings recursively
+    child_owner cur = std::move(head_);
+    while (cur) {
+      child_owner next = std::move(cur.get().promise().next);
+      cur.reset();
+      cur = std::move(next);
+    }
+  }
+
+  /// @brief Number of children, which have not completed yet
+  [[nodiscard]] std::size_t size() const
+  {
+    const std::lock_guard lock{ mutex_ };
+    return count_;
+  }
+
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  /// @brief Starts the task on the calling thread, it runs until it first suspends, the nursery owns its frame
+  template<typename T> void spawn(task<T> work)
+  {
+    child_owner child = detail::run_in_nursery(std::move(work)).release();
+    const std::coroutine_handle<child_promise> hnd = child.get();
+    hnd.promise().scope = this;
+    {
+      const std::lock_guard lock{ mutex_ };
+      if (head_) { head_.get().promise().prev = &hnd.promise(); }
+      hnd.promise().next = std::move(head_);
+      head_ = std::move(child);
+      ++count_;
+    }
+    hnd.resume();
+  }
+
+  /**
+   * @brief Awaitable, which resumes the awaiting coroutine, once all children have completed, on the thread
+   * completing the last one. Only one coroutine may join at a time.
+   * @throw the first exception thrown by a child since the previous join
+   **/
+  [[nodiscard]] auto join() noexcept
+  {
+    struct awaiter
+    {
+      nursery *scope;
+
+      [[nodiscard]] bool await_ready() const { return scope->empty(); }
+
+      [[nodiscard]] bool await_suspend(std::coroutine_handle<> joiner) const
+      {
+        const std::lock_guard lock{ scope->mutex_ };
+        if (scope->count_ == 0) { return false; }
+        assert(!scope->joiner_ && "only one coroutine may join a nursery at a time");
+        scope->joiner_ = joiner;
+        return true;
+      }
+
+      void await_resume() const
+      {
+        std::exception_ptr except;
+        {
+          const std::lock_guard lock{ scope->mutex_ };
+          except = std::exchange(scope->except_, nullptr);
+        }
+        if (except) { std::rethrow_exception(except); }
+      }
+    };
+    return awaiter{ this };
+  }
+
+private:
+  friend detail::nursery_child::promise_type;
+
+  using child_promise = detail::nursery_child::promise_type;
+  using child_owner = detail::nursery_child::owner;
+
+  // Moves the completed child out of the list into self, returns the joiner, if it was the last one
+  [[nodiscard]] std::coroutine_handle<> remove(child_promise &promise, child_owner &self) noexcept
+  {
+    const std::lock_guard lock{ mutex_ };
+    child_owner &slot = (promise.prev != nullptr) ? promise.prev->next : head_;
+    self = std::move(slot);
+    slot = std::move(promise.next);
+    if (slot) { slot.get().promise().prev = promise.prev; }
+    if (--count_ == 0 && joiner_) { return std::exchange(joiner_, nullptr); }
+    return std::noop_coroutine();
+  }
+
+  void set_exception(std::exception_ptr except) noexcept
+  {
+    const std::lock_guard lock{ mutex_ };
+    if (!except_) { except_ = std::move(except); }
+  }
+
+  mutable std::mutex mutex_;
+  child_owner head_;
+  std::size_t count_{ 0 };
+  std::coroutine_handle<> joiner_;
+  std::exception_ptr except_;
+};
+
+
+inline auto detail::nursery_child::promise_type::final_suspend() noexcept
+{
+  struct awaiter
+  {
+    static constexpr bool await_ready() noexcept { return false; }
+
+    // The frame destroys itself, nothing in it may be touched afterwards
+    [[nodiscard]] static std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> hnd) noexcept
+    {
+      owner self;
+      const std::coroutine_handle<> next = hnd.promise().scope->remove(hnd.promise(), self);
+      self.reset();
+      return next;
+    }
+
+    static constexpr void await_resume() noexcept {}
+  };
+  return awaiter{};
+}
+
+inline void detail::nursery_child::promise_type::unhandled_exception() noexcept
+{ scope->set_exception(std::current_exception()); }
+
+RAII_NS_END
+
+#endif// RAII_NURSERY_HPP
@@ -0,0 +1,344 @@
+// pool_delete and make_pooled for unique_ptr -*- C++ -*-
+
+#ifndef RAII_POOL_DELETE_HPP
+#define RAII_POOL_DELETE_HPP
+
+#include "raii_defs.hpp"
+#include "unique_ptr.hpp"
+
+#include <algorithm>// std::max
+#include <atomic>
+#include <cstddef>// std::size_t, std::byte, std::ptrdiff_t, offsetof
+#include <memory>// std::destroy_at
+#include <new>// std::align_val_t
+#include <type_traits>
+#include <utility>// std::forward
+
+
+RAII_NS_BEGIN
+
+/// @brief Per-thread statistics of the pool of a single type
+struct pool_stats
+{
+  /// @brief Allocations served from the free list
+  std::size_t hits;
+  /// @brief Allocations, which went to the global heap
+  std::size_t misses;
+  /// @brief Blocks freed by other threads and returned via the lock-free path
+  std::size_t remote_frees;
+  /// @brief Free blocks currently cached by the thread
+  std::size_t cached;
+
+  [[nodiscard]] raii_inline constexpr double hit_rate() const noexcept
+  {
+    const std::size_t total = hits + misses;
+    return (total == 0) ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+  }
+};
+
+namespace detail {
+
+  /**
+   * @brief Per-thread pool of fixed-size blocks for objects of type T.
+   *
+   * Every block is prefixed with a pointer to the pool, which allocated it. Frees on the owner thread push the block
+   * onto a plain free list. Frees on other threads push it onto the owner's lock-free remote stack (Treiber stack
+   * with a single consumer, which takes the whole stack at once, so there is no ABA problem), which the owner drains
+   * when its free list runs dry.
+   *
+   * When the owner thread exits, the pool frees its cached blocks and closes the remote stack by swapping in
+   * a sentinel. Blocks still in use elsewhere become orphans: they are returned straight to the heap, and the last
+   * one deletes the pool.
+   **/
+  template<typename T> class object_pool
+  {
+  public:
+    object_pool(const object_pool &) = delete;
+    object_pool &operator=(const object_pool &) = delete;
+    object_pool(object_pool &&) = delete;
+    object_pool &operator=(object_pool &&) = delete;
+
+    /// @brief Returns storage for a single T, never nullptr
+    /// @throw std::bad_alloc
+    [[nodiscard]] raii_inline static void *allocate()
+    {
+      object_pool *pool = current;
+      if (pool == nullptr) [[unlikely]] {
+        // The thread is exiting and its pool has been closed, bypass pooling altogether
+        if (closed) { return heap_allocate(nullptr); }
+        pool = open();
+      }
+      return pool->pop();
+    }
+
+    /// @brief Returns storage obtained from allocate() on any thread
+    raii_inline static void deallocate(void *obj) noexcept
+    {
+      block_header *const header = header_of(obj);
+      object_pool *const owner = header->owner;
+      if (owner == current && owner != nullptr) [[likely]] {
+        owner->push_local(header);
+      } else if (owner == nullptr) {
+        heap_deallocate(header);
+      } else {
+        owner->push_remote(header);
+      }
+    }
+
+    [[nodiscard]] raii_inline static pool_stats stats() noexcept
+    {
+      const object_pool *const pool = current;
+      if (pool == nullptr) { return {}; }
+      return { pool->hits_, pool->misses_, pool->remote_frees_, pool->cached_ };
+    }
+
+    /// @brief Returns cached blocks of the calling thread to the heap
+    raii_inline static void trim() noexcept
+    {
+      object_pool *const pool = current;
+      if (pool == nullptr) { return; }
+      pool->carved_ -= release_list(pool->free_);
+      pool->free_ = nullptr;
+      pool->cached_ = 0;
+    }
+
+  private:
+    struct free_node
+    {
+      free_node *next;
+    };
+
+    struct block_header
+    {
+      object_pool *owner;
+      // Used only while the block is free
+      free_node node;
+    };
+
+    static constexpr std::size_t block_align = std::max(alignof(T), alignof(block_header));
+    // Object storage starts right after the owner pointer, rounded up to the alignment of T
+    static constexpr std::size_t header_size =
+      ((sizeof(object_pool *) + alignof(T) - 1) / alignof(T)) * alignof(T);
+    static constexpr std::size_t block_size =
+      (std::max(header_size + sizeof(T), sizeof(block_header)) + (block_align - 1)) & ~(block_align - 1);
+
+    object_pool() noexcept = default;
+    ~object_pool() noexcept = default;
+
+    // Destroys the pool of the exiting thread
+    struct thread_slot
+    {
+      object_pool *pool{ nullptr };
+
+      thread_slot() noexcept = default;
+      thread_slot(const thread_slot &) = delete;
+      thread_slot &operator=(const thread_slot &) = delete;
+      thread_slot(thread_slot &&) = delete;
+      thread_slot &operator=(thread_slot &&) = delete;
+
+      ~thread_slot() noexcept
+      {
+        if (pool != nullptr) { pool->close(); }
+      }
+    };
+
+    // Trivially destructible fast path, unlike thread_slot it stays accessible during thread exit
+    // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+    static inline thread_local object_pool *current{ nullptr };
+    static inline thread_local bool closed{ false };
+    static inline thread_local thread_slot slot;
+    // Marks the remote stack of a closed pool, only the address is used
+    static inline free_node closed_marker{ nullptr };
+    // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+    [[nodiscard]] static block_header *header_of(void *obj) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+      return reinterpret_cast<block_header *>(static_cast<std::byte *>(obj) - header_size);
+    }
+
+    [[nodiscard]] static void *object_of(block_header *header) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic, cppcoreguidelines-pro-type-reinterpret-cast)
+      return reinterpret_cast<std::byte *>(header) + header_size;
+    }
+
+    [[nodiscard]] static block_header *header_of(free_node *node) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return reinterpret_cast<block_header *>(reinterpret_cast<std::byte *>(node) - offsetof(block_header, node));
+    }
+
+    [[nodiscard]] static void *heap_allocate(object_pool *owner)
+    {
+      auto *const header = static_cast<block_header *>(::operator new(block_size, std::align_val_t{ block_align }));
+      header->owner = owner;
+      return object_of(header);
+    }
+
+    static void heap_deallocate(block_header *header) noexcept
+    { ::operator delete(static_cast<void *>(header), block_size, std::align_val_t{ block_align }); }
+
+    // Frees every block of the list, returns the number of blocks freed
+    static std::size_t release_list(free_node *node) noexcept
+    {
+      std::size_t count = 0;
+      while (node != nullptr) {
+        free_node *const next = node->next;
+        heap_deallocate(header_of(node));
+        node = next;
+        ++count;
+      }
+      return count;
+    }
+
+    [[nodiscard]] static object_pool *open()
+    {
+      auto *const pool = new object_pool;
+      slot.pool = pool;
+      current = pool;
+      return pool;
+    }
+
+    [[nodiscard]] void *pop()
+    {
+      if (free_ == nullptr) [[unlikely]] { drain_remote(); }
+
+      if (free_ != nullptr) [[likely]] {
+        free_node *const node = free_;
+        free_ = node->next;
+        --cached_;
+        ++hits_;
+        return object_of(header_of(node));
+      }
+
+      ++misses_;
+      void *const obj = heap_allocate(this);
+      ++carved_;
+      return obj;
+    }
+
+    void push_local(block_header *header) noexcept
+    {
+      header->node.next = free_;
+      free_ = &header->node;
+      ++cached_;
+    }
+
+    // Takes all blocks freed by other threads at once
+    void drain_remote() noexcept
+    {
+      free_node *node = remote_.exchange(nullptr, std::memory_order_acquire);
+      while (node != nullptr) {
+        free_node *const next = node->next;
+        node->next = free_;
+        free_ = node;
+        node = next;
+        ++cached_;
+        ++remote_frees_;
+      }
+    }
+
+    void push_remote(block_header *header) noexcept
+    {
+      free_node *const node = &header->node;
+      free_node *head = remote_.load(std::memory_order_relaxed);
+      do {
+        if (head == &closed_marker) {
+          // The owner thread has exited, the block is an orphan
+          heap_deallocate(header);
+          if (orphans_.fetch_sub(1, std::memory_order_acq_rel) == 1) { delete this; }
+          return;
+        }
+        node->next = head;
+      } while (!remote_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Called on the owner thread during thread exit
+    void close() noexcept
+    {
+      current = nullptr;
+      closed = true;
+
+      std::size_t freed = release_list(free_);
+      free_ = nullptr;
+      freed += release_list(remote_.exchange(&closed_marker, std::memory_order_acq_rel));
+
+      // Remote frees, which have seen the marker, may already have decremented orphans_ below zero
+      const auto outstanding = static_cast<std::ptrdiff_t>(carved_ - freed);
+      if (orphans_.fetch_add(outstanding, std::memory_order_acq_rel) + outstanding == 0) { delete this; }
+    }
+
+    // Owner thread only
+    free_node *free_{ nullptr };
+    std::size_t carved_{ 0 };
+    std::size_t cached_{ 0 };
+    std::size_t hits_{ 0 };
+    std::size_t misses_{ 0 };
+    std::size_t remote_frees_{ 0 };
+
+    // Shared with other threads, kept on separate cache lines from the owner-only state
+    alignas(64) std::atomic<free_node *> remote_{ nullptr };
+    std::atomic<std::ptrdiff_t> orphans_{ 0 };
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief Destroys an object created by make_pooled and returns its block to the pool of the thread, which
+ * allocated it. Can be invoked on any thread. Stateless, therefore unique_ptr<T, pool_delete<T>> has the size of
+ * a pointer
+ **/
+template<typename T> struct pool_delete
+{
+  constexpr pool_delete() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static void operator()(T *ptr) noexcept
+#else
+  raii_inline void operator()(T *ptr) const noexcept
+#endif
+  {
+    // cppcheck-suppress sizeofVoid;
+    // NOLINTNEXTLINE(bugprone-sizeof-expression)
+    static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type");
+
+    std::destroy_at(ptr);
+    detail::object_pool<T>::deallocate(ptr);
+  }
+};
+
+template<typename T> using pooled_ptr = unique_ptr<T, pool_delete<T>>;
+
+/// @brief Creates an object in a block taken from the calling thread's pool of T
+template<class T, class... Types>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline pooled_ptr<T> make_pooled(Types &&...Args)
+{
+  void *const mem = detail::object_pool<T>::allocate();
+  try {
+    // NOLINTNEXTLINE(clang-diagnostic-missing-field-initializers)
+    return pooled_ptr<T>{ ::new (mem) T{ std::forward<Types>(Args)... } };
+  } catch (...) {
+    detail::object_pool<T>::deallocate(mem);
+    throw;
+  }
+}
+
+template<class T, class... Types>
+  requires std::is_array_v<T>
+void make_pooled(Types &&...) = delete;
+
+/// @brief Returns statistics of the calling thread's pool of T
+template<typename T> [[nodiscard]] raii_inline pool_stats pool_statistics() noexcept
+{ return detail::object_pool<T>::stats(); }
+
+/// @brief Returns free blocks cached by the calling thread's pool of T to the heap
+template<typename T> raii_inline void pool_trim() noexcept { detail::object_pool<T>::trim(); }
+
+RAII_NS_END
+
+#endif// RAII_POOL_DELETE_HPP
@@ -6,4 +6,21 @@
 
 #define raii_inline inline
 
+// MSVC ignores the standard attribute and only honours its own spelling
+#if defined(_MSC_VER) && !defined(__clang__)
+#define RAII_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define RAII_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+// ThreadSanitizer does not support std::atomic_thread_fence, code built with it uses read-modify-write operations
+// instead
+#if defined(__SANITIZE_THREAD__)
+#define RAII_THREAD_SANITIZER 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define RAII_THREAD_SANITIZER 1
+#endif
+#endif
+
 #endif// RAII_DEFS_HPP
\ No newline at end of file
@@ -0,0 +1,188 @@
+// Reading lines and delimited records from owned files without copying them -*- C++ -*-
+
+#ifndef RAII_RECORD_READER_HPP
+#define RAII_RECORD_READER_HPP
+
+#include "aligned_delete.hpp"
+#include "deleter_posix.hpp"
+#include "raii_defs.hpp"
+#include "stdio_fclose.hpp"
+#include "unique_rc.hpp"
+
+#include <sys/types.h>// ssize_t
+#include <unistd.h>// read
+
+#include <algorithm>// std::max
+#include <cerrno>
+#include <cstddef>// std::size_t
+#include <cstdio>// std::fread, std::ferror
+#include <cstring>// std::memchr, std::memcpy, std::memmove
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>// std::move
+
+
+RAII_NS_BEGIN
+
+/**
+ * @brief Splits the contents of an owned file into records ended by a delimiter, e.g. lines.
+ *
+ * Data is read in large blocks into a page aligned buffer and records are returned as std::string_view into it, so
+ * nothing is allocated per record. The delimiter is found with std::memchr, which the C library vectorises.
+ * The buffer is split in two halves: blocks are always read into the second one, and the unfinished record at the end
+ * of a block is moved right in front of it, so records spanning blocks stay contiguous. A record longer than
+ * a block doubles the buffer.
+ * @note The delimiter is not a part of a record, '\r' of CRLF line ends is. The last record of the file does not need
+ * a delimiter
+ * @code
+ * raii::record_reader lines{ raii::unique_fd{ ::open("app.log", O_RDONLY | O_CLOEXEC) } };
+ * while (const auto line = lines.next()) { parse(*line); }
+ * @endcode
+ **/
+class record_reader
+{
+public:
+  static constexpr std::size_t default_block_size = std::size_t{ 1 } << 20;
+
+  /// @brief Alignment of the blocks, which are read, a page, so the kernel copies whole pages
+  static constexpr std::size_t block_alignment = 4096;
+
+  /**
+   * @param file owned descriptor, read with read(2) from its current position
+   * @param delimiter byte, which ends records
+   * @param block_size number of bytes requested by a single read, rounded up to block_alignment
+   **/
+  explicit record_reader(unique_fd file, char delimiter = '\n', std::size_t block_size = default_block_size)
+    : fd_{ std::move(file) }, delimiter_{ delimiter }
+  { allocate(block_size); }
+
+  /// @param file owned stream, read with std::fread, data already buffered by the stream is not lost
+  explicit record_reader(unique_rc<FILE *, stdio_fclose> file,
+    char delimiter = '\n',
+    std::size_t block_size = default_block_size)
+    : stream_{ std::move(file) }, delimiter_{ delimiter }
+  { allocate(block_size); }
+
+  record_reader(const record_reader &) = delete;
+  record_reader &operator=(const record_reader &) = delete;
+
+  /// @note Views returned by the source are still valid, they point to the same buffer
+  record_reader(record_reader &&) noexcept = default;
+  record_reader &operator=(record_reader &&) noexcept = default;
+
+  ~record_reader() = default;
+
+  /**
+   * @brief Returns the next record, std::nullopt at the end of the file
+   * @note The view is valid until the next call of next() or for_each()
+   * @throw std::system_error, if reading fails
+   **/
+  [[nodiscard]] std::optional<std::string_view> next()
+  {
+    // Bytes of the unfinished record, which are already known not to contain the delimiter
+    std::size_t scanned = 0;
+    for (;;) {
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const char *const first = buffer_.get() + begin_;
+      const void *const found = std::memchr(first + scanned, delimiter_, end_ - begin_ - scanned);
+      if (found != nullptr) [[likely]] {
+        const auto len = static_cast<std::size_t>(static_cast<const char *>(found) - first);
+        begin_ += len + 1;
+        return std::string_view{ first, len };
+      }
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      if (eof_) {
+        if (begin_ == end_) { return std::nullopt; }
+        const std::string_view last{ first, end_ - begin_ };
+        begin_ = end_;
+        return last;
+      }
+      scanned = end_ - begin_;
+      refill();
+    }
+  }
+
+  /**
+   * @brief Calls fn(std::string_view) for each of the remaining records
+   * @return number of records
+   * @throw std::system_error, if reading fails, and any exception thrown by fn
+   **/
+  template<typename Fn> std::size_t for_each(Fn fn)
+  {
+    std::size_t count = 0;
+    while (const std::optional<std::string_view> rec = next()) {
+      fn(*rec);
+      ++count;
+    }
+    return count;
+  }
+
+  [[nodiscard]] char delimiter() const noexcept { return delimiter_; }
+
+  /// @brief Number of bytes requested by a single read, records up to this length never grow the buffer
+  [[nodiscard]] std::size_t block_size() const noexcept { return block_size_; }
+
+private:
+  void allocate(std::size_t block_size)
+  {
+    block_size_ = std::max((block_size + block_alignment - 1) & ~(block_alignment - 1), block_alignment);
+    buffer_ = make_unique_aligned_for_overwrite<char[], block_alignment>(2 * block_size_);
+    begin_ = end_ = block_size_;
+  }
+
+  // Moves the unfinished record in front of the second half and reads the next block into the second half
+  void refill()
+  {
+    const std::size_t tail = end_ - begin_;
+    if (tail > block_size_) {
+      // The record does not fit in front of a block, the halves are doubled
+      const std::size_t grown = 2 * block_size_;
+      auto buffer = make_unique_aligned_for_overwrite<char[], block_alignment>(2 * grown);
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      std::memcpy(buffer.get() + grown - tail, buffer_.get() + begin_, tail);
+      buffer_ = std::move(buffer);
+      block_size_ = grown;
+    } else if (begin_ != block_size_ - tail) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      std::memmove(buffer_.get() + block_size_ - tail, buffer_.get() + begin_, tail);
+    }
+    begin_ = block_size_ - tail;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const std::size_t len = read_block(buffer_.get() + block_size_, block_size_);
+    end_ = block_size_ + len;
+    eof_ = (len == 0);
+  }
+
+  [[nodiscard]] std::size_t read_block(char *dst, std::size_t len)
+  {
+    if (stream_) {
+      const std::size_t res = std::fread(dst, 1, len, stream_.get());
+      if (res == 0 && std::ferror(stream_.get()) != 0) {
+        throw std::system_error{ errno, std::system_category(), "fread" };
+      }
+      return res;
+    }
+    for (;;) {
+      const ssize_t res = ::read(fd_.get(), dst, len);
+      if (res >= 0) { return static_cast<std::size_t>(res); }
+      if (errno != EINTR) { throw std::system_error{ errno, std::system_category(), "read" }; }
+    }
+  }
+
+  unique_fd fd_;
+  unique_rc<FILE *, stdio_fclose> stream_;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+  unique_aligned_ptr<char[], block_alignment> buffer_;
+  std::size_t block_size_{ 0 };
+  // Unconsumed data is buffer_[begin_, end_)
+  std::size_t begin_{ 0 };
+  std::size_t end_{ 0 };
+  char delimiter_;
+  bool eof_{ false };
+};
+
+RAII_NS_END
+
+#endif// RAII_RECORD_READER_HPP
@@ -0,0 +1,105 @@
+// Trivial relocation support -*- C++ -*-
+
+#ifndef RAII_RELOCATE_HPP
+#define RAII_RELOCATE_HPP
+
+#include "raii_defs.hpp"
+
+#include <cstddef>// std::size_t
+#include <cstring>// std::memcpy
+#include <memory>// std::construct_at, std::destroy_at
+#include <type_traits>
+#include <utility>// std::move
+
+
+RAII_NS_BEGIN
+
+/**
+ * @brief Tells whether moving an object to a new address and ending the lifetime of the source is equivalent to
+ * copying its bytes. Trivially copyable types qualify, owning wrappers opt in through partial specialisations.
+ * @tparam T type to query, may be specialised by users for their own types
+ **/
+template<typename T> struct is_trivially_relocatable : std::is_trivially_copyable<T>
+{
+};
+
+template<typename T> inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace detail {
+
+  // An owner is bitwise relocatable when its handle and deleter are. A reference deleter is stored as a pointer.
+  template<typename Handle, class Deleter>
+  using owner_is_trivially_relocatable = std::conjunction<is_trivially_relocatable<Handle>,
+    std::disjunction<std::is_lvalue_reference<Deleter>, is_trivially_relocatable<Deleter>>>;
+
+}// namespace detail
+
+
+/// @brief Relocates an object from src into uninitialised storage at dst. After the call the lifetime of *src has
+/// ended and its storage may be reused or freed without running a destructor.
+/// @param src object to relocate
+/// @param dst uninitialised storage for an object of type T
+/// @return dst
+template<typename T>
+  requires(!std::is_const_v<T>)
+raii_inline constexpr T *relocate_at(T *src, T *dst) noexcept(
+  is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+{
+  if constexpr (is_trivially_relocatable_v<T>) {
+    if (!std::is_constant_evaluated()) {
+      std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), sizeof(T));
+      return dst;
+    }
+  }
+
+  std::construct_at(dst, std::move(*src));
+  std::destroy_at(src);
+
+  return dst;
+}
+
+/// @brief Relocates count objects starting at first into uninitialised storage starting at d_first.
+/// Trivially relocatable types are copied with a single memcpy instead of being moved and destroyed one by one.
+/// @param first beginning of the range of objects to relocate
+/// @param count number of objects to relocate
+/// @param d_first beginning of the uninitialised destination storage, must not overlap source range
+/// @return pointer past the last relocated object in the destination
+template<typename T>
+  requires(!std::is_const_v<T>)
+raii_inline constexpr T *uninitialized_relocate_n(T *first, std::size_t count, T *d_first) noexcept(
+  is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+{
+  if constexpr (is_trivially_relocatable_v<T>) {
+    if (!std::is_constant_evaluated()) {
+      if (count != 0) {
+        std::memcpy(static_cast<void *>(d_first), static_cast<const void *>(first), count * sizeof(T));
+      }
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      return d_first + count;
+    }
+  }
+
+  static_assert(std::is_nothrow_move_constructible_v<T> || is_trivially_relocatable_v<T>,
+    "uninitialized_relocate_n requires either trivially relocatable or nothrow move constructible type");
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  for (; count != 0; --count, ++first, ++d_first) { relocate_at(first, d_first); }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+  return d_first;
+}
+
+/// @brief Relocates objects in range [first, last) into uninitialised storage starting at d_first
+/// @param first beginning of the range of objects to relocate
+/// @param last end of the range of objects to relocate
+/// @param d_first beginning of the uninitialised destination storage, must not overlap source range
+/// @return pointer past the last relocated object in the destination
+template<typename T>
+  requires(!std::is_const_v<T>)
+raii_inline constexpr T *uninitialized_relocate(T *first, T *last, T *d_first) noexcept(
+  is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+{ return uninitialized_relocate_n(first, static_cast<std::size_t>(last - first), d_first); }
+
+RAII_NS_END
+
+#endif// RAII_RELOCATE_HPP
@@ -0,0 +1,186 @@
+// tagged_pointer handle adapter for unique_rc -*- C++ -*-
+
+#ifndef RAII_TAGGED_POINTER_HPP
+#define RAII_TAGGED_POINTER_HPP
+
+#include "raii_defs.hpp"
+#include "unique_ptr.hpp"
+#include "unique_rc.hpp"
+
+#include <bit>// std::countr_zero
+#include <cassert>
+#include <cstddef>// std::nullptr_t
+#include <cstdint>// std::uintptr_t
+#include <functional>// std::hash
+#include <type_traits>
+
+
+RAII_NS_BEGIN
+
+/// @brief Number of low bits, which are always zero in a pointer to a suitably aligned T
+template<typename T> inline constexpr unsigned alignment_tag_bits = static_cast<unsigned>(std::countr_zero(alignof(T)));
+
+/**
+ * @brief Pointer to T, which stores a small tag in the low bits that are guaranteed to be zero by alignment of T
+ * @tparam T type of the pointee
+ * @tparam TagBits number of low bits used by the tag, cannot exceed alignment_tag_bits<T>
+ * @note Only alignment bits are used, because availability of the high bits depends on the CPU and the OS
+ * (x86-64 LAM, AArch64 TBI, 5-level paging)
+ **/
+template<typename T, unsigned TagBits = alignment_tag_bits<T>> class tagged_pointer
+{
+  static_assert(TagBits > 0, "tagged_pointer requires at least one tag bit");
+  static_assert(TagBits <= alignment_tag_bits<T>, "tagged_pointer tag bits exceed alignment of the pointee");
+
+public:
+  using element_type = T;
+  using pointer = T *;
+  using tag_type = std::uintptr_t;
+
+  static constexpr unsigned tag_bits = TagBits;
+  static constexpr tag_type tag_mask = (tag_type{ 1 } << TagBits) - 1;
+
+  constexpr tagged_pointer() noexcept = default;
+
+  // cppcheck-suppress noExplicitConstructor; nullptr is a valid empty handle
+  // NOLINTNEXTLINE(hicpp-explicit-conversions)
+  raii_inline constexpr tagged_pointer(std::nullptr_t) noexcept {}
+
+  /// @brief Packs ptr and tag into a single word
+  /// @param ptr pointer to an object of T, must be aligned at least to alignof(T)
+  /// @param tag user metadata, must fit into TagBits
+  raii_inline explicit tagged_pointer(pointer ptr, tag_type tag = 0) noexcept
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    : bits_{ reinterpret_cast<tag_type>(ptr) | tag }
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    assert((reinterpret_cast<tag_type>(ptr) & tag_mask) == 0 && "Pointer is not aligned to alignof(T)");
+    assert((tag & ~tag_mask) == 0 && "Tag does not fit into tag bits");
+  }
+
+  /// @brief Returns stored pointer with the tag stripped
+  [[nodiscard]] raii_inline pointer get() const noexcept
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+    return reinterpret_cast<pointer>(bits_ & ~tag_mask);
+  }
+
+  [[nodiscard]] raii_inline constexpr tag_type tag() const noexcept { return bits_ & tag_mask; }
+
+  /// @brief Returns copy of *this pointing to the same object with the tag replaced
+  [[nodiscard]] raii_inline constexpr tagged_pointer with_tag(tag_type tag) const noexcept
+  {
+    assert((tag & ~tag_mask) == 0 && "Tag does not fit into tag bits");
+
+    tagged_pointer res;
+    res.bits_ = (bits_ & ~tag_mask) | tag;
+    return res;
+  }
+
+  /// @brief Checks whether the pointer part is not null, the tag is ignored
+  [[nodiscard]] raii_inline constexpr bool has_pointer() const noexcept { return (bits_ & ~tag_mask) != 0; }
+
+  [[nodiscard]] raii_inline constexpr explicit operator bool() const noexcept { return has_pointer(); }
+
+  [[nodiscard]] raii_inline pointer operator->() const noexcept { return get(); }
+
+  [[nodiscard]] raii_inline std::add_lvalue_reference_t<T> operator*() const noexcept { return *get(); }
+
+  /// @brief Raw word holding both the pointer and the tag
+  [[nodiscard]] raii_inline constexpr tag_type bits() const noexcept { return bits_; }
+
+  [[nodiscard]] friend raii_inline constexpr bool operator==(tagged_pointer lhs, tagged_pointer rhs) noexcept
+  { return lhs.bits_ == rhs.bits_; }
+
+  [[nodiscard]] friend raii_inline constexpr bool operator==(tagged_pointer lhs, std::nullptr_t) noexcept
+  { return !lhs.has_pointer(); }
+
+  friend raii_inline constexpr void swap(tagged_pointer &lhs, tagged_pointer &rhs) noexcept
+  { std::ranges::swap(lhs.bits_, rhs.bits_); }
+
+private:
+  tag_type bits_{};
+};
+
+
+/**
+ * @brief Use with tagged_pointer handle, a resource is owned whenever the pointer part is not null,
+ * regardless of the tag
+ * @tparam Handle tagged_pointer
+ * @tparam Invalid invalid handle type, same as Handle
+ **/
+template<typename Handle, typename Invalid> struct tagged_pointer_invalid_handle_policy
+{
+  using invalid_type = Invalid;
+
+  [[nodiscard]] raii_inline static constexpr invalid_type invalid() noexcept { return {}; }
+
+  [[nodiscard]] raii_inline static constexpr bool is_owned(Handle hnd) noexcept { return hnd.has_pointer(); }
+
+
+  /// @brief Disabled because policy provides only typedefs and static methods
+  constexpr tagged_pointer_invalid_handle_policy() = delete;
+  constexpr ~tagged_pointer_invalid_handle_policy() = delete;
+
+  constexpr tagged_pointer_invalid_handle_policy(const tagged_pointer_invalid_handle_policy &) = delete;
+  constexpr tagged_pointer_invalid_handle_policy &operator=(const tagged_pointer_invalid_handle_policy &) = delete;
+
+  constexpr tagged_pointer_invalid_handle_policy(tagged_pointer_invalid_handle_policy &&) = delete;
+  constexpr tagged_pointer_invalid_handle_policy &operator=(tagged_pointer_invalid_handle_policy &&) = delete;
+};
+
+
+/**
+ * @brief Adapts a pointer deleter to tagged_pointer handle, the tag is stripped before the pointer is deleted
+ * @tparam TaggedPointer tagged_pointer type
+ * @tparam Deleter stateless pointer deleter, e.g. raii::default_delete<T>
+ **/
+template<typename TaggedPointer, class Deleter>
+  requires std::is_empty_v<Deleter>
+struct tagged_delete : private Deleter
+{
+  using handle = TaggedPointer;
+
+  /// @brief Invalid tagged pointer is stripped to nullptr
+  static constexpr bool accepts_invalid_handle = accepts_invalid_handle_v<Deleter>;
+
+  constexpr tagged_delete() noexcept = default;
+
+  raii_inline void operator()(handle hnd) const noexcept { static_cast<const Deleter &>(*this)(hnd.get()); }
+};
+
+
+/**
+ * @brief Owning tagged pointer, has the size of T*, e.g. `unique_tagged_ptr<Connection, 3>` owns a connection and
+ * keeps three bits of state alongside it
+ * @tparam T the type of the object managed
+ * @tparam TagBits number of low bits used by the tag
+ * @tparam Deleter stateless pointer deleter
+ **/
+template<typename T, unsigned TagBits = alignment_tag_bits<T>, class Deleter = default_delete<T>>
+using unique_tagged_ptr = unique_rc<tagged_pointer<T, TagBits>,
+  tagged_delete<tagged_pointer<T, TagBits>, Deleter>,
+  resolve_handle_type,
+  tagged_pointer<T, TagBits>,
+  tagged_pointer_invalid_handle_policy>;
+
+/// @brief Replaces the tag of an owned (or empty) tagged pointer without touching the owned object
+template<typename T, unsigned TagBits, class Deleter>
+raii_inline void set_tag(unique_tagged_ptr<T, TagBits, Deleter> &owner,
+  typename tagged_pointer<T, TagBits>::tag_type tag) noexcept
+{
+  // The released handle is no longer owned, therefore reset doesn't invoke the deleter
+  owner.reset(owner.release().with_tag(tag));
+}
+
+RAII_NS_END
+
+
+/// @brief std::hash specialization for raii::tagged_pointer, hashes both pointer and tag
+template<typename T, unsigned TagBits> struct std::hash<raii::tagged_pointer<T, TagBits>>
+{
+  raii_inline std::size_t operator()(raii::tagged_pointer<T, TagBits> ptr) const noexcept
+  { return std::hash<std::uintptr_t>{}(ptr.bits()); }
+};
+
+#endif// RAII_TAGGED_POINTER_HPP
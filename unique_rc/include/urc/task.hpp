@@ -0,0 +1,420 @@
+// Lazily started task coroutine and sync_wait -*- C++ -*-
+
+#ifndef RAII_TASK_HPP
+#define RAII_TASK_HPP
+
+#include "frame_allocator.hpp"
+#include "raii_defs.hpp"
+#include "unique_coroutine_handle.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>// std::size_t
+#include <cstdint>// std::uint8_t
+#include <exception>// std::exception_ptr, std::current_exception, std::rethrow_exception, std::terminate
+#include <memory>// std::addressof
+#include <mutex>
+#include <type_traits>
+#include <utility>// std::move, std::forward
+#include <variant>
+
+
+RAII_NS_BEGIN
+
+template<typename T = void> class task;
+
+namespace detail {
+
+  /// @brief Holds either nothing, a value or an exception of a finished coroutine
+  template<typename T> class task_result
+  {
+  public:
+    template<typename U> void set_value(U &&val) noexcept(std::is_nothrow_constructible_v<T, U &&>)
+    { result_.template emplace<1>(std::forward<U>(val)); }
+
+    void set_exception(std::exception_ptr except) noexcept { result_.template emplace<2>(std::move(except)); }
+
+    [[nodiscard]] T &get() &
+    {
+      rethrow_if_exception();
+      return std::get<1>(result_);
+    }
+
+    [[nodiscard]] T &&get() &&
+    {
+      rethrow_if_exception();
+      return std::move(std::get<1>(result_));
+    }
+
+  private:
+    void rethrow_if_exception()
+    {
+      if (result_.index() == 2) { std::rethrow_exception(std::get<2>(result_)); }
+    }
+
+    std::variant<std::monostate, T, std::exception_ptr> result_;
+  };
+
+  template<typename T> class task_result<T &>
+  {
+  public:
+    void set_value(T &val) noexcept { result_ = std::addressof(val); }
+
+    void set_exception(std::exception_ptr except) noexcept { except_ = std::move(except); }
+
+    [[nodiscard]] T &get() const
+    {
+      if (except_) { std::rethrow_exception(except_); }
+      return *result_;
+    }
+
+  private:
+    T *result_{ nullptr };
+    std::exception_ptr except_;
+  };
+
+  template<> class task_result<void>
+  {
+  public:
+    void set_exception(std::exception_ptr except) noexcept { except_ = std::move(except); }
+
+    void get() const
+    {
+      if (except_) { std::rethrow_exception(except_); }
+    }
+
+  private:
+    std::exception_ptr except_;
+  };
+
+  /// @brief Combinator, which runs several tasks at once and is told about their completion, see when_all.hpp
+  class task_group
+  {
+  public:
+    task_group(const task_group &) = delete;
+    task_group &operator=(const task_group &) = delete;
+    task_group(task_group &&) = delete;
+    task_group &operator=(task_group &&) = delete;
+
+    /// @brief Called by the final suspend point of a child, which still belongs to the group
+    /// @return coroutine to resume next
+    [[nodiscard]] virtual std::coroutine_handle<> child_done(std::size_t index) noexcept = 0;
+
+  protected:
+    task_group() = default;
+    ~task_group() = default;
+  };
+
+  /**
+   * @brief Membership of a task in a task_group.
+   *
+   * A group may detach a running child, the child then destroys its own frame, when it completes, and never
+   * touches the group again, which may be gone by then.
+   **/
+  class task_group_link
+  {
+  public:
+    enum state : std::uint8_t
+    {
+      not_started,
+      running,
+      finished,
+      detached
+    };
+
+    void join(task_group &group, std::size_t index) noexcept
+    {
+      group_ = &group;
+      index_ = index;
+    }
+
+    [[nodiscard]] bool in_group() const noexcept { return group_ != nullptr; }
+
+    /// @brief Returns false, if the group has detached the child, before it was started
+    [[nodiscard]] bool start() noexcept
+    {
+      std::uint8_t expected = not_started;
+      return state_.compare_exchange_strong(expected, running, std::memory_order_acq_rel);
+    }
+
+    /// @brief Returns the state of the child, before it was detached
+    [[nodiscard]] state detach() noexcept
+    { return static_cast<state>(state_.exchange(detached, std::memory_order_acq_rel)); }
+
+    [[nodiscard]] std::coroutine_handle<> finish(std::coroutine_handle<> self) noexcept
+    {
+      if (state_.exchange(finished, std::memory_order_acq_rel) == detached) {
+        self.destroy();
+        return std::noop_coroutine();
+      }
+      return group_->child_done(index_);
+    }
+
+  private:
+    task_group *group_{ nullptr };
+    std::size_t index_{ 0 };
+    std::atomic<std::uint8_t> state_{ not_started };
+  };
+
+  /**
+   * @brief Promise of a lazily started coroutine, which resumes its awaiter when it completes.
+   *
+   * The awaiter is resumed by symmetric transfer from final_suspend, so chains of nested co_await expressions of any
+   * depth run in constant stack space and never go through a scheduler.
+   **/
+  template<typename T> class task_promise_base
+    : public pooled_frame_promise
+    , public task_result<T>
+  {
+  public:
+    static std::suspend_always initial_suspend() noexcept { return {}; }
+
+    [[nodiscard]] static auto final_suspend() noexcept { return final_awaiter{}; }
+
+    void unhandled_exception() noexcept { this->set_exception(std::current_exception()); }
+
+    void set_continuation(std::coroutine_handle<> continuation) noexcept { continuation_ = continuation; }
+
+    [[nodiscard]] task_group_link &group_link() noexcept { return link_; }
+
+  private:
+    struct final_awaiter
+    {
+      static constexpr bool await_ready() noexcept { return false; }
+
+      template<typename Promise>
+      [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> hnd) noexcept
+      {
+        task_promise_base &promise = hnd.promise();
+        if (promise.link_.in_group()) { return promise.link_.finish(hnd); }
+        return promise.continuation_;
+      }
+
+      static constexpr void await_resume() noexcept {}
+    };
+
+    std::coroutine_handle<> continuation_{ std::noop_coroutine() };
+    task_group_link link_;
+  };
+
+  template<typename T> class task_promise : public task_promise_base<T>
+  {
+  public:
+    template<typename U = T>
+      requires std::is_convertible_v<U &&, T>
+    void return_value(U &&val) noexcept(std::is_nothrow_constructible_v<T, U &&>)
+    { this->set_value(std::forward<U>(val)); }
+  };
+
+  template<> class task_promise<void> : public task_promise_base<void>
+  {
+  public:
+    static constexpr void return_void() noexcept {}
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief raii::task is a lazily started coroutine producing a single value of type T. The task starts, when it is
+ * awaited, and resumes its awaiter by symmetric transfer, when it completes.
+ *
+ * The frame is owned by raii::unique_coroutine_handle, so a task, which is dropped before or after it has run, always
+ * destroys its frame exactly once. Frames are allocated from per-thread frame pools, see raii::pooled_frame_promise.
+ * @code
+ * raii::task<int> answer() { co_return 42; }
+ * raii::task<> print() { std::println("{}", co_await answer()); }
+ * raii::sync_wait(print());
+ * @endcode
+ * @note GCC compiles the symmetric transfer into a tail call only with optimisations enabled, unoptimised builds still
+ * use stack proportional to the depth of nested co_await expressions
+ **/
+template<typename T> class task
+{
+public:
+  using value_type = T;
+
+  struct promise_type : detail::task_promise<T>
+  {
+    task get_return_object() noexcept { return task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+private:
+  struct awaiter_base
+  {
+    handle coro;
+
+    [[nodiscard]] bool await_ready() const noexcept { return coro.done(); }
+
+    [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+      coro.promise().set_continuation(awaiting);
+      return coro;
+    }
+  };
+
+public:
+  task() noexcept = default;
+
+  task(task &&) noexcept = default;
+  task &operator=(task &&) noexcept = default;
+
+  task(const task &) = delete;
+  task &operator=(const task &) = delete;
+
+  ~task() = default;
+
+  [[nodiscard]] explicit operator bool() const noexcept { return static_cast<bool>(coro_); }
+
+  /// @brief Returns true, once the task has run to completion
+  [[nodiscard]] bool done() const noexcept { return coro_.get().done(); }
+
+  /// @brief Returns the coroutine handle, the task keeps the ownership
+  [[nodiscard]] handle get() const noexcept { return coro_.get(); }
+
+  /// @brief Starts the task and suspends the awaiter until it completes, returns a reference to the result
+  [[nodiscard]] auto operator co_await() & noexcept
+  {
+    assert(coro_ && "awaiting an empty task");
+
+    struct awaiter : awaiter_base
+    {
+      decltype(auto) await_resume() { return this->coro.promise().get(); }
+    };
+    return awaiter{ { coro_.get() } };
+  }
+
+  /// @brief Starts the task and suspends the awaiter until it completes, returns the result by value
+  [[nodiscard]] auto operator co_await() && noexcept
+  {
+    assert(coro_ && "awaiting an empty task");
+
+    struct awaiter : awaiter_base
+    {
+      decltype(auto) await_resume() { return std::move(this->coro.promise()).get(); }
+    };
+    return awaiter{ { coro_.get() } };
+  }
+
+  /// @brief Gives up ownership of the coroutine frame, e.g. to hand it over to a scheduler
+  [[nodiscard]] unique_coroutine_handle<promise_type> release() && noexcept { return std::move(coro_); }
+
+private:
+  explicit task(handle coro) noexcept : coro_{ coro } {}
+
+  unique_coroutine_handle<promise_type> coro_;
+};
+
+
+namespace detail {
+
+  // Signalled by the driver, once the awaited task is done. It lives on the stack of sync_wait, not in the frame,
+  // and the notification is sent under the lock, so the waiter cannot return and destroy it before set() is done
+  class sync_wait_event
+  {
+  public:
+    void set() noexcept
+    {
+      const std::lock_guard lock{ mutex_ };
+      set_ = true;
+      cond_.notify_one();
+    }
+
+    void wait() noexcept
+    {
+      std::unique_lock lock{ mutex_ };
+      cond_.wait(lock, [this] { return set_; });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    bool set_ = false;
+  };
+
+  // Coroutine, which awaits a task on behalf of sync_wait and signals the waiting thread, when it is done
+  class sync_wait_driver
+  {
+  public:
+    struct promise_type : pooled_frame_promise
+    {
+      sync_wait_event *event = nullptr;
+
+      sync_wait_driver get_return_object() noexcept
+      { return sync_wait_driver{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+
+      static std::suspend_always initial_suspend() noexcept { return {}; }
+
+      [[nodiscard]] static auto final_suspend() noexcept
+      {
+        struct signal
+        {
+          static constexpr bool await_ready() noexcept { return false; }
+
+          // The waiting thread destroys the frame as soon as it wakes up, so the frame is not touched after set()
+          static void await_suspend(std::coroutine_handle<promise_type> hnd) noexcept { hnd.promise().event->set(); }
+
+          static constexpr void await_resume() noexcept {}
+        };
+        return signal{};
+      }
+
+      static constexpr void return_void() noexcept {}
+
+      // Exceptions of the awaited task are caught by the driver itself
+      [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    void run_and_wait() noexcept
+    {
+      sync_wait_event event;
+      coro_.get().promise().event = &event;
+      coro_.get().resume();
+      event.wait();
+    }
+
+  private:
+    explicit sync_wait_driver(std::coroutine_handle<promise_type> coro) noexcept : coro_{ coro } {}
+
+    unique_coroutine_handle<promise_type> coro_;
+  };
+
+  template<typename T> sync_wait_driver make_sync_wait_driver(task<T> &awaited, task_result<T> &result)
+  {
+    try {
+      if constexpr (std::is_void_v<T>) {
+        co_await std::move(awaited);
+      } else {
+        result.set_value(co_await std::move(awaited));
+      }
+    } catch (...) {
+      result.set_exception(std::current_exception());
+    }
+  }
+
+}// namespace detail
+
+
+/**
+ * @brief Runs a task to completion and returns its result, blocking the calling thread while the task is suspended,
+ * e.g. until a thread pool resumes it.
+ * @throw any exception thrown by the task
+ **/
+template<typename T> raii_inline T sync_wait(task<T> awaited)
+{
+  detail::task_result<T> result;
+  detail::make_sync_wait_driver(awaited, result).run_and_wait();
+  if constexpr (std::is_void_v<T>) {
+    result.get();
+  } else {
+    return std::move(result).get();
+  }
+}
+
+RAII_NS_END
+
+#endif// RAII_TASK_HPP
@@ -0,0 +1,492 @@
+// Work-stealing thread pool for coroutines -*- C++ -*-
+
+#ifndef RAII_THREAD_POOL_HPP
+#define RAII_THREAD_POOL_HPP
+
+#include "frame_allocator.hpp"
+#include "raii_defs.hpp"
+#include "task.hpp"
+#include "unique_coroutine_handle.hpp"
+
+#include <algorithm>// std::max
+#include <atomic>
+#include <coroutine>
+#include <cstddef>// std::size_t
+#include <cstdint>// std::int64_t, std::uint32_t, std::uintptr_t
+#include <exception>// std::terminate
+#include <memory>// std::unique_ptr, std::make_unique
+#include <mutex>
+#include <thread>
+#include <utility>// std::move, std::exchange
+#include <vector>
+
+
+RAII_NS_BEGIN
+
+namespace detail {
+
+  /**
+   * @brief Coroutine queued on a thread pool, a single word, which fits into a slot of the work-stealing deque.
+   *
+   * Owned items are coroutines spawned onto the pool and not started yet, the queue is responsible for their frames.
+   * Borrowed items are coroutines suspended in `co_await pool.schedule()`, their frames belong to whoever awaits them.
+   * The ownership is kept in the lowest bit of the frame address, which is always zero, since every frame stores
+   * the resume and destroy function pointers.
+   **/
+  class work_item
+  {
+  public:
+    constexpr work_item() noexcept = default;
+
+    [[nodiscard]] static work_item borrowed(std::coroutine_handle<> hnd) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return work_item{ reinterpret_cast<std::uintptr_t>(hnd.address()) };
+    }
+
+    template<typename Promise> [[nodiscard]] static work_item owned(unique_coroutine_handle<Promise> hnd) noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return work_item{ reinterpret_cast<std::uintptr_t>(hnd.release().address()) | owned_bit };
+    }
+
+    [[nodiscard]] static constexpr work_item from_bits(std::uintptr_t bits) noexcept { return work_item{ bits }; }
+
+    [[nodiscard]] constexpr std::uintptr_t bits() const noexcept { return bits_; }
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept { return bits_ != 0; }
+
+    [[nodiscard]] constexpr bool is_owned() const noexcept { return (bits_ & owned_bit) != 0; }
+
+    /// @brief Resumes the coroutine, an owned coroutine becomes responsible for its own frame
+    void run() const { handle().resume(); }
+
+    /// @brief Drops the item during shutdown, owned frames are destroyed, borrowed ones resumed
+    void discard() const
+    {
+      if (is_owned()) {
+        handle().destroy();
+      } else {
+        handle().resume();
+      }
+    }
+
+  private:
+    static constexpr std::uintptr_t owned_bit = 1;
+
+    constexpr explicit work_item(std::uintptr_t bits) noexcept : bits_{ bits } {}
+
+    [[nodiscard]] std::coroutine_handle<> handle() const noexcept
+    {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+      return std::coroutine_handle<>::from_address(reinterpret_cast<void *>(bits_ & ~owned_bit));
+    }
+
+    std::uintptr_t bits_{ 0 };
+  };
+
+  /**
+   * @brief Chase-Lev work-stealing deque of work items.
+   *
+   * The owner thread pushes and takes at the bottom, other threads steal at the top. The ring buffer grows on
+   * demand, replaced buffers are kept until the deque is destroyed, since a concurrent thief may still read them.
+   * Memory orderings follow Le, Pop, Cohen, Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory
+   * Models", PPoPP 2013, with the fences folded into sequentially consistent accesses.
+   **/
+  class work_stealing_deque
+  {
+  public:
+    static constexpr std::int64_t initial_capacity = 256;
+
+    work_stealing_deque() : ring_{ new ring{ initial_capacity, nullptr } } {}
+
+    work_stealing_deque(const work_stealing_deque &) = delete;
+    work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+    work_stealing_deque(work_stealing_deque &&) = delete;
+    work_stealing_deque &operator=(work_stealing_deque &&) = delete;
+
+    ~work_stealing_deque()
+    {
+      ring *cur = ring_.load(std::memory_order_relaxed);
+      while (cur != nullptr) { delete std::exchange(cur, cur->retired); }
+    }
+
+    /// @brief Owner thread only
+    void push(work_item item)
+    {
+      const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+      const std::int64_t top = top_.load(std::memory_order_acquire);
+      ring *cur = ring_.load(std::memory_order_relaxed);
+      if (bottom - top >= cur->capacity) [[unlikely]] {
+        cur = cur->grow(bottom, top);
+        ring_.store(cur, std::memory_order_release);
+      }
+      cur->put(bottom, item);
+      bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    /// @brief Owner thread only, returns the most recently pushed item or an empty one
+    [[nodiscard]] work_item take() noexcept
+    {
+      const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+      const ring *cur = ring_.load(std::memory_order_relaxed);
+      bottom_.store(bottom, std::memory_order_seq_cst);
+      std::int64_t top = top_.load(std::memory_order_seq_cst);
+
+      if (top > bottom) {
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return {};
+      }
+
+      work_item item = cur->get(bottom);
+      if (top == bottom) {
+        // The last item, race against thieves
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+          item = {};
+        }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+      }
+      return item;
+    }
+
+    /// @brief Any thread, returns the least recently pushed item or an empty one, if the deque is empty or another
+    /// thread has won the race
+    [[nodiscard]] work_item steal() noexcept
+    {
+      std::int64_t top = top_.load(std::memory_order_seq_cst);
+      const std::int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+      if (top >= bottom) { return {}; }
+
+      const work_item item = ring_.load(std::memory_order_acquire)->get(top);
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return {};
+      }
+      return item;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    { return top_.load(std::memory_order_seq_cst) >= bottom_.load(std::memory_order_seq_cst); }
+
+  private:
+    struct ring
+    {
+      ring(std::int64_t size, ring *prev)
+        : capacity{ size }, mask{ size - 1 },
+          slots{ std::make_unique<std::atomic<std::uintptr_t>[]>(static_cast<std::size_t>(size)) }, retired{ prev }
+      {}
+
+      [[nodiscard]] work_item get(std::int64_t index) const noexcept
+      { return work_item::from_bits(slots[static_cast<std::size_t>(index & mask)].load(std::memory_order_relaxed)); }
+
+      void put(std::int64_t index, work_item item) noexcept
+      { slots[static_cast<std::size_t>(index & mask)].store(item.bits(), std::memory_order_relaxed); }
+
+      [[nodiscard]] ring *grow(std::int64_t bottom, std::int64_t top)
+      {
+        auto *const bigger = new ring{ capacity * 2, this };
+        for (std::int64_t i = top; i != bottom; ++i) { bigger->put(i, get(i)); }
+        return bigger;
+      }
+
+      std::int64_t capacity;
+      std::int64_t mask;
+      std::unique_ptr<std::atomic<std::uintptr_t>[]> slots;
+      ring *retired;
+    };
+
+    alignas(64) std::atomic<std::int64_t> top_{ 0 };
+    alignas(64) std::atomic<std::int64_t> bottom_{ 0 };
+    std::atomic<ring *> ring_;
+  };
+
+  // Runs a spawned task, the frame destroys itself, when the task completes
+  class detached_task
+  {
+  public:
+    struct promise_type : pooled_frame_promise
+    {
+      detached_task get_return_object() noexcept
+      { return detached_task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+
+      static std::suspend_always initial_suspend() noexcept { return {}; }
+      static std::suspend_never final_suspend() noexcept { return {}; }
+      static constexpr void return_void() noexcept {}
+
+      // Nobody is there to observe the exception of a detached task, the same as for std::thread
+      [[noreturn]] static void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    [[nodiscard]] unique_coroutine_handle<promise_type> release() && noexcept { return std::move(coro_); }
+
+  private:
+    explicit detached_task(std::coroutine_handle<promise_type> coro) noexcept : coro_{ coro } {}
+
+    unique_coroutine_handle<promise_type> coro_;
+  };
+
+  template<typename T> detached_task run_detached(task<T> work) { static_cast<void>(co_await std::move(work)); }
+
+}// namespace detail
+
+
+/**
+ * @brief Runs coroutines on a fixed set of worker threads.
+ *
+ * Every worker owns a Chase-Lev deque: work created on a worker goes to its own deque, idle workers steal from the
+ * others. Work submitted from threads outside of the pool goes to a small mutex-protected inbox of one worker, there
+ * is no queue or lock shared by all workers. Idle workers sleep on an atomic wait.
+ *
+ * The destructor stops the pool and joins the workers. Coroutines spawned, but not yet started are destroyed without
+ * running, coroutines suspended in schedule() are resumed, so every frame is destroyed exactly once.
+ * @code
+ * raii::thread_pool pool;
+ * raii::task<int> work(raii::thread_pool &pool) { co_await pool.schedule(); co_return compute(); }
+ * int res = raii::sync_wait(work(pool));
+ * pool.spawn(fire_and_forget());
+ * @endcode
+ **/
+class thread_pool
+{
+public:
+  /// @param thread_count number of worker threads, at least one
+  explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency())
+  {
+    const std::size_t count = std::max<std::size_t>(thread_count, 1);
+    workers_.reserve(count);
+    for (std::size_t i = 0; i != count; ++i) {
+      workers_.push_back(std::make_unique<worker>());
+      workers_.back()->pool = this;
+    }
+    try {
+      for (auto &wrk : workers_) {
+        wrk->thread = std::thread{ [this, self = wrk.get()] { run(*self); } };
+      }
+    } catch (...) {
+      // e.g. EAGAIN under a limit of processes, the threads already started have to be joined before workers_ goes
+      shutdown();
+      throw;
+    }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  thread_pool(thread_pool &&) = delete;
+  thread_pool &operator=(thread_pool &&) = delete;
+
+  ~thread_pool() { shutdown(); }
+
+  [[nodiscard]] std::size_t thread_count() const noexcept { return workers_.size(); }
+
+  /// @brief Returns true, once the destructor has started
+  [[nodiscard]] bool stop_requested() const noexcept { return stop_.load(std::memory_order_acquire); }
+
+  /// @brief Awaitable, which resumes the awaiting coroutine on one of the worker threads
+  [[nodiscard]] auto schedule() noexcept
+  {
+    struct awaiter
+    {
+      thread_pool *pool;
+
+      static constexpr bool await_ready() noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<> hnd) const { pool->submit(detail::work_item::borrowed(hnd)); }
+
+      static constexpr void await_resume() noexcept {}
+    };
+    return awaiter{ this };
+  }
+
+  /// @brief Runs the task on the pool, the pool owns its frame until it starts, the result is discarded
+  /// @note std::terminate is called, if the task exits with an exception
+  template<typename T> void spawn(task<T> work)
+  { submit(detail::work_item::owned(detail::run_detached(std::move(work)).release())); }
+
+private:
+  // Stops and joins the workers, which have been started
+  void shutdown() noexcept
+  {
+    stop_.store(true, std::memory_order_seq_cst);
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    epoch_.notify_all();
+    for (auto &wrk : workers_) {
+      if (wrk->thread.joinable()) { wrk->thread.join(); }
+    }
+
+    // Work submitted from outside, while the workers were exiting
+    while (const detail::work_item item = find_any()) { item.discard(); }
+  }
+
+  struct alignas(64) worker
+  {
+    detail::work_stealing_deque deque;
+
+    std::mutex inbox_mutex;
+    std::vector<detail::work_item> inbox;
+    std::atomic<bool> inbox_ready{ false };
+
+    const thread_pool *pool{ nullptr };
+    std::thread thread;
+  };
+
+  // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+  static inline thread_local worker *current{ nullptr };
+  static inline thread_local std::uint32_t random_state{ 0 };
+  // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+  [[nodiscard]] static std::uint32_t next_random() noexcept
+  {
+    // xorshift32, seeded from the address of the thread-local state, which differs between threads
+    std::uint32_t val = random_state;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (val == 0) { val = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&random_state) >> 4U) | 1U; }
+    val ^= val << 13U;
+    val ^= val >> 17U;
+    val ^= val << 5U;
+    random_state = val;
+    return val;
+  }
+
+  void submit(detail::work_item item)
+  {
+    worker *const self = current;
+    if (self != nullptr && self->pool == this) [[likely]] {
+      self->deque.push(item);
+    } else {
+      worker &target = *workers_[next_random() % workers_.size()];
+      {
+        const std::lock_guard lock{ target.inbox_mutex };
+        target.inbox.push_back(item);
+      }
+      target.inbox_ready.store(true, std::memory_order_release);
+    }
+    wake_one();
+  }
+
+  void wake_one() noexcept
+  {
+    // Pairs with the sleepers_ increment in idle(), either the sleeper sees the new work or it is woken up here.
+    // A fence keeps the common case free of writes to the shared counter
+#ifdef RAII_THREAD_SANITIZER
+    if (sleepers_.fetch_add(0, std::memory_order_seq_cst) != 0) {
+#else
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) != 0) {
+#endif
+      epoch_.fetch_add(1, std::memory_order_seq_cst);
+      epoch_.notify_one();
+    }
+  }
+
+  // Moves the inbox to the deque in reverse, so that the oldest submission is taken first
+  static bool drain_inbox(worker &self)
+  {
+    if (!self.inbox_ready.load(std::memory_order_acquire)) { return false; }
+
+    std::vector<detail::work_item> items;
+    {
+      const std::lock_guard lock{ self.inbox_mutex };
+      items.swap(self.inbox);
+      self.inbox_ready.store(false, std::memory_order_relaxed);
+    }
+    for (auto it = items.rbegin(); it != items.rend(); ++it) { self.deque.push(*it); }
+    return !items.empty();
+  }
+
+  // Takes a single item from the inbox of another worker, which may be busy with a long running coroutine
+  [[nodiscard]] static detail::work_item steal_inbox(worker &victim)
+  {
+    if (!victim.inbox_ready.load(std::memory_order_acquire)) { return {}; }
+
+    const std::unique_lock lock{ victim.inbox_mutex, std::try_to_lock };
+    if (!lock || victim.inbox.empty()) { return {}; }
+    const detail::work_item item = victim.inbox.front();
+    victim.inbox.erase(victim.inbox.begin());
+    victim.inbox_ready.store(!victim.inbox.empty(), std::memory_order_relaxed);
+    return item;
+  }
+
+  [[nodiscard]] detail::work_item find_work(worker &self)
+  {
+    if (const detail::work_item item = self.deque.take()) { return item; }
+    if (drain_inbox(self)) {
+      if (const detail::work_item item = self.deque.take()) { return item; }
+    }
+
+    const std::size_t count = workers_.size();
+    const std::size_t first = next_random() % count;
+    for (std::size_t i = 0; i != count; ++i) {
+      worker &victim = *workers_[(first + i) % count];
+      if (&victim == &self) { continue; }
+      if (const detail::work_item item = victim.deque.steal()) { return item; }
+      if (const detail::work_item item = steal_inbox(victim)) { return item; }
+    }
+    return {};
+  }
+
+  // Used by the destructor after the workers have exited
+  [[nodiscard]] detail::work_item find_any()
+  {
+    for (auto &wrk : workers_) {
+      if (const detail::work_item item = wrk->deque.steal()) { return item; }
+      const std::lock_guard lock{ wrk->inbox_mutex };
+      if (!wrk->inbox.empty()) {
+        const detail::work_item item = wrk->inbox.back();
+        wrk->inbox.pop_back();
+        return item;
+      }
+    }
+    return {};
+  }
+
+  // Returns false, if the pool is stopping and there is no work left
+  bool idle(worker &self)
+  {
+    const std::uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+
+    bool has_work = false;
+    for (auto &wrk : workers_) {
+      if (!wrk->deque.empty() || wrk->inbox_ready.load(std::memory_order_seq_cst)) {
+        has_work = true;
+        break;
+      }
+    }
+    if (!has_work && !drain_inbox(self)) {
+      if (stop_.load(std::memory_order_seq_cst)) {
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+      }
+      epoch_.wait(epoch, std::memory_order_seq_cst);
+    }
+
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void run(worker &self)
+  {
+    current = &self;
+
+    do {
+      while (const detail::work_item item = find_work(self)) {
+        if (stop_.load(std::memory_order_relaxed)) [[unlikely]] {
+          item.discard();
+        } else {
+          item.run();
+        }
+      }
+    } while (idle(self));
+
+    current = nullptr;
+  }
+
+  std::vector<std::unique_ptr<worker>> workers_;
+
+  alignas(64) std::atomic<std::uint32_t> epoch_{ 0 };
+  std::atomic<std::uint32_t> sleepers_{ 0 };
+  std::atomic<bool> stop_{ false };
+};
+
+RAII_NS_END
+
+#endif// RAII_THREAD_POOL_HPP
@@ -0,0 +1,298 @@
+// unique_array implementation -*- C++ -*-
+
+#ifndef RAII_UNIQUE_ARRAY_HPP
+#define RAII_UNIQUE_ARRAY_HPP
+
+#include "raii_defs.hpp"
+#include "relocate.hpp"
+#include "unique_rc.hpp"
+
+#include <cassert>
+#include <concepts>// std::swappable
+#include <cstddef>// std::size_t, std::nullptr_t
+#include <memory>// std::allocator, std::destroy_n, std::construct_at
+#include <span>
+#include <type_traits>
+
+
+RAII_NS_BEGIN
+
+/**
+ * @brief Destroys elements and deallocates an array allocated by std::allocator<T>. Since the element count is
+ * a part of the handle, memory is returned via sized deallocation, so the allocator doesn't need to look the block
+ * size up.
+ * @tparam T array element type
+ **/
+template<typename T> struct sized_array_delete
+{
+  struct handle
+  {
+    T *ptr;
+    std::size_t size;
+
+    // NOLINTNEXTLINE(bugprone-easily-swappable-parameters, cppcoreguidelines-pro-type-member-init, hicpp-member-init)
+    raii_inline constexpr handle(T *data, std::size_t count) noexcept : ptr{ data }, size{ count } {}
+
+    raii_inline constexpr handle() noexcept : handle(nullptr, 0) {}
+
+    constexpr handle(const handle &) noexcept = default;
+    constexpr handle(handle &&) noexcept = default;
+
+    constexpr handle &operator=(const handle &) noexcept = default;
+    constexpr handle &operator=(handle &&) noexcept = default;
+
+    constexpr ~handle() noexcept = default;
+
+    [[nodiscard]] friend raii_inline constexpr bool operator==(const handle &lhs, const handle &rhs) noexcept
+    { return (lhs.ptr == rhs.ptr) && (lhs.size == rhs.size); }
+
+    friend raii_inline constexpr void swap(handle &lhs, handle &rhs) noexcept
+    {
+      std::ranges::swap(lhs.ptr, rhs.ptr);
+      std::ranges::swap(lhs.size, rhs.size);
+    }
+  };// handle
+
+  constexpr sized_array_delete() noexcept = default;
+
+#ifdef __cpp_static_call_operator
+  // False poisitive, guarded by feature #ifdef __cpp_static_call_operator
+  // NOLINTNEXTLINE(clang-diagnostic-c++23-extensions)
+  raii_inline static constexpr void operator()(handle hnd) noexcept
+#else
+  raii_inline constexpr void operator()(handle hnd) const noexcept
+#endif
+  {
+    // cppcheck-suppress sizeofVoid;
+    // NOLINTNEXTLINE(bugprone-sizeof-expression)
+    static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type");
+
+    std::destroy_n(hnd.ptr, hnd.size);
+    // Ends up in sized ::operator delete(void*, std::size_t), or its align_val_t overload for over-aligned T
+    std::allocator<T>{}.deallocate(hnd.ptr, hnd.size);
+  }
+};// sized_array_delete
+
+template<typename Handle, typename Invalid = Handle> struct sized_array_invalid_handle_policy
+{
+  using invalid_type = Invalid;
+
+  [[nodiscard]] raii_inline static constexpr invalid_type invalid() noexcept { return {}; }
+
+  [[nodiscard]] raii_inline static constexpr bool is_owned(Handle hnd) noexcept { return hnd.ptr != nullptr; }
+
+  /// @brief Disabled because policy provides only typedefs and static methods
+  constexpr sized_array_invalid_handle_policy() = delete;
+  constexpr ~sized_array_invalid_handle_policy() = delete;
+
+  constexpr sized_array_invalid_handle_policy(const sized_array_invalid_handle_policy &) = delete;
+  constexpr sized_array_invalid_handle_policy &operator=(const sized_array_invalid_handle_policy &) = delete;
+
+  constexpr sized_array_invalid_handle_policy(sized_array_invalid_handle_policy &&) = delete;
+  constexpr sized_array_invalid_handle_policy &operator=(sized_array_invalid_handle_policy &&) = delete;
+};// sized_array_invalid_handle_policy
+
+
+/**
+ * @brief raii::unique_array owns dynamically-allocated array of objects together with its element count.
+ * Unlike raii::unique_ptr<T[]> it provides size(), iterators and std::span conversion, and frees memory with sized
+ * deallocation.
+ * @tparam T the type of array elements
+ * @tparam Deleter the function object, to be called from the destructor, handle type is Deleter::handle,
+ * which has `ptr` and `size` members
+ * @note Like raii::unique_ptr, constness is shallow: a const unique_array provides mutable access to the elements
+ **/
+template<typename T, class Deleter = sized_array_delete<T>>
+  requires(!std::is_array_v<T>)
+class unique_array
+  : public unique_rc<typename Deleter::handle,
+      Deleter,
+      resolve_handle_type,
+      typename Deleter::handle,
+      sized_array_invalid_handle_policy>
+{
+private:
+  using Base = unique_rc<typename Deleter::handle,
+    Deleter,
+    resolve_handle_type,
+    typename Deleter::handle,
+    sized_array_invalid_handle_policy>;
+
+public:
+  using typename Base::invalid_handle_policy;
+
+  /// @brief Deleter::handle, holds pointer to the first element and the element count
+  using typename Base::handle;
+
+  using typename Base::deleter_type;
+
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+  using iterator = T *;
+
+  using Base::invalid;
+
+  // cppcheck-suppress-begin [functionStatic, missingReturn, duplInheritedMember]
+  /// @brief Creates a unique_array that owns nothing
+  raii_inline constexpr unique_array() noexcept
+    requires not_pointer_and_is_default_constructable_v<Deleter>
+    : Base()
+  {}
+
+  /// @brief Creates a unique_array that owns nothing
+  /// @param std::nullptr_t
+  raii_inline constexpr explicit unique_array(std::nullptr_t) noexcept
+    requires not_pointer_and_is_default_constructable_v<Deleter>
+    : Base()
+  {}
+
+  /// @brief Takes ownership of hnd.size elements starting at hnd.ptr, which must be released by Deleter
+  raii_inline constexpr explicit unique_array(handle hnd) noexcept
+    requires not_pointer_and_is_default_constructable_v<Deleter>
+    : Base(hnd)
+  {}
+
+  raii_inline constexpr unique_array(handle hnd, const Deleter &del) noexcept
+    requires std::is_copy_constructible_v<Deleter>
+    : Base(hnd, del)
+  {}
+
+  raii_inline constexpr unique_array(handle hnd, Deleter &&del) noexcept
+    requires std::is_move_constructible_v<Deleter>
+    : Base(hnd, std::move(del))
+  {}
+  // cppcheck-suppress-end [functionStatic, missingReturn, duplInheritedMember]
+
+  constexpr unique_array(unique_array && /*src*/) noexcept = default;
+  constexpr unique_array &operator=(unique_array && /*rhs*/) noexcept = default;
+
+  raii_inline constexpr unique_array &operator=(std::nullptr_t) noexcept
+  {
+    reset();
+    return *this;
+  }
+
+  unique_array(const unique_array &) = delete;
+  unique_array &operator=(const unique_array &) = delete;
+
+  constexpr ~unique_array() noexcept = default;
+
+  using Base::get;
+  using Base::get_deleter;
+  using Base::operator bool;
+
+  using Base::release;
+  using Base::reset;
+
+  using Base::swap;
+
+  /// @brief deleted, single object version only
+  constexpr handle operator->() const noexcept = delete;
+
+  /// @brief Returns pointer to the first element, nullptr if nothing is owned
+  [[nodiscard]] raii_inline constexpr pointer data() const noexcept { return get().ptr; }
+
+  /// @brief Returns number of elements in the owned array, 0 if nothing is owned
+  [[nodiscard]] raii_inline constexpr size_type size() const noexcept { return get().size; }
+
+  [[nodiscard]] raii_inline constexpr bool empty() const noexcept { return size() == 0; }
+
+  [[nodiscard]] raii_inline constexpr iterator begin() const noexcept { return data(); }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  [[nodiscard]] raii_inline constexpr iterator end() const noexcept { return data() + size(); }
+
+  /// @brief Provides access to elements of the owned array
+  /// @param index the index of the element to be returned, shall be less than size()
+  /// @return lvalue reference the element at index, i.e. data()[index]
+  [[nodiscard]] raii_inline constexpr reference operator[](size_type index) const noexcept
+  {
+    assert(index < size() && "unique_array subscript out of range");
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return data()[index];
+  }
+
+  /// @brief Non-owning view over the elements
+  /// @note unique_array is a contiguous sized range, therefore it also converts to std::span implicitly
+  [[nodiscard]] raii_inline constexpr std::span<T> as_span() const noexcept { return { data(), size() }; }
+};// unique_array<T, Deleter>
+
+
+template<typename T, class D>
+[[nodiscard]] raii_inline constexpr bool operator==(const unique_array<T, D> &lhs, std::nullptr_t) noexcept
+{ return !lhs; }
+
+template<typename T, class D>
+  requires std::swappable<D>
+raii_inline constexpr void swap(unique_array<T, D> &lhs, unique_array<T, D> &rhs) noexcept(
+  noexcept(std::is_nothrow_swappable_v<D>))
+{ lhs.swap(rhs); }
+
+template<typename T, class D>
+  requires std::negation_v<std::is_swappable<D>>
+void swap(unique_array<T, D> &lhs, unique_array<T, D> &rhs) = delete;
+
+template<typename T, class D>
+struct is_trivially_relocatable<unique_array<T, D>>
+  : detail::owner_is_trivially_relocatable<typename unique_array<T, D>::handle, D>
+{
+};
+
+
+namespace detail {
+
+  // Allocates count elements and constructs each via init(ptr), all constructed elements are destroyed and memory
+  // is freed if construction throws
+  template<typename T, typename Init>
+  [[nodiscard]] raii_inline constexpr unique_array<T> make_unique_array_with(std::size_t count, Init init)
+  {
+    std::allocator<T> alloc;
+    T *const data = alloc.allocate(count);
+
+    std::size_t constructed = 0;
+    try {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      for (; constructed != count; ++constructed) { init(data + constructed); }
+    } catch (...) {
+      std::destroy_n(data, constructed);
+      alloc.deallocate(data, count);
+      throw;
+    }
+
+    return unique_array<T>{ typename unique_array<T>::handle{ data, count } };
+  }
+
+}// namespace detail
+
+
+/// @brief Creates unique_array of count value-initialised elements
+template<typename T>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline constexpr unique_array<T> make_unique_array(std::size_t count)
+{
+  return detail::make_unique_array_with<T>(count, [](T *ptr) { std::construct_at(ptr); });
+}
+
+/// @brief Creates unique_array of count elements, each copy-constructed from value
+template<typename T>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline constexpr unique_array<T> make_unique_array(std::size_t count, const T &value)
+{
+  return detail::make_unique_array_with<T>(count, [&value](T *ptr) { std::construct_at(ptr, value); });
+}
+
+/// @brief Creates unique_array of count default-initialised elements, trivial types are left uninitialised
+template<typename T>
+  requires(!std::is_array_v<T>)
+[[nodiscard]] raii_inline unique_array<T> make_unique_array_for_overwrite(std::size_t count)
+{
+  return detail::make_unique_array_with<T>(count, [](T *ptr) { ::new (static_cast<void *>(ptr)) T; });
+}
+
+RAII_NS_END
+
+#endif// RAII_UNIQUE_ARRAY_HPP
@@ -4,6 +4,7 @@
 #include "concepts.hpp"
 #include "coroutine_destroy.hpp"
 #include "raii_defs.hpp"
+#include "relocate.hpp"
 #include "unique_rc.hpp"
 
 #include <coroutine>
@@ -189,6 +190,12 @@ template<typename P, class D>
   requires std::negation_v<std::is_swappable<D>>
 void swap(unique_coroutine_handle<P, D> &lhs, unique_coroutine_handle<P, D> &rhs) = delete;
 
+template<typename P, class D>
+struct is_trivially_relocatable<unique_coroutine_handle<P, D>>
+  : detail::owner_is_trivially_relocatable<typename unique_coroutine_handle<P, D>::handle, D>
+{
+};
+
 RAII_NS_END
 
 
@@ -0,0 +1,285 @@
+// unique_mmap, owned memory mapped file views -*- C++ -*-
+
+#ifndef RAII_UNIQUE_MMAP_HPP
+#define RAII_UNIQUE_MMAP_HPP
+
+#include "deleter_posix.hpp"
+#include "raii_defs.hpp"
+#include "relocate.hpp"
+#include "unique_rc.hpp"
+
+#include <fcntl.h>// open, O_RDONLY, O_RDWR, O_CLOEXEC
+#include <sys/mman.h>// mmap, madvise, msync
+#include <sys/stat.h>// fstat
+#include <unistd.h>// sysconf
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>// std::size_t, std::byte, std::nullptr_t
+#include <cstdint>// std::uint8_t, std::uintptr_t
+#include <span>
+#include <system_error>
+#include <type_traits>
+
+
+RAII_NS_BEGIN
+
+/// @brief Protection and sharing of a file mapping
+enum class mmap_access : std::uint8_t {
+  read_only,///< PROT_READ, MAP_SHARED, writes to the view fault
+  read_write,///< PROT_READ | PROT_WRITE, MAP_SHARED, writes reach the file
+  copy_on_write///< PROT_READ | PROT_WRITE, MAP_PRIVATE, writes stay in the process
+};
+
+/// @brief Access pattern hints passed to madvise
+enum class mmap_advice : std::uint8_t {
+  normal,///< MADV_NORMAL, default read-ahead
+  sequential,///< MADV_SEQUENTIAL, aggressive read-ahead, pages behind the reader may be dropped early
+  random,///< MADV_RANDOM, read-ahead is disabled
+  willneed,///< MADV_WILLNEED, starts reading the range in the background
+  dontneed,///< MADV_DONTNEED, the range may be dropped, it is read from the file again on the next access
+  hugepage///< MADV_HUGEPAGE, back the range with transparent huge pages, where the kernel supports it
+};
+
+/// @brief Parameters of raii::map_file
+struct mmap_options
+{
+  /// @brief Length, which maps from offset to the end of the file
+  static constexpr std::size_t to_end = ~std::size_t{ 0 };
+
+  /// @brief Offset into the file, has to be a multiple of the page size
+  std::size_t offset = 0;
+
+  std::size_t length = to_end;
+
+  /// @brief Prefaults the page tables with MAP_POPULATE, mapping takes longer, but the first accesses don't fault
+  bool populate = false;
+};
+
+
+/**
+ * @brief raii::unique_mmap owns a view of a file mapped with mmap. The handle keeps the address and the length,
+ * so the deleter calls munmap(addr, len) and sizeof(unique_mmap) is the size of the two.
+ * @note Like raii::unique_array, constness is shallow, the view of a read-only mapping is std::span<std::byte>
+ * as well, writing to it raises SIGSEGV
+ * @code
+ * const raii::unique_mmap index = raii::map_file("index.bin", raii::mmap_access::read_only);
+ * index.advise(raii::mmap_advice::sequential);
+ * for (const entry &ent : index.as_span<const entry>()) { ... }
+ * @endcode
+ **/
+class unique_mmap
+  : public unique_rc<deleter::posix::unmap::handle,
+      deleter::posix::unmap,
+      resolve_handle_type,
+      deleter::posix::unmap::handle,
+      deleter::posix::invalid_mapping_policy>
+{
+private:
+  using Base = unique_rc<deleter::posix::unmap::handle,
+    deleter::posix::unmap,
+    resolve_handle_type,
+    deleter::posix::unmap::handle,
+    deleter::posix::invalid_mapping_policy>;
+
+public:
+  using typename Base::invalid_handle_policy;
+
+  /// @brief deleter::posix::unmap::handle, holds the address and the length of the mapping
+  using typename Base::handle;
+
+  using typename Base::deleter_type;
+
+  using size_type = std::size_t;
+
+  using Base::invalid;
+
+  // cppcheck-suppress-begin [functionStatic, missingReturn, duplInheritedMember]
+  /// @brief Creates a unique_mmap that owns nothing
+  raii_inline constexpr unique_mmap() noexcept : Base() {}
+
+  /// @brief Creates a unique_mmap that owns nothing
+  /// @param std::nullptr_t
+  raii_inline constexpr explicit unique_mmap(std::nullptr_t) noexcept : Base() {}
+
+  /// @brief Takes ownership of a mapping of hnd.len bytes at hnd.addr, returned by mmap
+  raii_inline constexpr explicit unique_mmap(handle hnd) noexcept : Base(hnd) {}
+  // cppcheck-suppress-end [functionStatic, missingReturn, duplInheritedMember]
+
+  constexpr unique_mmap(unique_mmap && /*src*/) noexcept = default;
+  constexpr unique_mmap &operator=(unique_mmap && /*rhs*/) noexcept = default;
+
+  raii_inline constexpr unique_mmap &operator=(std::nullptr_t) noexcept
+  {
+    reset();
+    return *this;
+  }
+
+  unique_mmap(const unique_mmap &) = delete;
+  unique_mmap &operator=(const unique_mmap &) = delete;
+
+  constexpr ~unique_mmap() noexcept = default;
+
+  using Base::get;
+  using Base::get_deleter;
+  using Base::operator bool;
+
+  using Base::release;
+  using Base::reset;
+
+  using Base::swap;
+
+  /// @brief deleted, mapping is not a pointer to a single object
+  constexpr handle operator->() const noexcept = delete;
+
+  /// @brief Returns the first byte of the view, nullptr if nothing is owned
+  [[nodiscard]] raii_inline std::byte *data() const noexcept { return static_cast<std::byte *>(get().addr); }
+
+  /// @brief Returns the length of the view in bytes, 0 if nothing is owned
+  [[nodiscard]] raii_inline constexpr size_type size() const noexcept { return get().len; }
+
+  [[nodiscard]] raii_inline constexpr bool empty() const noexcept { return size() == 0; }
+
+  /// @brief Non-owning view over the mapped bytes
+  [[nodiscard]] raii_inline std::span<std::byte> bytes() const noexcept { return { data(), size() }; }
+
+  /**
+   * @brief Non-owning view over the mapping as an array of T, a trailing partial element is not a part of the view
+   * @tparam T implicit-lifetime type, e.g. a trivially copyable struct, stored in the file in the host layout,
+   * add const for read-only mappings
+   * @note Mappings are page aligned, offset of T in the file has to keep alignof(T)
+   **/
+  template<typename T>
+    requires std::is_trivially_copyable_v<std::remove_cv_t<T>>
+  [[nodiscard]] raii_inline std::span<T> as_span() const noexcept
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    assert(reinterpret_cast<std::uintptr_t>(data()) % alignof(T) == 0 && "unique_mmap view is misaligned for T");
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return { reinterpret_cast<T *>(data()), size() / sizeof(T) };
+  }
+
+  /**
+   * @brief Tells the kernel how a part of the view is going to be accessed
+   * @param offset start of the range, rounded down to the page size
+   * @param length length of the range, the rest of the view by default
+   * @return false, if madvise refused the hint, e.g. MADV_HUGEPAGE is not supported for the file system, the view
+   * stays usable
+   **/
+  raii_inline bool advise(mmap_advice advice,
+    size_type offset = 0,
+    size_type length = mmap_options::to_end) const noexcept
+  {
+    if (offset >= size()) { return empty(); }
+    const size_type page_offset = offset - (offset % page_size());
+    const size_type end = (length >= size() - offset) ? size() : (offset + length);
+    const int native = native_advice(advice);
+    if (native < 0) { return false; }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return ::madvise(data() + page_offset, end - page_offset, native) == 0;
+  }
+
+  /**
+   * @brief Writes modified pages of a shared mapping back to the file, msync(2)
+   * @param wait blocks until the pages are written, with MS_SYNC, otherwise only schedules the writes
+   * @throw std::system_error, if msync fails
+   **/
+  raii_inline void flush(bool wait = true) const
+  {
+    if (empty()) { return; }
+    if (::msync(data(), size(), wait ? MS_SYNC : MS_ASYNC) != 0) {
+      throw std::system_error{ errno, std::system_category(), "msync" };
+    }
+  }
+
+  /// @brief Granularity of mapping offsets and of madvise ranges
+  [[nodiscard]] static size_type page_size() noexcept
+  {
+    static const auto size = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+    return size;
+  }
+
+private:
+  // Returns -1 for advice, which the platform does not define
+  [[nodiscard]] raii_inline static int native_advice(mmap_advice advice) noexcept
+  {
+    switch (advice) {
+    case mmap_advice::sequential:
+      return MADV_SEQUENTIAL;
+    case mmap_advice::random:
+      return MADV_RANDOM;
+    case mmap_advice::willneed:
+      return MADV_WILLNEED;
+    case mmap_advice::dontneed:
+      return MADV_DONTNEED;
+    case mmap_advice::hugepage:
+#ifdef MADV_HUGEPAGE
+      return MADV_HUGEPAGE;
+#else
+      return -1;
+#endif
+    case mmap_advice::normal:
+    default:
+      return MADV_NORMAL;
+    }
+  }
+};// unique_mmap
+
+
+[[nodiscard]] raii_inline constexpr bool operator==(const unique_mmap &lhs, std::nullptr_t) noexcept { return !lhs; }
+
+raii_inline void swap(unique_mmap &lhs, unique_mmap &rhs) noexcept { lhs.swap(rhs); }
+
+template<>
+struct is_trivially_relocatable<unique_mmap>
+  : detail::owner_is_trivially_relocatable<unique_mmap::handle, unique_mmap::deleter_type>
+{
+};
+
+
+/**
+ * @brief Maps a part of an open file, the mapping stays valid after the descriptor is closed
+ * @param fd descriptor opened for reading, and for writing with mmap_access::read_write
+ * @return unique_mmap owning nothing for an empty range, e.g. an empty file
+ * @throw std::system_error, if fstat or mmap fails, e.g. offset is not a multiple of the page size
+ **/
+[[nodiscard]] inline unique_mmap map_file(int fd, mmap_access access, const mmap_options &options = {})
+{
+  std::size_t length = options.length;
+  if (length == mmap_options::to_end) {
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) { throw std::system_error{ errno, std::system_category(), "fstat" }; }
+    const auto file_size = static_cast<std::size_t>(info.st_size);
+    length = (options.offset < file_size) ? (file_size - options.offset) : 0;
+  }
+  if (length == 0) { return unique_mmap{}; }
+
+  const int prot = (access == mmap_access::read_only) ? PROT_READ : (PROT_READ | PROT_WRITE);
+  int flags = (access == mmap_access::copy_on_write) ? MAP_PRIVATE : MAP_SHARED;
+#ifdef MAP_POPULATE
+  if (options.populate) { flags |= MAP_POPULATE; }
+#endif
+
+  void *const addr = ::mmap(nullptr, length, prot, flags, fd, static_cast<off_t>(options.offset));
+  if (addr == MAP_FAILED) { throw std::system_error{ errno, std::system_category(), "mmap" }; }
+  return unique_mmap{ { addr, length } };
+}
+
+[[nodiscard]] inline unique_mmap map_file(const unique_fd &file, mmap_access access, const mmap_options &options = {})
+{ return map_file(file.get(), access, options); }
+
+/**
+ * @brief Opens the file and maps it, the descriptor is closed before returning
+ * @throw std::system_error, if the file cannot be opened or mapped
+ **/
+[[nodiscard]] inline unique_mmap map_file(const char *path, mmap_access access, const mmap_options &options = {})
+{
+  const int open_flags = ((access == mmap_access::read_write) ? O_RDWR : O_RDONLY) | O_CLOEXEC;
+  const unique_fd file{ ::open(path, open_flags) };
+  if (!file) { throw std::system_error{ errno, std::system_category(), "open" }; }
+  return map_file(file.get(), access, options);
+}
+
+RAII_NS_END
+
+#endif// RAII_UNIQUE_MMAP_HPP
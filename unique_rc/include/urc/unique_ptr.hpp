@@ -5,6 +5,7 @@
 
 #include "concepts.hpp"
 #include "raii_defs.hpp"
+#include "relocate.hpp"
 #include "unique_rc.hpp"
 
 #include <cassert>
@@ -463,6 +464,13 @@ template<typename H, class D>
   requires std::negation_v<std::is_swappable<D>>
 void swap(unique_ptr<H, D> &lhs, unique_ptr<H, D> &rhs) = delete;
 
+// Covers both single object and array forms
+template<typename T, class D>
+struct is_trivially_relocatable<unique_ptr<T, D>>
+  : detail::owner_is_trivially_relocatable<typename unique_ptr<T, D>::pointer, D>
+{
+};
+
 
 // make_unique and make_unique_for_overwrite
 
@@ -4,7 +4,9 @@
 #define UNIQUE_RC_HPP
 
 #include "raii_defs.hpp"
+#include "compressed_pair.hpp"
 #include "concepts.hpp"
+#include "relocate.hpp"
 
 #include <cassert>
 #include <compare>// std::three_way_comparable_with
@@ -12,7 +14,6 @@
 #include <cstddef>// std::nullptr_t
 #include <functional>// std::hash
 #include <iosfwd>
-#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -89,6 +90,28 @@ template<typename Handle, typename Invalid> struct default_invalid_handle_policy
 };
 
 
+/**
+ * @brief Deleter capability, true when calling the deleter with the invalid handle is a safe no-op, e.g. `delete
+ * nullptr` or `free(nullptr)`. Then unique_rc invokes the deleter unconditionally instead of branching on
+ * invalid_handle_policy::is_owned() on destruction and reset.
+ * Deleter opts in by declaring `static constexpr bool accepts_invalid_handle = true;`
+ * @note the opt-in applies to the invalid value of the policy the deleter is used with, `nullptr` for pointer deleters
+ **/
+template<class Deleter> struct accepts_invalid_handle : std::false_type
+{
+};
+
+template<class Deleter>
+  requires requires {
+    { std::remove_reference_t<Deleter>::accepts_invalid_handle } -> std::convertible_to<bool>;
+  }
+struct accepts_invalid_handle<Deleter> : std::bool_constant<std::remove_reference_t<Deleter>::accepts_invalid_handle>
+{
+};
+
+template<class Deleter> inline constexpr bool accepts_invalid_handle_v = accepts_invalid_handle<Deleter>::value;
+
+
 // deleter requirements
 template<typename T>
 using not_pointer_and_is_default_constructable =
@@ -151,18 +174,24 @@ public:
 
   constexpr ~unique_rc_holder_impl() = default;
 
-  raii_inline constexpr handle &get_handle() noexcept { return std::get<0>(hdt_); }
+  raii_inline constexpr handle &get_handle() noexcept { return hdt_.first(); }
 
-  raii_inline constexpr const handle &get_handle() const noexcept { return std::get<0>(hdt_); }
+  raii_inline constexpr const handle &get_handle() const noexcept { return hdt_.first(); }
 
-  raii_inline constexpr Deleter &get_deleter() noexcept { return std::get<1>(hdt_); }
+  raii_inline constexpr Deleter &get_deleter() noexcept { return hdt_.second(); }
 
-  raii_inline constexpr const Deleter &get_deleter() const noexcept { return std::get<1>(hdt_); }
+  raii_inline constexpr const Deleter &get_deleter() const noexcept { return hdt_.second(); }
 
   raii_inline constexpr void reset(handle hnd) noexcept
   {
     const handle old_h = std::exchange(get_handle(), hnd);
-    if (invalid_handle_policy::is_owned(old_h)) {
+    if constexpr (accepts_invalid_handle_v<Deleter>) {
+#ifndef RAII_URC_DISABLE_SELF_RESET_CHECK
+      assert((!invalid_handle_policy::is_owned(old_h) || old_h != hnd)
+             && "Failed self-reset check, like r.reset(r.get())");
+#endif
+      get_deleter()(old_h);
+    } else if (invalid_handle_policy::is_owned(old_h)) {
 #ifndef RAII_URC_DISABLE_SELF_RESET_CHECK
       assert(old_h != hnd && "Failed self-reset check, like r.reset(r.get())");
 #endif
@@ -187,7 +216,8 @@ public:
   }
 
 private:
-  std::tuple<handle, Deleter> hdt_;
+  // Unlike std::tuple, guarantees that a stateless deleter adds nothing to the size of the handle
+  detail::compressed_pair<handle, Deleter> hdt_;
 };
 
 
@@ -418,12 +448,16 @@ public:
   /// @brief If invalid_handle_policy::is_owned(h) is false there are no effects.
   /// Otherwise, the owned object is destroyed via get_deleter()(h).
   /// Requires that get_deleter()(h) does not throw exceptions.
+  /// @note If accepts_invalid_handle_v<Deleter> is true, get_deleter()(h) is invoked without checking ownership
   raii_inline constexpr ~unique_rc() noexcept
   {
     static_assert(std::is_invocable_v<deleter_type &, handle>, "unique_rc's deleter must be invocable with a handle");
 
     auto &hnd = uh_.get_handle();
-    if (invalid_handle_policy::is_owned(hnd)) {
+    if constexpr (accepts_invalid_handle_v<deleter_type>) {
+      get_deleter()(std::move(hnd));
+      hnd = invalid();
+    } else if (invalid_handle_policy::is_owned(hnd)) {
       get_deleter()(std::move(hnd));
       hnd = invalid();
     }
@@ -642,6 +676,19 @@ std::basic_ostream<Elem, Traits> &
 }
 
 
+/// @brief unique_rc may be relocated with memcpy when both its handle and deleter can, since relocation neither runs
+/// the move constructor, which resets the source, nor the source's destructor
+template<typename H,
+  class D,
+  template<typename, typename> class TR,
+  typename IH,
+  template<typename, typename> class IHPolicy>
+struct is_trivially_relocatable<unique_rc<H, D, TR, IH, IHPolicy>>
+  : detail::owner_is_trivially_relocatable<typename unique_rc<H, D, TR, IH, IHPolicy>::handle, D>
+{
+};
+
+
 RAII_NS_END
 
 
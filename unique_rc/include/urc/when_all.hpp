@@ -0,0 +1,308 @@
+// Awaiting several tasks at once, when_all and when_any -*- C++ -*-
+
+#ifndef RAII_WHEN_ALL_HPP
+#define RAII_WHEN_ALL_HPP
+
+#include "raii_defs.hpp"
+#include "task.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>// std::size_t
+#include <functional>// std::reference_wrapper
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>// std::move, std::forward, std::index_sequence
+#include <variant>
+
+
+RAII_NS_BEGIN
+
+/// @brief Result of when_any over a range of tasks
+template<typename T> struct when_any_result
+{
+  /// @brief Position of the task, which completed first
+  std::size_t index;
+  T value;
+};
+
+namespace detail {
+
+  // Result of a task stored in a tuple or a variant
+  template<typename T>
+  using task_value_t = std::conditional_t<std::is_void_v<T>,
+    std::monostate,
+    std::conditional_t<std::is_reference_v<T>, std::reference_wrapper<std::remove_reference_t<T>>, T>>;
+
+  template<typename T> task_value_t<T> take_result(task<T> &child)
+  {
+    auto &promise = child.get().promise();
+    if constexpr (std::is_void_v<T>) {
+      promise.get();
+      return {};
+    } else if constexpr (std::is_reference_v<T>) {
+      return std::ref(promise.get());
+    } else {
+      return std::move(promise).get();
+    }
+  }
+
+  template<typename> inline constexpr bool is_task_v = false;
+  template<typename T> inline constexpr bool is_task_v<task<T>> = true;
+
+  template<typename Range>
+  concept task_range = std::ranges::forward_range<Range> && is_task_v<std::ranges::range_value_t<Range>>;
+
+  // Children passed as arguments, kept in the awaitable
+  template<typename... Ts> class task_tuple
+  {
+  public:
+    explicit task_tuple(task<Ts>... children) noexcept : children_{ std::move(children)... } {}
+
+    [[nodiscard]] static constexpr bool empty() noexcept { return sizeof...(Ts) == 0; }
+
+    // Calls fn(child) for every child in order, until it returns false
+    template<typename Fn> void for_each(Fn fn)
+    {
+      std::apply([&fn](auto &...child) { static_cast<void>((fn(child) && ...)); }, children_);
+    }
+
+    [[nodiscard]] std::tuple<task_value_t<Ts>...> all_results()
+    {
+      // Braced initialisation evaluates left to right, the first exception is rethrown
+      return std::apply([](auto &...child) { return std::tuple<task_value_t<Ts>...>{ take_result(child)... }; },
+        children_);
+    }
+
+    [[nodiscard]] std::variant<task_value_t<Ts>...> result_at(std::size_t index)
+    { return result_at(index, std::index_sequence_for<Ts...>{}); }
+
+  private:
+    template<std::size_t... Is>
+    [[nodiscard]] std::variant<task_value_t<Ts>...> result_at(std::size_t index, std::index_sequence<Is...> /*seq*/)
+    {
+      using result_type = std::variant<task_value_t<Ts>...>;
+      using fn_type = result_type (*)(std::tuple<task<Ts>...> &);
+      static constexpr std::array<fn_type, sizeof...(Ts)> fns{ [](std::tuple<task<Ts>...> &children) {
+        return result_type{ std::in_place_index<Is>, take_result(std::get<Is>(children)) };
+      }... };
+      return fns[index](children_);// NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    std::tuple<task<Ts>...> children_;
+  };
+
+  // Children in a range, which is kept in the awaitable, if it was passed as an rvalue, or referenced otherwise
+  template<typename Range> class task_range_ref
+  {
+  public:
+    using task_type = std::ranges::range_value_t<Range>;
+    using result_type = std::conditional_t<std::is_lvalue_reference_v<Range>, Range, std::remove_cvref_t<Range>>;
+
+    explicit task_range_ref(Range &&children) noexcept(std::is_lvalue_reference_v<Range>)
+      : children_{ std::forward<Range>(children) }
+    {}
+
+    [[nodiscard]] bool empty() const { return std::ranges::empty(children_); }
+
+    template<typename Fn> void for_each(Fn fn)
+    {
+      for (auto &child : children_) {
+        if (!fn(child)) { break; }
+      }
+    }
+
+    [[nodiscard]] result_type all_results()
+    {
+      if constexpr (std::is_lvalue_reference_v<Range>) {
+        return children_;
+      } else {
+        return std::move(children_);
+      }
+    }
+
+    [[nodiscard]] auto result_at(std::size_t index)
+    {
+      auto iter = std::ranges::begin(children_);
+      std::ranges::advance(iter, static_cast<std::ranges::range_difference_t<Range>>(index));
+      return when_any_result<task_value_t<typename task_type::value_type>>{ index, take_result(*iter) };
+    }
+
+  private:
+    result_type children_;
+  };
+
+  /**
+   * @brief Starts the children of a when_all or when_any awaitable and counts references to the group.
+   *
+   * Every started child holds a reference until it has completed or the group has detached it, the awaiting
+   * coroutine holds one, while it starts the children. Whoever drops the last reference resumes the awaiting
+   * coroutine. The highest bit of the same counter elects the first child to complete for when_any.
+   **/
+  template<typename Children> class task_group_awaitable : public task_group
+  {
+  public:
+    explicit task_group_awaitable(Children &&children) : children_{ std::move(children) } {}
+
+    task_group_awaitable(const task_group_awaitable &) = delete;
+    task_group_awaitable &operator=(const task_group_awaitable &) = delete;
+    task_group_awaitable(task_group_awaitable &&) = delete;
+    task_group_awaitable &operator=(task_group_awaitable &&) = delete;
+
+    [[nodiscard]] bool await_ready() const { return children_.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> parent) noexcept
+    {
+      parent_ = parent;
+      std::size_t index = 0;
+      children_.for_each([this, &index](auto &child) {
+        const auto hnd = child.get();
+        assert(hnd && !hnd.done() && "awaiting an empty or finished task");
+        task_group_link &link = hnd.promise().group_link();
+        link.join(*this, index++);
+
+        count_.fetch_add(1, std::memory_order_relaxed);
+        if (!link.start()) {
+          // when_any has a winner already, the rest is destroyed together with the awaitable
+          count_.fetch_sub(1, std::memory_order_relaxed);
+          return false;
+        }
+        hnd.resume();
+        return true;
+      });
+      return !release();
+    }
+
+  protected:
+    static constexpr std::size_t elected_bit = std::size_t{ 1 } << (std::numeric_limits<std::size_t>::digits - 1);
+
+    ~task_group_awaitable() = default;
+
+    // Returns true, if the caller has dropped the last reference
+    bool release() noexcept { return (count_.fetch_sub(1, std::memory_order_acq_rel) & ~elected_bit) == 1; }
+
+    [[nodiscard]] std::coroutine_handle<> resume_parent_if_last() noexcept
+    {
+      if (release()) { return parent_; }
+      return std::noop_coroutine();
+    }
+
+    Children children_;
+    std::atomic<std::size_t> count_{ 1 };
+    std::coroutine_handle<> parent_;
+  };
+
+  template<typename Children> class when_all_awaitable final : public task_group_awaitable<Children>
+  {
+  public:
+    using task_group_awaitable<Children>::task_group_awaitable;
+
+    ~when_all_awaitable() = default;
+
+    [[nodiscard]] decltype(auto) await_resume() { return this->children_.all_results(); }
+
+    [[nodiscard]] std::coroutine_handle<> child_done(std::size_t /*index*/) noexcept override
+    { return this->resume_parent_if_last(); }
+  };
+
+  template<typename Children> class when_any_awaitable final : public task_group_awaitable<Children>
+  {
+    using base = task_group_awaitable<Children>;
+
+  public:
+    using base::base;
+
+    ~when_any_awaitable() = default;
+
+    [[nodiscard]] decltype(auto) await_resume()
+    {
+      assert(winner_ != no_winner && "when_any needs at least one task");
+      return this->children_.result_at(winner_);
+    }
+
+    [[nodiscard]] std::coroutine_handle<> child_done(std::size_t index) noexcept override
+    {
+      if ((this->count_.fetch_or(base::elected_bit, std::memory_order_acq_rel) & base::elected_bit) == 0) {
+        winner_ = index;
+        detach_others(index);
+      }
+      return this->resume_parent_if_last();
+    }
+
+  private:
+    static constexpr std::size_t no_winner = std::numeric_limits<std::size_t>::max();
+
+    // Children not started yet and finished ones stay with the awaitable, running ones destroy themselves
+    void detach_others(std::size_t winner) noexcept
+    {
+      std::size_t index = 0;
+      this->children_.for_each([this, winner, &index](auto &child) {
+        if (index++ == winner) { return true; }
+        if (child.get().promise().group_link().detach() == task_group_link::running) {
+          static_cast<void>(std::move(child).release().release());
+          this->count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return true;
+      });
+    }
+
+    std::size_t winner_{ no_winner };
+  };
+
+}// namespace detail
+
+
+/**
+ * @brief Awaitable, which starts all tasks at once and resumes the awaiting coroutine, when the last one completes.
+ *
+ * The awaitable owns the tasks and lives in the frame of the awaiting coroutine, nothing is allocated beyond the
+ * frames of the tasks themselves. Tasks are started one after another on the awaiting thread, each runs until its
+ * first suspension point, e.g. `co_await pool.schedule()`.
+ * @return std::tuple of the results, std::monostate for tasks of void and std::reference_wrapper for references
+ * @throw the first exception in the order of the arguments, after all tasks have completed
+ * @code
+ * auto [user, orders] = co_await raii::when_all(fetch_user(id), fetch_orders(id));
+ * @endcode
+ **/
+template<typename... Ts> [[nodiscard]] raii_inline auto when_all(task<Ts>... tasks)
+{ return detail::when_all_awaitable<detail::task_tuple<Ts...>>{ detail::task_tuple<Ts...>{ std::move(tasks)... } }; }
+
+/**
+ * @brief Awaitable, which starts a range of tasks at once and resumes the awaiting coroutine, when the last one
+ * completes.
+ * @return the range of completed tasks, moved from the awaitable, if it was passed as an rvalue. Awaiting a completed
+ * task returns its result or rethrows its exception without suspending.
+ **/
+template<detail::task_range Range> [[nodiscard]] raii_inline auto when_all(Range &&tasks)
+{
+  using children = detail::task_range_ref<Range>;
+  return detail::when_all_awaitable<children>{ children{ std::forward<Range>(tasks) } };
+}
+
+/**
+ * @brief Awaitable, which starts all tasks at once and resumes the awaiting coroutine, when the first one completes.
+ *
+ * The losing tasks are destroyed without running, if they have not been started yet, and destroy their own frames,
+ * as soon as they complete, if they are running. There is no cancellation, a losing task runs to completion.
+ * @return std::variant, whose index is the position of the first task to complete
+ * @throw the exception of the first task to complete
+ **/
+template<typename... Ts>
+  requires(sizeof...(Ts) > 0)
+[[nodiscard]] raii_inline auto when_any(task<Ts>... tasks)
+{ return detail::when_any_awaitable<detail::task_tuple<Ts...>>{ detail::task_tuple<Ts...>{ std::move(tasks)... } }; }
+
+/// @brief Awaitable like when_any(tasks...) for a non-empty range of tasks, returns raii::when_any_result
+template<detail::task_range Range> [[nodiscard]] raii_inline auto when_any(Range &&tasks)
+{
+  using children = detail::task_range_ref<Range>;
+  return detail::when_any_awaitable<children>{ children{ std::forward<Range>(tasks) } };
+}
+
+RAII_NS_END
+
+#endif// RAII_WHEN_ALL_HPP